@@ -0,0 +1,255 @@
+/*
+	Adpcm.cpp
+
+	This file contains the implementation for the IMA ADPCM functions prototyped in Adpcm.h.
+	Decoding is driven by two precomputed tables indexed by step index and nibble, so each sample costs
+	two table reads, an add and a clamp with no data-dependent branches.
+*/
+
+#include <string.h>
+#include "Adpcm.h"
+
+static const int stepTable[89] =
+{
+	7, 8, 9, 10, 11, 12, 13, 14, 16, 17,
+	19, 21, 23, 25, 28, 31, 34, 37, 41, 45,
+	50, 55, 60, 66, 73, 80, 88, 97, 107, 118,
+	130, 143, 157, 173, 190, 209, 230, 253, 279, 307,
+	337, 371, 408, 449, 494, 544, 598, 658, 724, 796,
+	876, 963, 1060, 1166, 1282, 1411, 1552, 1707, 1878, 2066,
+	2272, 2499, 2749, 3024, 3327, 3660, 4026, 4428, 4871, 5358,
+	5894, 6484, 7132, 7845, 8630, 9493, 10442, 11487, 12635, 13899,
+	15289, 16818, 18500, 20350, 22385, 24623, 27086, 29794, 32767
+};
+
+static const int indexTable[16] =
+{
+	-1, -1, -1, -1, 2, 4, 6, 8,
+	-1, -1, -1, -1, 2, 4, 6, 8
+};
+
+/*
+	Difference and next step index for every step index and nibble, built once at static initialization.
+*/
+class AdpcmTablesC
+{
+public:
+	AdpcmTablesC()
+	{
+		for (int index = 0; index < 89; index++)
+		{
+			int step = stepTable[index];
+
+			for (int nibble = 0; nibble < 16; nibble++)
+			{
+				int difference = step >> 3;
+
+				if (nibble & 4)
+					difference += step;
+				if (nibble & 2)
+					difference += step >> 1;
+				if (nibble & 1)
+					difference += step >> 2;
+				if (nibble & 8)
+					difference = -difference;
+
+				int nextIndex = index + indexTable[nibble];
+
+				if (nextIndex < 0)
+					nextIndex = 0;
+				if (nextIndex > 88)
+					nextIndex = 88;
+
+				mDifference[index * 16 + nibble] = difference;
+				mNextIndex[index * 16 + nibble] = (unsigned char)nextIndex;
+			}
+		}
+	}
+
+	int mDifference[89 * 16];
+	unsigned char mNextIndex[89 * 16];
+};
+
+static AdpcmTablesC sTables;
+
+static inline int clampSample(int sample)
+{
+	sample = sample < -32768 ? -32768 : sample;
+	return sample > 32767 ? 32767 : sample;
+}
+
+/*
+	Chooses the nibble that brings the predictor closest to the sample and applies it exactly as the decoder will.
+*/
+static inline int encodeSample(int sample, int *predictor, int *index)
+{
+	int step = stepTable[*index];
+	int difference = sample - *predictor;
+	int nibble = 0;
+
+	if (difference < 0)
+	{
+		nibble = 8;
+		difference = -difference;
+	}
+
+	if (difference >= step)
+	{
+		nibble |= 4;
+		difference -= step;
+	}
+
+	step >>= 1;
+
+	if (difference >= step)
+	{
+		nibble |= 2;
+		difference -= step;
+	}
+
+	step >>= 1;
+
+	if (difference >= step)
+		nibble |= 1;
+
+	int entry = *index * 16 + nibble;
+
+	*predictor = clampSample(*predictor + sTables.mDifference[entry]);
+	*index = sTables.mNextIndex[entry];
+
+	return nibble;
+}
+
+/*
+	Encodes the samples of one channel into a single block, padding the block with silence past the last sample.
+	The step index carries over from the previous block of the channel to avoid a fresh attack at every block start.
+*/
+static void encodeBlock(const short *samples, int count, int stride, int *index, unsigned char *block)
+{
+	int predictor = count > 0 ? samples[0] : 0;
+
+	memset(block, 0, ADPCM_BLOCK_BYTES);
+
+	block[0] = (unsigned char)(predictor & 0xFF);
+	block[1] = (unsigned char)((predictor >> 8) & 0xFF);
+	block[2] = (unsigned char)*index;
+
+	for (int i = 1; i < ADPCM_SAMPLES_PER_BLOCK; i++)
+	{
+		int sample = i < count ? samples[i * stride] : predictor;
+		int nibble = encodeSample(sample, &predictor, index);
+		int position = ADPCM_BLOCK_HEADER_BYTES + ((i - 1) >> 1);
+
+		if ((i - 1) & 1)
+			block[position] |= (unsigned char)(nibble << 4);
+		else
+			block[position] |= (unsigned char)nibble;
+	}
+}
+
+/* Public functions */
+int getAdpcmBlockCount(int frames)
+{
+	return (frames + ADPCM_SAMPLES_PER_BLOCK - 1) / ADPCM_SAMPLES_PER_BLOCK;
+}
+
+int getAdpcmEncodedBytes(int frames, int channels)
+{
+	return getAdpcmBlockCount(frames) * channels * ADPCM_BLOCK_BYTES;
+}
+
+/*
+	Encodes interleaved samples into blocks, returning the number of bytes written to output.
+	Output must hold getAdpcmEncodedBytes(frames, channels) bytes.
+*/
+int encodeAdpcm(const short *samples, int frames, int channels, unsigned char *output)
+{
+	int blocks = getAdpcmBlockCount(frames);
+	int indices[8] = { 0 };
+
+	for (int block = 0; block < blocks; block++)
+	{
+		int firstFrame = block * ADPCM_SAMPLES_PER_BLOCK;
+		int count = frames - firstFrame;
+
+		if (count > ADPCM_SAMPLES_PER_BLOCK)
+			count = ADPCM_SAMPLES_PER_BLOCK;
+
+		for (int channel = 0; channel < channels; channel++)
+		{
+			encodeBlock(samples + firstFrame * channels + channel, count, channels, &indices[channel & 7], output);
+			output += ADPCM_BLOCK_BYTES;
+		}
+	}
+
+	return blocks * channels * ADPCM_BLOCK_BYTES;
+}
+
+/*
+	Decodes a whole clip into interleaved samples. Output must hold frames * channels samples.
+*/
+void decodeAdpcm(const unsigned char *data, int frames, int channels, short *output)
+{
+	int blocks = getAdpcmBlockCount(frames);
+
+	for (int block = 0; block < blocks; block++)
+	{
+		int firstFrame = block * ADPCM_SAMPLES_PER_BLOCK;
+		int count = frames - firstFrame;
+
+		if (count > ADPCM_SAMPLES_PER_BLOCK)
+			count = ADPCM_SAMPLES_PER_BLOCK;
+
+		for (int channel = 0; channel < channels; channel++)
+		{
+			decodeAdpcmBlock(data, count, output + firstFrame * channels + channel, channels);
+			data += ADPCM_BLOCK_BYTES;
+		}
+	}
+}
+
+/*
+	Decodes the first samples of one block, writing every sample stride shorts apart.
+	Two nibbles are decoded per byte read.
+*/
+void decodeAdpcmBlock(const unsigned char *block, int samples, short *output, int stride)
+{
+	if (samples <= 0)
+		return;
+
+	const int *difference = sTables.mDifference;
+	const unsigned char *nextIndex = sTables.mNextIndex;
+	const unsigned char *nibbles = block + ADPCM_BLOCK_HEADER_BYTES;
+
+	int predictor = (short)(block[0] | (block[1] << 8));
+	int index = block[2] > 88 ? 88 : block[2];
+	int pairs = (samples - 1) >> 1;
+
+	output[0] = (short)predictor;
+	output += stride;
+
+	for (int i = 0; i < pairs; i++)
+	{
+		int byte = nibbles[i];
+		int entry = index * 16 + (byte & 0x0F);
+
+		predictor = clampSample(predictor + difference[entry]);
+		index = nextIndex[entry];
+		output[0] = (short)predictor;
+
+		entry = index * 16 + (byte >> 4);
+
+		predictor = clampSample(predictor + difference[entry]);
+		index = nextIndex[entry];
+		output[stride] = (short)predictor;
+
+		output += stride * 2;
+	}
+
+	if ((samples - 1) & 1)
+	{
+		int entry = index * 16 + (nibbles[pairs] & 0x0F);
+
+		output[0] = (short)clampSample(predictor + difference[entry]);
+	}
+}
\ No newline at end of file
@@ -0,0 +1,20 @@
+#pragma once
+/*
+	Adpcm.h
+
+	IMA ADPCM encoding and decoding of 16-bit samples at four bits per sample.
+	Samples are stored in fixed-size blocks that each begin with the predictor and step index,
+	so every block can be decoded on its own without the blocks before it.
+	Multi-channel data stores one block per channel for each group of frames.
+*/
+
+#define ADPCM_BLOCK_BYTES 256
+#define ADPCM_BLOCK_HEADER_BYTES 4
+#define ADPCM_SAMPLES_PER_BLOCK (1 + (ADPCM_BLOCK_BYTES - ADPCM_BLOCK_HEADER_BYTES) * 2)
+
+int getAdpcmBlockCount(int frames);
+int getAdpcmEncodedBytes(int frames, int channels);
+
+int encodeAdpcm(const short *samples, int frames, int channels, unsigned char *output);
+void decodeAdpcm(const unsigned char *data, int frames, int channels, short *output);
+void decodeAdpcmBlock(const unsigned char *block, int samples, short *output, int stride);
\ No newline at end of file
@@ -0,0 +1,162 @@
+/*
+	AssetPackage.cpp
+
+	This file contains the implementation for functions prototyped in the AssetPackage.h singleton class: AssetPackageC.
+*/
+
+#include "AssetPackage.h"
+
+AssetPackageC* AssetPackageC::sInstance = NULL;
+
+/*
+	Asset ids are the same case-insensitive hash the audio bank uses for its clip names.
+*/
+AssetId getAssetId(const char *name)
+{
+	return hashAssetName(name);
+}
+
+/* Public functions */
+AssetPackageC* AssetPackageC::CreateInstance()
+{
+	if (sInstance == NULL)
+		sInstance = new AssetPackageC();
+
+	return sInstance;
+}
+
+/*
+	Maps the package read-only. Pages are only read from disk when an asset is first touched.
+	Returns false, leaving every lookup empty, if the package is missing or invalid.
+*/
+bool AssetPackageC::init()
+{
+	mFile = INVALID_HANDLE_VALUE;
+	mMapping = NULL;
+	mView = NULL;
+	mSize = 0;
+	mAssetCount = 0;
+	mEntries = NULL;
+
+	mFile = CreateFile(packagePath, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_RANDOM_ACCESS, NULL);
+
+	if (mFile == INVALID_HANDLE_VALUE)
+		return false;
+
+	mSize = (int)GetFileSize(mFile, NULL);
+	mMapping = CreateFileMapping(mFile, NULL, PAGE_READONLY, 0, 0, NULL);
+
+	if (mMapping != NULL)
+		mView = (const unsigned char *)MapViewOfFile(mMapping, FILE_MAP_READ, 0, 0, 0);
+
+	if (mView == NULL || !validate())
+	{
+		shutdown();
+		return false;
+	}
+
+	return true;
+}
+
+void AssetPackageC::shutdown()
+{
+	if (mView != NULL)
+		UnmapViewOfFile(mView);
+
+	if (mMapping != NULL)
+		CloseHandle(mMapping);
+
+	if (mFile != INVALID_HANDLE_VALUE)
+		CloseHandle(mFile);
+
+	mFile = INVALID_HANDLE_VALUE;
+	mMapping = NULL;
+	mView = NULL;
+	mSize = 0;
+	mAssetCount = 0;
+	mEntries = NULL;
+}
+
+bool AssetPackageC::isLoaded()
+{
+	return mView != NULL;
+}
+
+/*
+	Returns the entry of the asset with the given id and name, or NULL if the package does not contain it.
+*/
+const AssetEntry* AssetPackageC::findAsset(AssetId id, const char *name)
+{
+	int low = 0;
+	int high = mAssetCount - 1;
+
+	while (low <= high)
+	{
+		int middle = (low + high) / 2;
+
+		if (mEntries[middle].nameHash < id)
+			low = middle + 1;
+		else
+			high = middle - 1;
+	}
+
+	for (int i = low; i < mAssetCount && mEntries[i].nameHash == id; i++)
+	{
+		if (assetNamesMatch(mEntries[i].name, name))
+			return &mEntries[i];
+	}
+
+	return NULL;
+}
+
+/*
+	Returns a pointer into the mapping at the payload of the named asset and its size, or NULL if it is not packaged.
+*/
+const unsigned char* AssetPackageC::getAssetData(const char *name, int *size)
+{
+	const AssetEntry *entry = mView != NULL ? findAsset(getAssetId(name), name) : NULL;
+
+	if (entry == NULL)
+		return NULL;
+
+	*size = entry->size;
+
+	return mView + entry->offset;
+}
+
+int AssetPackageC::getAssetCount()
+{
+	return mAssetCount;
+}
+
+int AssetPackageC::getMappedBytes()
+{
+	return mSize;
+}
+
+/* Private functions */
+/*
+	Checks the header and that the directory and every payload lie inside the file.
+*/
+bool AssetPackageC::validate()
+{
+	if (mSize < (int)sizeof(AssetPackageHeader))
+		return false;
+
+	const AssetPackageHeader *header = (const AssetPackageHeader *)mView;
+
+	if (header->magic != ASSET_PACKAGE_MAGIC || header->version != ASSET_PACKAGE_VERSION ||
+		header->directoryOffset + (unsigned long long)header->assetCount * sizeof(AssetEntry) > (unsigned int)mSize)
+		return false;
+
+	mAssetCount = header->assetCount;
+	mEntries = (const AssetEntry *)(mView + header->directoryOffset);
+
+	for (int i = 0; i < mAssetCount; i++)
+	{
+		if (mEntries[i].offset + (unsigned long long)mEntries[i].size > (unsigned int)mSize)
+			return false;
+	}
+
+	return true;
+}
\ No newline at end of file
@@ -0,0 +1,92 @@
+#pragma once
+/*
+	AssetPackage.h
+
+	This is a singleton class that maps the asset package written by the AssetBuilder tool into memory.
+	The package holds every screen, sprite sheet, the audio bank and the streamed music in a single file,
+	so start up opens one file instead of dozens and the assets are read straight out of the mapping.
+	Assets are identified by the hash of the relative path that would be used to open the loose file, e.g. "Screens/TitleScreen.png".
+	When no package was built, callers fall back to the loose files.
+*/
+
+#include <windows.h>
+#include "AudioBank.h"
+
+#define ASSET_PACKAGE_MAGIC 0x4B41504B
+#define ASSET_PACKAGE_VERSION 1
+#define ASSET_PACKAGE_ALIGNMENT 4096
+#define ASSET_NAME_LENGTH 64
+
+/*
+	Enumeration used to represent how the payload of an asset is stored.
+*/
+namespace AssetType
+{
+	enum AssetType { Raw, Texture, Wave, AudioBank, SpriteAtlas, MaxType };
+}
+
+struct AssetPackageHeader
+{
+	unsigned int magic;
+	unsigned int version;
+	unsigned int assetCount;
+	unsigned int directoryOffset;
+};
+
+/*
+	Directory entries are sorted by name hash. Every payload starts on an ASSET_PACKAGE_ALIGNMENT boundary,
+	so it is page aligned in the mapping and can be used in place.
+*/
+struct AssetEntry
+{
+	unsigned int nameHash;
+	char name[ASSET_NAME_LENGTH];
+	unsigned int type;
+	unsigned int offset;
+	unsigned int size;
+};
+
+typedef unsigned int AssetId;
+
+AssetId getAssetId(const char *name);
+
+class AssetPackageC
+{
+public:
+	/* Public functions */
+	static AssetPackageC *CreateInstance();
+	static AssetPackageC *GetInstance() { return sInstance; };
+	~AssetPackageC() {};
+
+	bool init();
+	void shutdown();
+	bool isLoaded();
+
+	const AssetEntry *findAsset(AssetId id, const char *name);
+	const unsigned char *getAssetData(const char *name, int *size);
+
+	int getAssetCount();
+	int getMappedBytes();
+
+private:
+	/* Private functions */
+	AssetPackageC() {};
+
+	bool validate();
+
+	/* Private data members */
+	static AssetPackageC *sInstance;
+
+	HANDLE mFile;
+	HANDLE mMapping;
+
+	const unsigned char *mView;
+
+	int mSize;
+	int mAssetCount;
+
+	const AssetEntry *mEntries;
+
+	/* Private constant data */
+	const char *packagePath = "Assets.pak";
+};
\ No newline at end of file
@@ -0,0 +1,254 @@
+/*
+	AudioBank.cpp
+
+	This file contains the implementation for functions prototyped in the AudioBankC class.
+*/
+
+#define _CRT_SECURE_NO_WARNINGS
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include "AudioBank.h"
+#include "Adpcm.h"
+
+/*
+	FNV-1a hash of an asset path, ignoring case and treating both slash directions alike.
+*/
+unsigned int hashAssetName(const char *name)
+{
+	unsigned int hash = 2166136261u;
+
+	for (; *name; name++)
+	{
+		char c = *name == '\\' ? '/' : (char)tolower((unsigned char)*name);
+
+		hash ^= (unsigned char)c;
+		hash *= 16777619u;
+	}
+
+	return hash;
+}
+
+/*
+	Compares two asset paths the way hashAssetName hashes them.
+*/
+bool assetNamesMatch(const char *a, const char *b)
+{
+	for (; *a && *b; a++, b++)
+	{
+		char ca = *a == '\\' ? '/' : (char)tolower((unsigned char)*a);
+		char cb = *b == '\\' ? '/' : (char)tolower((unsigned char)*b);
+
+		if (ca != cb)
+			return false;
+	}
+
+	return *a == *b;
+}
+
+/* Public functions */
+AudioBankC::AudioBankC()
+{
+	mOwnsData = false;
+	mData = NULL;
+	mSize = 0;
+	mClipCount = 0;
+	mEntries = NULL;
+}
+
+AudioBankC::~AudioBankC()
+{
+	unload();
+}
+
+/*
+	Reads the whole bank into memory with a single read and validates its directory.
+*/
+bool AudioBankC::load(const char *path)
+{
+	unload();
+
+	FILE *file = fopen(path, "rb");
+
+	if (file == NULL)
+		return false;
+
+	fseek(file, 0, SEEK_END);
+	mSize = ftell(file);
+	fseek(file, 0, SEEK_SET);
+
+	mData = (unsigned char *)malloc(mSize);
+	mOwnsData = true;
+
+	bool valid = mData != NULL && (int)fread(mData, 1, mSize, file) == mSize;
+
+	fclose(file);
+
+	if (!valid || !readDirectory())
+	{
+		unload();
+		return false;
+	}
+
+	return true;
+}
+
+/*
+	Uses a bank image that is already in memory, such as the one mapped from the asset package, without copying it.
+	The memory must stay valid until the bank is unloaded.
+*/
+bool AudioBankC::loadFromMemory(const unsigned char *data, int size)
+{
+	unload();
+
+	mData = (unsigned char *)data;
+	mSize = size;
+	mOwnsData = false;
+
+	if (!readDirectory())
+	{
+		unload();
+		return false;
+	}
+
+	return true;
+}
+
+void AudioBankC::unload()
+{
+	if (mOwnsData)
+		free(mData);
+
+	mOwnsData = false;
+	mData = NULL;
+	mSize = 0;
+	mClipCount = 0;
+	mEntries = NULL;
+}
+
+bool AudioBankC::isLoaded()
+{
+	return mData != NULL;
+}
+
+/*
+	Returns the clip stored under the given path, or NULL if the bank does not contain it.
+*/
+const AudioClipEntry* AudioBankC::findClip(const char *name)
+{
+	unsigned int hash = hashAssetName(name);
+	int low = 0;
+	int high = mClipCount - 1;
+
+	while (low <= high)
+	{
+		int middle = (low + high) / 2;
+
+		if (mEntries[middle].nameHash < hash)
+			low = middle + 1;
+		else
+			high = middle - 1;
+	}
+
+	for (int i = low; i < mClipCount && mEntries[i].nameHash == hash; i++)
+	{
+		if (assetNamesMatch(mEntries[i].name, name))
+			return &mEntries[i];
+	}
+
+	return NULL;
+}
+
+/*
+	Decodes a clip into interleaved 16-bit samples, returning the number of frames written.
+	Output must hold clip->frameCount * clip->channels samples.
+*/
+int AudioBankC::decodeClip(const AudioClipEntry *clip, short *output)
+{
+	decodeAdpcm(mData + clip->dataOffset, clip->frameCount, clip->channels, output);
+
+	return clip->frameCount;
+}
+
+/*
+	Decodes one block of frames from every channel of a clip, returning the number of frames written.
+	Output must hold ADPCM_SAMPLES_PER_BLOCK * clip->channels samples, nothing is written past the end of the clip.
+*/
+int AudioBankC::decodeClipBlock(const AudioClipEntry *clip, int blockIndex, short *output)
+{
+	int firstFrame = blockIndex * ADPCM_SAMPLES_PER_BLOCK;
+
+	if (blockIndex < 0 || firstFrame >= (int)clip->frameCount)
+		return 0;
+
+	int frames = clip->frameCount - firstFrame;
+
+	if (frames > ADPCM_SAMPLES_PER_BLOCK)
+		frames = ADPCM_SAMPLES_PER_BLOCK;
+
+	const unsigned char *block = mData + clip->dataOffset + blockIndex * clip->channels * clip->blockBytes;
+
+	for (int channel = 0; channel < clip->channels; channel++)
+		decodeAdpcmBlock(block + channel * clip->blockBytes, frames, output + channel, clip->channels);
+
+	return frames;
+}
+
+/*
+	Returns the size in bytes of the largest clip once decoded, used to size decode buffers up front.
+*/
+int AudioBankC::getLargestClipBytes()
+{
+	int largest = 0;
+
+	for (int i = 0; i < mClipCount; i++)
+	{
+		int bytes = mEntries[i].frameCount * mEntries[i].channels * sizeof(short);
+
+		if (bytes > largest)
+			largest = bytes;
+	}
+
+	return largest;
+}
+
+int AudioBankC::getResidentBytes()
+{
+	return mSize;
+}
+
+/*
+	Returns how many bytes the clips in the bank would take as uncompressed samples.
+*/
+int AudioBankC::getDecodedBytes()
+{
+	int total = 0;
+
+	for (int i = 0; i < mClipCount; i++)
+		total += mEntries[i].frameCount * mEntries[i].channels * sizeof(short);
+
+	return total;
+}
+
+/* Private functions */
+/*
+	Validates the header and locates the clip directory.
+*/
+bool AudioBankC::readDirectory()
+{
+	if (mSize < (int)sizeof(AudioBankHeader))
+		return false;
+
+	AudioBankHeader *header = (AudioBankHeader *)mData;
+
+	if (header->magic != AUDIO_BANK_MAGIC || header->version != AUDIO_BANK_VERSION ||
+		header->directoryOffset + (unsigned long long)header->clipCount * sizeof(AudioClipEntry) > (unsigned int)mSize)
+		return false;
+
+	mClipCount = header->clipCount;
+	mEntries = (AudioClipEntry *)(mData + header->directoryOffset);
+
+	return true;
+}
\ No newline at end of file
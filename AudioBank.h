@@ -0,0 +1,76 @@
+#pragma once
+/*
+	AudioBank.h
+
+	This class holds every sound clip of the game in one IMA ADPCM compressed bank kept resident in memory.
+	Clips are looked up by the same relative path that would be used to open the loose wave file, e.g. "Sounds/MenuSounds/main60.dsp.wav",
+	and decoded to 16-bit samples only when they are played.
+	Every clip is stored at AUDIO_BANK_SAMPLE_RATE, so playback never has to convert rates.
+	The bank is written by the AssetBuilder tool.
+*/
+
+#define AUDIO_BANK_MAGIC 0x4B42414B
+#define AUDIO_BANK_VERSION 2
+#define AUDIO_CLIP_NAME_LENGTH 64
+#define AUDIO_BANK_SAMPLE_RATE 48000
+
+struct AudioBankHeader
+{
+	unsigned int magic;
+	unsigned int version;
+	unsigned int clipCount;
+	unsigned int directoryOffset;
+};
+
+/*
+	Directory entries are sorted by name hash so clips can be found with a binary search.
+*/
+struct AudioClipEntry
+{
+	unsigned int nameHash;
+	char name[AUDIO_CLIP_NAME_LENGTH];
+	unsigned int sampleRate;
+	unsigned short channels;
+	unsigned short blockBytes;
+	unsigned int frameCount;
+	unsigned int dataOffset;
+	unsigned int dataBytes;
+};
+
+unsigned int hashAssetName(const char *name);
+bool assetNamesMatch(const char *a, const char *b);
+
+class AudioBankC
+{
+public:
+	/* Public functions */
+	AudioBankC();
+	~AudioBankC();
+
+	bool load(const char *path);
+	bool loadFromMemory(const unsigned char *data, int size);
+	void unload();
+	bool isLoaded();
+
+	const AudioClipEntry *findClip(const char *name);
+
+	int decodeClip(const AudioClipEntry *clip, short *output);
+	int decodeClipBlock(const AudioClipEntry *clip, int blockIndex, short *output);
+	int getLargestClipBytes();
+	int getResidentBytes();
+	int getDecodedBytes();
+
+private:
+	/* Private functions */
+	bool readDirectory();
+
+	/* Private data members */
+	bool mOwnsData;
+
+	unsigned char *mData;
+
+	int mSize;
+	int mClipCount;
+
+	AudioClipEntry *mEntries;
+};
\ No newline at end of file
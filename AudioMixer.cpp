@@ -0,0 +1,405 @@
+/*
+	AudioMixer.cpp
+
+	This file contains the implementation for the mixing kernels prototyped in AudioMixer.h.
+	The bus holds interleaved left and right floats, so a mono voice is widened to a left/right pair per sample
+	and a stereo voice is multiplied by the repeating left/right gain pair directly.
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <intrin.h>
+#include <emmintrin.h>
+#include <immintrin.h>
+#include "AudioMixer.h"
+#include "Benchmark.h"
+
+#define BENCHMARK_VOICES 64
+#define BENCHMARK_BLOCK_FRAMES 480
+#define BENCHMARK_VOICE_FRAMES (BENCHMARK_BLOCK_FRAMES * 100)
+#define BENCHMARK_SAMPLE_RATE 48000
+
+typedef void (*MixFunction)(float *bus, const short *samples, int frames, float leftGain, float rightGain);
+typedef void (*ClipFunction)(const float *bus, short *output, int frames);
+
+static MixFunction sMixMono;
+static MixFunction sMixStereo;
+static ClipFunction sClip;
+static MixerKernel::MixerKernel sKernel = MixerKernel::Scalar;
+
+static const char *kernelNames[MixerKernel::MaxKernel] = { "scalar", "SSE2", "AVX2" };
+
+/* Scalar kernels */
+static void mixMonoScalar(float *bus, const short *samples, int frames, float leftGain, float rightGain)
+{
+	for (int i = 0; i < frames; i++)
+	{
+		float sample = (float)samples[i];
+
+		bus[i * 2] += sample * leftGain;
+		bus[i * 2 + 1] += sample * rightGain;
+	}
+}
+
+static void mixStereoScalar(float *bus, const short *samples, int frames, float leftGain, float rightGain)
+{
+	for (int i = 0; i < frames; i++)
+	{
+		bus[i * 2] += (float)samples[i * 2] * leftGain;
+		bus[i * 2 + 1] += (float)samples[i * 2 + 1] * rightGain;
+	}
+}
+
+static void clipScalar(const float *bus, short *output, int frames)
+{
+	for (int i = 0; i < frames * 2; i++)
+	{
+		float sample = bus[i];
+
+		sample = sample > 32767.0f ? 32767.0f : sample;
+		sample = sample < -32768.0f ? -32768.0f : sample;
+
+		output[i] = (short)_mm_cvtss_si32(_mm_set_ss(sample));
+	}
+}
+
+/* SSE2 kernels, eight samples per iteration */
+static void mixMonoSSE2(float *bus, const short *samples, int frames, float leftGain, float rightGain)
+{
+	__m128 gains = _mm_setr_ps(leftGain, rightGain, leftGain, rightGain);
+	int i = 0;
+
+	for (; i + 8 <= frames; i += 8)
+	{
+		__m128i packed = _mm_loadu_si128((const __m128i *)(samples + i));
+		__m128i low = _mm_srai_epi32(_mm_unpacklo_epi16(packed, packed), 16);
+		__m128i high = _mm_srai_epi32(_mm_unpackhi_epi16(packed, packed), 16);
+		float *destination = bus + i * 2;
+
+		__m128 pair0 = _mm_cvtepi32_ps(_mm_unpacklo_epi32(low, low));
+		__m128 pair1 = _mm_cvtepi32_ps(_mm_unpackhi_epi32(low, low));
+		__m128 pair2 = _mm_cvtepi32_ps(_mm_unpacklo_epi32(high, high));
+		__m128 pair3 = _mm_cvtepi32_ps(_mm_unpackhi_epi32(high, high));
+
+		_mm_storeu_ps(destination, _mm_add_ps(_mm_loadu_ps(destination), _mm_mul_ps(pair0, gains)));
+		_mm_storeu_ps(destination + 4, _mm_add_ps(_mm_loadu_ps(destination + 4), _mm_mul_ps(pair1, gains)));
+		_mm_storeu_ps(destination + 8, _mm_add_ps(_mm_loadu_ps(destination + 8), _mm_mul_ps(pair2, gains)));
+		_mm_storeu_ps(destination + 12, _mm_add_ps(_mm_loadu_ps(destination + 12), _mm_mul_ps(pair3, gains)));
+	}
+
+	mixMonoScalar(bus + i * 2, samples + i, frames - i, leftGain, rightGain);
+}
+
+static void mixStereoSSE2(float *bus, const short *samples, int frames, float leftGain, float rightGain)
+{
+	__m128 gains = _mm_setr_ps(leftGain, rightGain, leftGain, rightGain);
+	int i = 0;
+
+	for (; i + 4 <= frames; i += 4)
+	{
+		__m128i packed = _mm_loadu_si128((const __m128i *)(samples + i * 2));
+		__m128 low = _mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpacklo_epi16(packed, packed), 16));
+		__m128 high = _mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpackhi_epi16(packed, packed), 16));
+		float *destination = bus + i * 2;
+
+		_mm_storeu_ps(destination, _mm_add_ps(_mm_loadu_ps(destination), _mm_mul_ps(low, gains)));
+		_mm_storeu_ps(destination + 4, _mm_add_ps(_mm_loadu_ps(destination + 4), _mm_mul_ps(high, gains)));
+	}
+
+	mixStereoScalar(bus + i * 2, samples + i * 2, frames - i, leftGain, rightGain);
+}
+
+/*
+	Conversion rounds to nearest and the signed pack saturates, which clips the bus to the 16-bit range.
+*/
+static void clipSSE2(const float *bus, short *output, int frames)
+{
+	int samples = frames * 2;
+	int i = 0;
+
+	for (; i + 8 <= samples; i += 8)
+	{
+		__m128i low = _mm_cvtps_epi32(_mm_loadu_ps(bus + i));
+		__m128i high = _mm_cvtps_epi32(_mm_loadu_ps(bus + i + 4));
+
+		_mm_storeu_si128((__m128i *)(output + i), _mm_packs_epi32(low, high));
+	}
+
+	clipScalar(bus + i, output + i, (samples - i) / 2);
+}
+
+/* AVX2 kernels, sixteen samples per iteration */
+static void mixMonoAVX2(float *bus, const short *samples, int frames, float leftGain, float rightGain)
+{
+	__m256 gains = _mm256_setr_ps(leftGain, rightGain, leftGain, rightGain, leftGain, rightGain, leftGain, rightGain);
+	__m256i lowOrder = _mm256_setr_epi32(0, 0, 1, 1, 2, 2, 3, 3);
+	__m256i highOrder = _mm256_setr_epi32(4, 4, 5, 5, 6, 6, 7, 7);
+	int i = 0;
+
+	for (; i + 8 <= frames; i += 8)
+	{
+		__m256i widened = _mm256_cvtepi16_epi32(_mm_loadu_si128((const __m128i *)(samples + i)));
+		__m256 low = _mm256_cvtepi32_ps(_mm256_permutevar8x32_epi32(widened, lowOrder));
+		__m256 high = _mm256_cvtepi32_ps(_mm256_permutevar8x32_epi32(widened, highOrder));
+		float *destination = bus + i * 2;
+
+		_mm256_storeu_ps(destination, _mm256_add_ps(_mm256_loadu_ps(destination), _mm256_mul_ps(low, gains)));
+		_mm256_storeu_ps(destination + 8, _mm256_add_ps(_mm256_loadu_ps(destination + 8), _mm256_mul_ps(high, gains)));
+	}
+
+	_mm256_zeroupper();
+
+	mixMonoScalar(bus + i * 2, samples + i, frames - i, leftGain, rightGain);
+}
+
+static void mixStereoAVX2(float *bus, const short *samples, int frames, float leftGain, float rightGain)
+{
+	__m256 gains = _mm256_setr_ps(leftGain, rightGain, leftGain, rightGain, leftGain, rightGain, leftGain, rightGain);
+	int i = 0;
+
+	for (; i + 8 <= frames; i += 8)
+	{
+		__m256 low = _mm256_cvtepi32_ps(_mm256_cvtepi16_epi32(_mm_loadu_si128((const __m128i *)(samples + i * 2))));
+		__m256 high = _mm256_cvtepi32_ps(_mm256_cvtepi16_epi32(_mm_loadu_si128((const __m128i *)(samples + i * 2 + 8))));
+		float *destination = bus + i * 2;
+
+		_mm256_storeu_ps(destination, _mm256_add_ps(_mm256_loadu_ps(destination), _mm256_mul_ps(low, gains)));
+		_mm256_storeu_ps(destination + 8, _mm256_add_ps(_mm256_loadu_ps(destination + 8), _mm256_mul_ps(high, gains)));
+	}
+
+	_mm256_zeroupper();
+
+	mixStereoScalar(bus + i * 2, samples + i * 2, frames - i, leftGain, rightGain);
+}
+
+static void clipAVX2(const float *bus, short *output, int frames)
+{
+	int samples = frames * 2;
+	int i = 0;
+
+	for (; i + 16 <= samples; i += 16)
+	{
+		__m256i low = _mm256_cvtps_epi32(_mm256_loadu_ps(bus + i));
+		__m256i high = _mm256_cvtps_epi32(_mm256_loadu_ps(bus + i + 8));
+		__m256i packed = _mm256_permute4x64_epi64(_mm256_packs_epi32(low, high), 0xD8);
+
+		_mm256_storeu_si256((__m256i *)(output + i), packed);
+	}
+
+	_mm256_zeroupper();
+
+	clipSSE2(bus + i, output + i, (samples - i) / 2);
+}
+
+/* Processor detection */
+static bool hasSSE2()
+{
+	int info[4];
+
+	__cpuid(info, 1);
+
+	return (info[3] & (1 << 26)) != 0;
+}
+
+/*
+	AVX2 needs both the instruction set and an operating system that saves the upper halves of the vector registers.
+*/
+static bool hasAVX2()
+{
+	int info[4];
+
+	__cpuid(info, 0);
+
+	if (info[0] < 7)
+		return false;
+
+	__cpuid(info, 1);
+
+	bool osSavesAVX = (info[2] & (1 << 27)) && (info[2] & (1 << 28)) && ((_xgetbv(0) & 6) == 6);
+
+	if (!osSavesAVX)
+		return false;
+
+	__cpuidex(info, 7, 0);
+
+	return (info[1] & (1 << 5)) != 0;
+}
+
+/* Public functions */
+/*
+	Selects the fastest kernel the processor supports.
+*/
+void initAudioMixer()
+{
+	if (isMixerKernelSupported(MixerKernel::AVX2))
+		setMixerKernel(MixerKernel::AVX2);
+	else if (isMixerKernelSupported(MixerKernel::SSE2))
+		setMixerKernel(MixerKernel::SSE2);
+	else
+		setMixerKernel(MixerKernel::Scalar);
+}
+
+/*
+	Forces a specific kernel, used by the mixer benchmark to compare them.
+*/
+void setMixerKernel(MixerKernel::MixerKernel kernel)
+{
+	sKernel = kernel;
+
+	switch (kernel)
+	{
+	case MixerKernel::AVX2:
+		sMixMono = mixMonoAVX2;
+		sMixStereo = mixStereoAVX2;
+		sClip = clipAVX2;
+		break;
+	case MixerKernel::SSE2:
+		sMixMono = mixMonoSSE2;
+		sMixStereo = mixStereoSSE2;
+		sClip = clipSSE2;
+		break;
+	default:
+		sKernel = MixerKernel::Scalar;
+		sMixMono = mixMonoScalar;
+		sMixStereo = mixStereoScalar;
+		sClip = clipScalar;
+		break;
+	}
+}
+
+bool isMixerKernelSupported(MixerKernel::MixerKernel kernel)
+{
+	switch (kernel)
+	{
+	case MixerKernel::Scalar:
+		return true;
+	case MixerKernel::SSE2:
+		return hasSSE2();
+	case MixerKernel::AVX2:
+		return hasSSE2() && hasAVX2();
+	default:
+		return false;
+	}
+}
+
+MixerKernel::MixerKernel getMixerKernel()
+{
+	return sKernel;
+}
+
+const char* getMixerKernelName(MixerKernel::MixerKernel kernel)
+{
+	return kernel < MixerKernel::MaxKernel ? kernelNames[kernel] : "unknown";
+}
+
+/*
+	Converts a pan position from -1 (left) to 1 (right) into constant power left and right gains.
+*/
+void getPanGains(float pan, float gain, float *leftGain, float *rightGain)
+{
+	pan = pan < -1.0f ? -1.0f : pan;
+	pan = pan > 1.0f ? 1.0f : pan;
+
+	float angle = (pan + 1.0f) * 0.785398163f;
+
+	*leftGain = cosf(angle) * gain;
+	*rightGain = sinf(angle) * gain;
+}
+
+void clearBus(float *bus, int frames)
+{
+	memset(bus, 0, frames * 2 * sizeof(float));
+}
+
+/*
+	Adds the gain scaled samples of a mono or stereo voice onto the stereo bus.
+*/
+void mixVoice(float *bus, const short *samples, int frames, int channels, float leftGain, float rightGain)
+{
+	if (sMixMono == NULL)
+		initAudioMixer();
+
+	if (channels == 1)
+		sMixMono(bus, samples, frames, leftGain, rightGain);
+	else
+		sMixStereo(bus, samples, frames, leftGain, rightGain);
+}
+
+/*
+	Rounds the bus back to 16-bit stereo samples, saturating anything outside the 16-bit range.
+*/
+void clipBus(const float *bus, short *output, int frames)
+{
+	if (sClip == NULL)
+		initAudioMixer();
+
+	sClip(bus, output, frames);
+}
+
+/*
+	Mixes and clips blocks of a full voice pool with every supported kernel for a fixed time.
+	A result of N voices per millisecond means one core spends one millisecond mixing one millisecond of audio for N voices.
+*/
+void benchmarkMixer()
+{
+	short *samples = (short *)malloc(BENCHMARK_VOICE_FRAMES * 2 * sizeof(short));
+	float *bus = (float *)malloc(BENCHMARK_BLOCK_FRAMES * 2 * sizeof(float));
+	short *output = (short *)malloc(BENCHMARK_BLOCK_FRAMES * 2 * sizeof(short));
+	unsigned int noise = 12345;
+
+	for (int i = 0; i < BENCHMARK_VOICE_FRAMES * 2; i++)
+	{
+		noise = noise * 1664525u + 1013904223u;
+		samples[i] = (short)(noise >> 16) / 8;
+	}
+
+	MixerKernel::MixerKernel selected = getMixerKernel();
+
+	for (int kernel = 0; kernel < MixerKernel::MaxKernel; kernel++)
+	{
+		if (!isMixerKernelSupported((MixerKernel::MixerKernel)kernel))
+			continue;
+
+		setMixerKernel((MixerKernel::MixerKernel)kernel);
+
+		for (int channels = 1; channels <= 2; channels++)
+		{
+			long long voiceFrames = 0;
+			double start = getBenchmarkSeconds();
+			double elapsed = 0.0;
+			int offset = 0;
+
+			while (elapsed < 0.5)
+			{
+				clearBus(bus, BENCHMARK_BLOCK_FRAMES);
+
+				for (int voice = 0; voice < BENCHMARK_VOICES; voice++)
+				{
+					float leftGain, rightGain;
+
+					getPanGains(voice / (BENCHMARK_VOICES / 2.0f) - 1.0f, 0.25f, &leftGain, &rightGain);
+					mixVoice(bus, samples + offset * channels, BENCHMARK_BLOCK_FRAMES, channels, leftGain, rightGain);
+				}
+
+				clipBus(bus, output, BENCHMARK_BLOCK_FRAMES);
+
+				voiceFrames += BENCHMARK_VOICES * BENCHMARK_BLOCK_FRAMES;
+				offset = (offset + BENCHMARK_BLOCK_FRAMES) % (BENCHMARK_VOICE_FRAMES - BENCHMARK_BLOCK_FRAMES);
+				elapsed = getBenchmarkSeconds() - start;
+			}
+
+			double audioMilliseconds = voiceFrames * 1000.0 / BENCHMARK_SAMPLE_RATE;
+
+			printf("  %-6s %s: %8.0f voices per ms of audio, %6.2f ns per voice frame\n", getMixerKernelName((MixerKernel::MixerKernel)kernel),
+				channels == 1 ? "mono  " : "stereo", audioMilliseconds / (elapsed * 1000.0), elapsed * 1e9 / voiceFrames);
+		}
+	}
+
+	setMixerKernel(selected);
+
+	free(samples);
+	free(bus);
+	free(output);
+}
\ No newline at end of file
@@ -0,0 +1,25 @@
+#pragma once
+/*
+	AudioMixer.h
+
+	Kernels that accumulate 16-bit voices into a stereo float bus and convert the bus back to 16-bit samples.
+	The fastest kernel supported by the processor is picked at start up; scalar, SSE2 and AVX2 versions produce the same mix.
+*/
+
+namespace MixerKernel
+{
+	enum MixerKernel { Scalar, SSE2, AVX2, MaxKernel };
+}
+
+void initAudioMixer();
+void setMixerKernel(MixerKernel::MixerKernel kernel);
+bool isMixerKernelSupported(MixerKernel::MixerKernel kernel);
+
+MixerKernel::MixerKernel getMixerKernel();
+const char *getMixerKernelName(MixerKernel::MixerKernel kernel);
+
+void getPanGains(float pan, float gain, float *leftGain, float *rightGain);
+
+void clearBus(float *bus, int frames);
+void mixVoice(float *bus, const short *samples, int frames, int channels, float leftGain, float rightGain);
+void clipBus(const float *bus, short *output, int frames);
\ No newline at end of file
@@ -0,0 +1,93 @@
+/*
+	Benchmark.cpp
+
+	This file contains the implementation for functions prototyped in Benchmark.h.
+*/
+
+#define _CRT_SECURE_NO_WARNINGS
+
+#include <windows.h>
+#include <stdio.h>
+#include <string.h>
+#include "Benchmark.h"
+
+struct BenchmarkEntry
+{
+	const char *name;
+	const char *description;
+	void (*run)();
+};
+
+static const BenchmarkEntry benchmarks[] =
+{
+	{ "mixer", "voices each mixing kernel can mix per millisecond of audio", benchmarkMixer },
+	{ "collision", "cost of building a sprite sheet's collision mask and of testing two frames for overlapping pixels", benchmarkCollisionMasks },
+	{ "simulation", "cost of a player's action decision each tick, decided by the old branches and looked up in the transition table", benchmarkPlayerStateMachine },
+	{ "fixedpoint", "cost of moving bodies in fixed point against floats, with a hash of the state to compare between builds", benchmarkFixedPoint },
+	{ "random", "cost of drawing random numbers with rand(), one at a time from the match generator and in bulk", benchmarkRandom },
+	{ "statehash", "cost of hashing the state of a match, done every tick", benchmarkStateHash },
+	{ "determinism", "a scripted match played through the simulation, checked against the final state hash expected of this build", benchmarkDeterminism }
+};
+
+static const int benchmarkCount = sizeof(benchmarks) / sizeof(benchmarks[0]);
+static const char *benchmarkOption = "-benchmark";
+static bool benchmarkFailed = false;
+
+/*
+	Runs the benchmarks selected on the command line and waits for enter before returning.
+	With no name after the option every benchmark is run. Returns false if the option is not present.
+	The exit code is 1 if a benchmark that checks its results failed, and 0 otherwise.
+*/
+bool runBenchmarks(const char *commandLine, int *exitCode)
+{
+	const char *option = commandLine != NULL ? strstr(commandLine, benchmarkOption) : NULL;
+
+	if (option == NULL)
+		return false;
+
+	char name[32] = "";
+
+	sscanf(option + strlen(benchmarkOption), "%31s", name);
+
+	for (int i = 0; i < benchmarkCount; i++)
+	{
+		if (name[0] && strcmp(name, benchmarks[i].name))
+			continue;
+
+		printf("%s: %s\n", benchmarks[i].name, benchmarks[i].description);
+		benchmarks[i].run();
+		printf("\n");
+	}
+
+	if (benchmarkFailed)
+		printf("BENCHMARK CHECKS FAILED, see above.\n");
+
+	*exitCode = benchmarkFailed ? 1 : 0;
+
+	printf("Press enter to exit.\n");
+	getchar();
+
+	return true;
+}
+
+/*
+	Marks the run as failed, for benchmarks that check their results as well as timing them.
+*/
+void failBenchmark()
+{
+	benchmarkFailed = true;
+}
+
+/*
+	Returns the time in seconds from the high resolution performance counter.
+*/
+double getBenchmarkSeconds()
+{
+	LARGE_INTEGER frequency;
+	LARGE_INTEGER counter;
+
+	QueryPerformanceFrequency(&frequency);
+	QueryPerformanceCounter(&counter);
+
+	return (double)counter.QuadPart / (double)frequency.QuadPart;
+}
\ No newline at end of file
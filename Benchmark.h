@@ -0,0 +1,21 @@
+#pragma once
+/*
+	Benchmark.h
+
+	Microbenchmarks of the game's hot paths, run instead of the game by starting it with -benchmark [name].
+	Results are printed to the console. Each benchmark is implemented next to the code it measures and registered in Benchmark.cpp.
+	Benchmarks that also check their results call failBenchmark() when they are wrong, which makes the game exit with a non-zero code.
+*/
+
+bool runBenchmarks(const char *commandLine, int *exitCode);
+void failBenchmark();
+
+double getBenchmarkSeconds();
+
+void benchmarkMixer();
+void benchmarkCollisionMasks();
+void benchmarkPlayerStateMachine();
+void benchmarkFixedPoint();
+void benchmarkRandom();
+void benchmarkStateHash();
+void benchmarkDeterminism();
\ No newline at end of file
@@ -0,0 +1,46 @@
+/*
+	Character.cpp
+
+	This file contains the roster of playable characters and the functions prototyped in Character.h.
+*/
+
+#include <stddef.h>
+#include "Character.h"
+#include "AssetPackage.h"
+
+static const CharacterDefinition *roster[] =
+{
+	&kirbyCharacter
+};
+
+static const int rosterCount = sizeof(roster) / sizeof(roster[0]);
+
+int getCharacterCount()
+{
+	return rosterCount;
+}
+
+/*
+	Returns the roster index of the character with the given name, ignoring case, or NO_CHARACTER if there is none.
+*/
+int findCharacter(const char *name)
+{
+	for (int i = 0; i < rosterCount; i++)
+	{
+		if (assetNamesMatch(roster[i]->name, name))
+			return i;
+	}
+
+	return NO_CHARACTER;
+}
+
+/*
+	Returns the definition of a character of the roster, or NULL if the index is outside it.
+*/
+const CharacterDefinition* getCharacter(int character)
+{
+	if (character < 0 || character >= rosterCount)
+		return NULL;
+
+	return roster[character];
+}
\ No newline at end of file
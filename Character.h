@@ -0,0 +1,70 @@
+#pragma once
+/*
+	Character.h
+
+	The roster of playable characters. Each character is defined once by a CharacterDefinition pointing at its data:
+	the sprite sheets it is drawn from, the tables that drive its animations, its move timelines and the sounds of its animations.
+	Players point at the definition of the character they picked, so the tables exist once however many players share a character,
+	and only the sprite sheets of the characters and palettes in a match are added to the match's texture scope.
+	Adding a character means writing its definition in its own file and listing it in the roster in Character.cpp.
+*/
+
+#include "MoveTimeline.h"
+
+#define CHARACTER_ANIMATIONS 33
+#define NO_CHARACTER -1
+
+/*
+	Tables indexed by the animation indexes of PlayerC. Animations with a left-facing variant store it at index + 1.
+	Durations, frame lengths and damage delays are whole milliseconds, so timers count down without rounding.
+*/
+struct CharacterMoves
+{
+	int sheetColumns[CHARACTER_ANIMATIONS];
+	bool mirroredAnimations[CHARACTER_ANIMATIONS];
+	float mirrorOffsets[CHARACTER_ANIMATIONS];
+
+	float collisionStartX[CHARACTER_ANIMATIONS];
+	float collisionStartY[CHARACTER_ANIMATIONS];
+	float collisionEndX[CHARACTER_ANIMATIONS];
+	float collisionEndY[CHARACTER_ANIMATIONS];
+
+	int animationDurations[CHARACTER_ANIMATIONS];
+	int animationSpeeds[CHARACTER_ANIMATIONS];
+	int damageDelays[CHARACTER_ANIMATIONS];
+};
+
+/*
+	The names of the voice sound and sound effect of each animation, without directory or extension. Animations without one use "".
+*/
+struct CharacterSounds
+{
+	const char *voiceSounds[CHARACTER_ANIMATIONS];
+	const char *soundEffects[CHARACTER_ANIMATIONS];
+};
+
+/*
+	The sprite sheet of a palette is the sprite sheet path followed by the palette number and ".png".
+*/
+struct CharacterDefinition
+{
+	const char *name;
+	const char *spriteSheetPath;
+
+	int rowsInSpriteSheet;
+	int columnsInSpriteSheet;
+
+	float spriteHeight;
+	float spriteWidth;
+
+	const CharacterMoves *moves;
+	const MoveTimelineSet *timelines;
+	const CharacterSounds *sounds;
+};
+
+extern const CharacterDefinition kirbyCharacter;
+
+int getCharacterCount();
+int findCharacter(const char *name);
+
+const CharacterDefinition *getCharacter(int character);
\ No newline at end of file
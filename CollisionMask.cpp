@@ -0,0 +1,260 @@
+/*
+	CollisionMask.cpp
+
+	This file contains the implementation of the functions prototyped in the CollisionMaskC class.
+*/
+
+#define _CRT_SECURE_NO_WARNINGS
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "CollisionMask.h"
+#include "Benchmark.h"
+
+#define BENCHMARK_SHEET_WIDTH 2448
+#define BENCHMARK_SHEET_HEIGHT 1584
+#define BENCHMARK_CELL_SIZE 144
+#define BENCHMARK_TESTS 1000000
+
+/* Public functions */
+CollisionMaskC::CollisionMaskC()
+{
+	mWidth = 0;
+	mHeight = 0;
+	mWordsPerRow = 0;
+	mBits = NULL;
+	mMirroredBits = NULL;
+}
+
+CollisionMaskC::~CollisionMaskC()
+{
+	free(mBits);
+}
+
+/*
+	Builds the mask from decoded pixels stored row by row from the top left.
+	Pixels without an alpha channel are all treated as solid. Returns false if the mask could not be allocated.
+	Each row has one word past its last pixel so a word can be read from any bit offset within the row.
+*/
+bool CollisionMaskC::build(const unsigned char *pixels, int width, int height, int channels)
+{
+	free(mBits);
+
+	mWidth = width;
+	mHeight = height;
+	mWordsPerRow = (width + COLLISION_MASK_WORD_BITS - 1) / COLLISION_MASK_WORD_BITS + 1;
+	mBits = (unsigned long long *)calloc((size_t)mWordsPerRow * height * 2, sizeof(unsigned long long));
+	mMirroredBits = mBits + (size_t)mWordsPerRow * height;
+
+	if (mBits == NULL)
+	{
+		mWidth = 0;
+		mHeight = 0;
+		mMirroredBits = NULL;
+		return false;
+	}
+
+	bool hasAlpha = channels == 2 || channels == 4;
+
+	for (int y = 0; y < height; y++)
+	{
+		const unsigned char *alpha = pixels + (size_t)y * width * channels + channels - 1;
+		unsigned long long *row = mBits + (size_t)y * mWordsPerRow;
+		unsigned long long *mirroredRow = mMirroredBits + (size_t)y * mWordsPerRow;
+
+		for (int x = 0; x < width; x++)
+		{
+			if (hasAlpha && alpha[x * channels] == 0)
+				continue;
+
+			int mirroredX = width - 1 - x;
+
+			row[x / COLLISION_MASK_WORD_BITS] |= 1ull << (x % COLLISION_MASK_WORD_BITS);
+			mirroredRow[mirroredX / COLLISION_MASK_WORD_BITS] |= 1ull << (mirroredX % COLLISION_MASK_WORD_BITS);
+		}
+	}
+
+	return true;
+}
+
+int CollisionMaskC::getWidth() const
+{
+	return mWidth;
+}
+
+int CollisionMaskC::getHeight() const
+{
+	return mHeight;
+}
+
+int CollisionMaskC::getBytes() const
+{
+	return mWordsPerRow * mHeight * 2 * (int)sizeof(unsigned long long);
+}
+
+/*
+	Narrows a frame to the part of it inside the given world rectangle, so only those pixels are tested.
+	A mirrored frame reads its rectangle flipped, so clipping its left side in the world removes columns from the right of the rectangle.
+	Returns false if nothing of the frame is left.
+*/
+bool CollisionMaskC::clipFrame(CollisionFrame *frame, int left, int top, int right, int bottom)
+{
+	int clipLeft = left > frame->left ? left - frame->left : 0;
+	int clipTop = top > frame->top ? top - frame->top : 0;
+	int clipRight = frame->left + frame->width > right ? frame->left + frame->width - right : 0;
+	int clipBottom = frame->top + frame->height > bottom ? frame->top + frame->height - bottom : 0;
+
+	if (clipLeft + clipRight >= frame->width || clipTop + clipBottom >= frame->height)
+		return false;
+
+	frame->x += frame->mirrored ? clipRight : clipLeft;
+	frame->y += clipTop;
+	frame->width -= clipLeft + clipRight;
+	frame->height -= clipTop + clipBottom;
+	frame->left += clipLeft;
+	frame->top += clipTop;
+
+	return true;
+}
+
+/*
+	Returns whether any pixel of one frame lands on a pixel of the other, where the frames overlap in the world.
+	A mirrored frame reads the same rectangle flipped, out of the mirrored copy of its mask.
+*/
+bool CollisionMaskC::framesOverlap(const CollisionFrame *a, const CollisionFrame *b)
+{
+	int left = a->left > b->left ? a->left : b->left;
+	int top = a->top > b->top ? a->top : b->top;
+	int right = a->left + a->width < b->left + b->width ? a->left + a->width : b->left + b->width;
+	int bottom = a->top + a->height < b->top + b->height ? a->top + a->height : b->top + b->height;
+
+	if (left >= right || top >= bottom)
+		return false;
+
+	int span = right - left;
+	int words = (span + COLLISION_MASK_WORD_BITS - 1) / COLLISION_MASK_WORD_BITS;
+	int tailBits = span - (words - 1) * COLLISION_MASK_WORD_BITS;
+	unsigned long long tailMask = tailBits == COLLISION_MASK_WORD_BITS ? ~0ull : (1ull << tailBits) - 1;
+	int bitA = (a->mirrored ? a->mask->mWidth - a->x - a->width : a->x) + left - a->left;
+	int bitB = (b->mirrored ? b->mask->mWidth - b->x - b->width : b->x) + left - b->left;
+	int shiftA = bitA % COLLISION_MASK_WORD_BITS;
+	int shiftB = bitB % COLLISION_MASK_WORD_BITS;
+	const unsigned long long *rowA = a->mask->getRow(a->y + top - a->top, a->mirrored) + bitA / COLLISION_MASK_WORD_BITS;
+	const unsigned long long *rowB = b->mask->getRow(b->y + top - b->top, b->mirrored) + bitB / COLLISION_MASK_WORD_BITS;
+
+	for (int y = top; y < bottom; y++)
+	{
+		unsigned long long bits = 0;
+
+		for (int word = 0; word < words; word++)
+		{
+			unsigned long long wordBits = getBits(rowA + word, shiftA) & getBits(rowB + word, shiftB);
+
+			bits |= word == words - 1 ? wordBits & tailMask : wordBits;
+		}
+
+		if (bits != 0)
+			return true;
+
+		rowA += a->mask->mWordsPerRow;
+		rowB += b->mask->mWordsPerRow;
+	}
+
+	return false;
+}
+
+/* Private functions */
+const unsigned long long* CollisionMaskC::getRow(int y, bool mirrored) const
+{
+	return (mirrored ? mMirroredBits : mBits) + (size_t)y * mWordsPerRow;
+}
+
+/*
+	Returns the 64 bits starting the given number of bits into a word, joining it with the next word.
+*/
+unsigned long long CollisionMaskC::getBits(const unsigned long long *word, int shift)
+{
+	if (shift == 0)
+		return word[0];
+
+	return (word[0] >> shift) | (word[1] << (COLLISION_MASK_WORD_BITS - shift));
+}
+
+/*
+	Builds the mask of a sprite sheet sized sheet of round frames, then times frame tests at random placements,
+	and the worst case of two frames that cover each other's whole cell without sharing a pixel, so every row is read.
+*/
+void benchmarkCollisionMasks()
+{
+	unsigned char *pixels = (unsigned char *)calloc((size_t)BENCHMARK_SHEET_WIDTH * BENCHMARK_SHEET_HEIGHT, 4);
+	unsigned int noise = 12345;
+	int radius = BENCHMARK_CELL_SIZE / 4;
+
+	for (int y = 0; y < BENCHMARK_SHEET_HEIGHT; y++)
+	{
+		for (int x = 0; x < BENCHMARK_SHEET_WIDTH; x++)
+		{
+			int cellX = x % BENCHMARK_CELL_SIZE - BENCHMARK_CELL_SIZE / 2;
+			int cellY = y % BENCHMARK_CELL_SIZE - BENCHMARK_CELL_SIZE / 2;
+			bool leftHalf = y < BENCHMARK_CELL_SIZE && x < BENCHMARK_CELL_SIZE / 2;
+			bool rightHalf = y < BENCHMARK_CELL_SIZE && x >= BENCHMARK_CELL_SIZE * 3 / 2 && x < BENCHMARK_CELL_SIZE * 2;
+
+			if (leftHalf || rightHalf || (y >= BENCHMARK_CELL_SIZE && cellX * cellX + cellY * cellY < radius * radius))
+				pixels[((size_t)y * BENCHMARK_SHEET_WIDTH + x) * 4 + 3] = 0xFF;
+		}
+	}
+
+	CollisionMaskC mask;
+	double start = getBenchmarkSeconds();
+
+	mask.build(pixels, BENCHMARK_SHEET_WIDTH, BENCHMARK_SHEET_HEIGHT, 4);
+
+	double buildSeconds = getBenchmarkSeconds() - start;
+
+	printf("  build %dx%d: %6.2f ms, %d KB\n", BENCHMARK_SHEET_WIDTH, BENCHMARK_SHEET_HEIGHT, buildSeconds * 1000.0, mask.getBytes() / 1024);
+
+	CollisionFrame a = { &mask, 0, BENCHMARK_CELL_SIZE, BENCHMARK_CELL_SIZE, BENCHMARK_CELL_SIZE, 0, 0, false };
+	CollisionFrame b = a;
+	int hits = 0;
+
+	start = getBenchmarkSeconds();
+
+	for (int i = 0; i < BENCHMARK_TESTS; i++)
+	{
+		noise = noise * 1664525u + 1013904223u;
+
+		a.x = (noise >> 8) % (BENCHMARK_SHEET_WIDTH / BENCHMARK_CELL_SIZE) * BENCHMARK_CELL_SIZE;
+		b.left = (int)((noise >> 16) % BENCHMARK_CELL_SIZE) - BENCHMARK_CELL_SIZE / 2;
+		b.top = (int)((noise >> 24) % BENCHMARK_CELL_SIZE) - BENCHMARK_CELL_SIZE / 2;
+		b.mirrored = (noise & 1) != 0;
+
+		hits += CollisionMaskC::framesOverlap(&a, &b) ? 1 : 0;
+	}
+
+	double randomSeconds = getBenchmarkSeconds() - start;
+	int randomHits = hits;
+
+	a.x = 0;
+	a.y = 0;
+	b.x = BENCHMARK_CELL_SIZE;
+	b.y = 0;
+	b.left = 0;
+	b.top = 0;
+	b.mirrored = false;
+
+	start = getBenchmarkSeconds();
+
+	for (int i = 0; i < BENCHMARK_TESTS; i++)
+	{
+		a.left = -(i & 1);
+		hits += CollisionMaskC::framesOverlap(&a, &b) ? 1 : 0;
+	}
+
+	double worstSeconds = getBenchmarkSeconds() - start;
+
+	printf("  random placements: %6.1f ns per test, %d%% hit\n", randomSeconds * 1e9 / BENCHMARK_TESTS, (int)((long long)randomHits * 100 / BENCHMARK_TESTS));
+	printf("  worst case %dx%d: %6.1f ns per test, %d hits\n", BENCHMARK_CELL_SIZE, BENCHMARK_CELL_SIZE, worstSeconds * 1e9 / BENCHMARK_TESTS, hits - randomHits);
+
+	free(pixels);
+}
\ No newline at end of file
@@ -0,0 +1,64 @@
+#pragma once
+/*
+	CollisionMask.h
+
+	A collision mask holds one bit per pixel of a texture, set where the pixel has any alpha, packed into 64-bit words row by row.
+	Masks are built by the TextureManagerC decode workers from the pixels they already decode, for the textures that ask for one.
+	The mask is stored twice, as drawn and mirrored horizontally, so mirrored frames are tested without reversing any bits.
+	Testing two frames for a pixel overlap ANDs only the rows their rectangles share, one 64-bit word at a time,
+	so it costs at most the overlap height times the overlap width over 64 word operations: 432 for two full 144 pixel cells.
+*/
+
+#define COLLISION_MASK_WORD_BITS 64
+
+class CollisionMaskC;
+
+/*
+	A rectangle of a collision mask placed in the world, such as one frame of a sprite sheet where a sprite drew it.
+	The rectangle is in pixels from the top left of the mask and is placed with its top left corner at left and top, in pixels with y pointing down.
+*/
+struct CollisionFrame
+{
+	const CollisionMaskC *mask;
+
+	int x;
+	int y;
+	int width;
+	int height;
+
+	int left;
+	int top;
+
+	bool mirrored;
+};
+
+class CollisionMaskC
+{
+public:
+	/* Public functions */
+	CollisionMaskC();
+	~CollisionMaskC();
+
+	bool build(const unsigned char *pixels, int width, int height, int channels);
+
+	int getWidth() const;
+	int getHeight() const;
+	int getBytes() const;
+
+	static bool clipFrame(CollisionFrame *frame, int left, int top, int right, int bottom);
+	static bool framesOverlap(const CollisionFrame *a, const CollisionFrame *b);
+
+private:
+	/* Private functions */
+	const unsigned long long *getRow(int y, bool mirrored) const;
+
+	static unsigned long long getBits(const unsigned long long *word, int shift);
+
+	/* Private data members */
+	int mWidth;
+	int mHeight;
+	int mWordsPerRow;
+
+	unsigned long long *mBits;
+	unsigned long long *mMirroredBits;
+};
\ No newline at end of file
@@ -0,0 +1,445 @@
+/*
+	DesyncCheck.cpp
+
+	This file contains the implementation for functions prototyped in DesyncCheck.h.
+*/
+
+#define _CRT_SECURE_NO_WARNINGS
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stddef.h>
+#include <string.h>
+#include "DesyncCheck.h"
+#include "MatchLog.h"
+#include "PlayerManager.h"
+#include "GameEventManager.h"
+
+/*
+	Enumeration used to represent how a field of a snapshot is compared and printed.
+*/
+namespace SnapshotFieldType
+{
+	enum SnapshotFieldType { Bool, Int, Word, Float, Scalar, Gamepad };
+}
+
+/*
+	A field of a snapshot, named as the data member it was copied from.
+*/
+struct SnapshotField
+{
+	const char *name;
+	int offset;
+	SnapshotFieldType::SnapshotFieldType type;
+};
+
+static const SnapshotField playerFields[] =
+{
+	{ "mLastDamageDealt", offsetof(PlayerSnapshot, lastDamageDealt), SnapshotFieldType::Int },
+	{ "mLastDamageTaken", offsetof(PlayerSnapshot, lastDamageTaken), SnapshotFieldType::Int },
+	{ "mLastAction", offsetof(PlayerSnapshot, lastAction), SnapshotFieldType::Int },
+	{ "mState", offsetof(PlayerSnapshot, state), SnapshotFieldType::Int },
+	{ "mHealth", offsetof(PlayerSnapshot, health), SnapshotFieldType::Int },
+	{ "mCurrentAnimationFrame", offsetof(PlayerSnapshot, currentAnimationFrame), SnapshotFieldType::Int },
+	{ "mMoveFrame", offsetof(PlayerSnapshot, moveFrame), SnapshotFieldType::Int },
+	{ "mCurrentActionDelay", offsetof(PlayerSnapshot, currentActionDelay), SnapshotFieldType::Int },
+	{ "mDamageDelay", offsetof(PlayerSnapshot, damageDelay), SnapshotFieldType::Int },
+	{ "mCurrentFrameMilliseconds", offsetof(PlayerSnapshot, currentFrameMilliseconds), SnapshotFieldType::Int },
+	{ "mMillisecondsPerFrame", offsetof(PlayerSnapshot, millisecondsPerFrame), SnapshotFieldType::Int },
+	{ "mLastDirectionalInput", offsetof(PlayerSnapshot, lastDirectionalInput), SnapshotFieldType::Float },
+	{ "mU", offsetof(PlayerSnapshot, u), SnapshotFieldType::Float },
+	{ "mV", offsetof(PlayerSnapshot, v), SnapshotFieldType::Float },
+	{ "mLastU", offsetof(PlayerSnapshot, lastU), SnapshotFieldType::Float },
+	{ "mHeightBeforeJump", offsetof(PlayerSnapshot, heightBeforeJump), SnapshotFieldType::Scalar },
+	{ "mSimPosition.x", offsetof(PlayerSnapshot, position.x), SnapshotFieldType::Scalar },
+	{ "mSimPosition.y", offsetof(PlayerSnapshot, position.y), SnapshotFieldType::Scalar },
+	{ "mSimVelocity.x", offsetof(PlayerSnapshot, velocity.x), SnapshotFieldType::Scalar },
+	{ "mSimVelocity.y", offsetof(PlayerSnapshot, velocity.y), SnapshotFieldType::Scalar },
+	{ "mSpriteHandler->mHitBoxStart.x", offsetof(PlayerSnapshot, hitBoxStart.x), SnapshotFieldType::Float },
+	{ "mSpriteHandler->mHitBoxStart.y", offsetof(PlayerSnapshot, hitBoxStart.y), SnapshotFieldType::Float },
+	{ "mSpriteHandler->mHitBoxEnd.x", offsetof(PlayerSnapshot, hitBoxEnd.x), SnapshotFieldType::Float },
+	{ "mSpriteHandler->mHitBoxEnd.y", offsetof(PlayerSnapshot, hitBoxEnd.y), SnapshotFieldType::Float },
+	{ "mControllerState", offsetof(PlayerSnapshot, gamepad), SnapshotFieldType::Gamepad },
+	{ "mPreviousControllerState", offsetof(PlayerSnapshot, previousGamepad), SnapshotFieldType::Gamepad },
+	{ "mConnected", offsetof(PlayerSnapshot, connected), SnapshotFieldType::Bool },
+	{ "mDead", offsetof(PlayerSnapshot, dead), SnapshotFieldType::Bool },
+	{ "mBeingHit", offsetof(PlayerSnapshot, beingHit), SnapshotFieldType::Bool },
+	{ "mAttacking", offsetof(PlayerSnapshot, attacking), SnapshotFieldType::Bool },
+	{ "mUseGravity", offsetof(PlayerSnapshot, useGravity), SnapshotFieldType::Bool },
+	{ "mHitBoxActive", offsetof(PlayerSnapshot, hitBoxActive), SnapshotFieldType::Bool }
+};
+
+static const SnapshotField matchFields[] =
+{
+	{ "mPreviousControllerStates[0]", offsetof(MatchSnapshot, previousGamepads[0]), SnapshotFieldType::Gamepad },
+	{ "mPreviousControllerStates[1]", offsetof(MatchSnapshot, previousGamepads[1]), SnapshotFieldType::Gamepad },
+	{ "mPreviousControllerStates[2]", offsetof(MatchSnapshot, previousGamepads[2]), SnapshotFieldType::Gamepad },
+	{ "mPreviousControllerStates[3]", offsetof(MatchSnapshot, previousGamepads[3]), SnapshotFieldType::Gamepad },
+	{ "mRandom[0]", offsetof(MatchSnapshot, random.words[0]), SnapshotFieldType::Word },
+	{ "mRandom[1]", offsetof(MatchSnapshot, random.words[1]), SnapshotFieldType::Word },
+	{ "mRandom[2]", offsetof(MatchSnapshot, random.words[2]), SnapshotFieldType::Word },
+	{ "mRandom[3]", offsetof(MatchSnapshot, random.words[3]), SnapshotFieldType::Word },
+	{ "mTick", offsetof(MatchSnapshot, tick), SnapshotFieldType::Int },
+	{ "mPausedBy", offsetof(MatchSnapshot, pausedBy), SnapshotFieldType::Int },
+	{ "mWinner", offsetof(MatchSnapshot, winner), SnapshotFieldType::Int },
+	{ "mPaused", offsetof(MatchSnapshot, paused), SnapshotFieldType::Bool },
+	{ "mGameOver", offsetof(MatchSnapshot, gameOver), SnapshotFieldType::Bool }
+};
+
+static const int playerFieldCount = sizeof(playerFields) / sizeof(playerFields[0]);
+static const int matchFieldCount = sizeof(matchFields) / sizeof(matchFields[0]);
+static const char *desyncOption = "-desync";
+
+static bool desyncCheckRequested = false;
+static char logPaths[2][MAX_PATH];
+static MatchLogC logs[2];
+
+/*
+	Waits for enter, so what was printed can be read before the game closes.
+*/
+static void waitForEnter()
+{
+	printf("Press enter to exit.\n");
+	getchar();
+}
+
+static int getFieldSize(SnapshotFieldType::SnapshotFieldType type)
+{
+	switch (type)
+	{
+	case SnapshotFieldType::Bool:
+		return sizeof(bool);
+	case SnapshotFieldType::Scalar:
+		return sizeof(SimScalar);
+	case SnapshotFieldType::Gamepad:
+		return sizeof(XINPUT_GAMEPAD);
+	default:
+		return sizeof(int);
+	}
+}
+
+/*
+	Prints the value of a field of the snapshot at the given address. Fixed point numbers are printed with their raw value.
+*/
+static void formatField(char *text, const unsigned char *snapshot, const SnapshotField *field)
+{
+	const unsigned char *value = snapshot + field->offset;
+
+	switch (field->type)
+	{
+	case SnapshotFieldType::Bool:
+		sprintf(text, "%s", *(const bool *)value ? "true" : "false");
+		break;
+	case SnapshotFieldType::Int:
+		sprintf(text, "%d", *(const int *)value);
+		break;
+	case SnapshotFieldType::Word:
+		sprintf(text, "%08x", *(const unsigned int *)value);
+		break;
+	case SnapshotFieldType::Float:
+		sprintf(text, "%.9g", *(const float *)value);
+		break;
+	case SnapshotFieldType::Scalar:
+#ifdef FIXED_POINT_SIMULATION
+		sprintf(text, "%.9g (%08x)", toFloat(*(const SimScalar *)value), ((const SimScalar *)value)->raw);
+#else
+		sprintf(text, "%.9g", toFloat(*(const SimScalar *)value));
+#endif
+		break;
+	case SnapshotFieldType::Gamepad:
+	{
+		const XINPUT_GAMEPAD *gamepad = (const XINPUT_GAMEPAD *)value;
+
+		sprintf(text, "buttons %04x triggers %d %d left stick %d %d right stick %d %d", gamepad->wButtons, gamepad->bLeftTrigger, gamepad->bRightTrigger,
+			gamepad->sThumbLX, gamepad->sThumbLY, gamepad->sThumbRX, gamepad->sThumbRY);
+		break;
+	}
+	}
+}
+
+/*
+	Writes every field of the snapshot, a line each.
+*/
+static void dumpSnapshot(FILE *file, int tick, const MatchSnapshot *snapshot, unsigned long long hash)
+{
+	char value[128];
+
+	fprintf(file, "tick %d hash %016llx\n", tick, hash);
+
+	for (int i = 0; i < matchFieldCount; i++)
+	{
+		formatField(value, (const unsigned char *)snapshot, &matchFields[i]);
+		fprintf(file, "  %s = %s\n", matchFields[i].name, value);
+	}
+
+	for (int player = 0; player < MAX_NUMBER_OF_PLAYERS; player++)
+	{
+		for (int i = 0; i < playerFieldCount; i++)
+		{
+			formatField(value, (const unsigned char *)&snapshot->players[player], &playerFields[i]);
+			fprintf(file, "  player %d %s = %s\n", player, playerFields[i].name, value);
+		}
+	}
+}
+
+/*
+	Prints the fields that differ between the two snapshots. Returns how many differ.
+*/
+static int compareFields(const unsigned char *first, const unsigned char *second, const SnapshotField *fields, int count, int player)
+{
+	char firstValue[128];
+	char secondValue[128];
+	int differences = 0;
+
+	for (int i = 0; i < count; i++)
+	{
+		if (memcmp(first + fields[i].offset, second + fields[i].offset, getFieldSize(fields[i].type)) == 0)
+			continue;
+
+		formatField(firstValue, first, &fields[i]);
+		formatField(secondValue, second, &fields[i]);
+
+		if (player >= 0)
+			printf("  player %d %s: %s against %s\n", player, fields[i].name, firstValue, secondValue);
+		else
+			printf("  %s: %s against %s\n", fields[i].name, firstValue, secondValue);
+
+		differences++;
+	}
+
+	return differences;
+}
+
+/*
+	Plays the log from the start of its match through the given tick, keeping the hash of the state after every tick.
+	The state after the last tick is copied into the snapshot when one is given, and the states of the last DESYNC_DUMP_TICKS ticks are written to the dump when one is given.
+*/
+static void replayLog(MatchLogC *log, int lastTick, unsigned long long *hashes, MatchSnapshot *snapshot, FILE *dump)
+{
+	PlayerManagerC *match = PlayerManagerC::GetInstance();
+	MatchSnapshot state;
+
+	match->setMatchSeed(log->getHeader()->seed);
+	match->restart(&log->getHeader()->initialInput);
+
+	for (int i = 0; i <= lastTick; i++)
+	{
+		const MatchLogTick *tick = log->getTick(i);
+
+		match->tick(&tick->input, tick->milliseconds);
+
+		if (hashes != NULL)
+			hashes[i] = match->getStateHash();
+
+		if (dump != NULL && i > lastTick - DESYNC_DUMP_TICKS)
+		{
+			match->saveState(&state);
+			dumpSnapshot(dump, i, &state, match->getStateHash());
+		}
+	}
+
+	if (snapshot != NULL)
+		match->saveState(snapshot);
+}
+
+/*
+	Returns the first tick at which the hashes differ from the ones recorded in the log, or -1 if none do.
+*/
+static int findUnreproducedTick(MatchLogC *log, const unsigned long long *hashes, int count)
+{
+	for (int i = 0; i < count; i++)
+	{
+		if (hashes[i] != log->getTick(i)->hash)
+			return i;
+	}
+
+	return -1;
+}
+
+/*
+	Compares the logs and replays them up to the first tick whose hashes differ, printing what it finds.
+	Game events raised while replaying are not published, so nothing is heard or felt.
+*/
+static void checkLogs()
+{
+	const MatchLogHeader *headers[2] = { logs[0].getHeader(), logs[1].getHeader() };
+	int ticks = logs[0].getTickCount() < logs[1].getTickCount() ? logs[0].getTickCount() : logs[1].getTickCount();
+	int inputTick = -1;
+	int hashTick = -1;
+
+	printf("Comparing %s (%d ticks) with %s (%d ticks)\n", logPaths[0], logs[0].getTickCount(), logPaths[1], logs[1].getTickCount());
+
+	for (int i = 0; i < 2; i++)
+	{
+		if (headers[i]->stateBytes != sizeof(MatchSnapshot))
+		{
+			printf("%s was written by a build with a different match state and cannot be replayed by this one.\n", logPaths[i]);
+			return;
+		}
+	}
+
+	if (headers[0]->seed != headers[1]->seed || memcmp(headers[0]->characters, headers[1]->characters, sizeof(headers[0]->characters)))
+	{
+		printf("The matches were started differently, with seeds %llu and %llu or different characters.\n", headers[0]->seed, headers[1]->seed);
+		return;
+	}
+
+	if (headers[0]->fixedPoint != headers[1]->fixedPoint)
+		printf("Only one of the logs was written by a build that simulates in fixed point, so their states are not expected to match.\n");
+
+	if (memcmp(&headers[0]->initialInput, &headers[1]->initialInput, sizeof(MatchInput)))
+		inputTick = 0;
+
+	for (int i = 0; i < ticks; i++)
+	{
+		const MatchLogTick *first = logs[0].getTick(i);
+		const MatchLogTick *second = logs[1].getTick(i);
+
+		if (inputTick < 0 && (first->milliseconds != second->milliseconds || memcmp(&first->input, &second->input, sizeof(MatchInput))))
+			inputTick = i;
+
+		if (first->hash != second->hash)
+		{
+			hashTick = i;
+			break;
+		}
+	}
+
+	if (hashTick < 0)
+	{
+		printf("The hash streams agree over the %d ticks both logs have.\n", ticks);
+		return;
+	}
+
+	printf("The hash streams first differ after tick %d.\n", hashTick);
+
+	if (inputTick >= 0)
+		printf("The logs were given different input or tick lengths from tick %d, which diverges the matches.\n", inputTick);
+
+	unsigned long long *hashes[2];
+	int unreproducedTicks[2];
+	int replayTick = -1;
+
+	hashes[0] = (unsigned long long *)malloc((hashTick + 1) * sizeof(unsigned long long));
+	hashes[1] = (unsigned long long *)malloc((hashTick + 1) * sizeof(unsigned long long));
+
+	if (hashes[0] == NULL || hashes[1] == NULL)
+	{
+		printf("Not enough memory to keep the hashes of the %d ticks to replay.\n", hashTick + 1);
+		free(hashes[0]);
+		free(hashes[1]);
+		return;
+	}
+
+	GameEventManagerC::GetInstance()->setPublishing(false);
+	PlayerManagerC::GetInstance()->init();
+
+	for (int i = 0; i < 2; i++)
+	{
+		char dumpPath[MAX_PATH + 16];
+
+		sprintf(dumpPath, "%s.dump.txt", logPaths[i]);
+
+		FILE *dump = fopen(dumpPath, "w");
+
+		replayLog(&logs[i], hashTick, hashes[i], NULL, dump);
+
+		if (dump != NULL)
+			fclose(dump);
+
+		unreproducedTicks[i] = findUnreproducedTick(&logs[i], hashes[i], hashTick + 1);
+
+		if (unreproducedTicks[i] < 0)
+			printf("%s replays the way it was recorded; the states of its last ticks are in %s\n", logPaths[i], dumpPath);
+		else
+			printf("%s replays differently from the way it was recorded from tick %d; the states of its last ticks are in %s\n", logPaths[i], unreproducedTicks[i], dumpPath);
+	}
+
+	for (int i = 0; i <= hashTick && replayTick < 0; i++)
+	{
+		if (hashes[0][i] != hashes[1][i])
+			replayTick = i;
+	}
+
+	if (replayTick >= 0)
+	{
+		MatchSnapshot snapshots[2];
+
+		replayLog(&logs[0], replayTick, NULL, &snapshots[0], NULL);
+		replayLog(&logs[1], replayTick, NULL, &snapshots[1], NULL);
+
+		printf("Replayed, the matches first differ after tick %d, in:\n", replayTick);
+
+		compareFields((const unsigned char *)&snapshots[0], (const unsigned char *)&snapshots[1], matchFields, matchFieldCount, -1);
+
+		for (int player = 0; player < MAX_NUMBER_OF_PLAYERS; player++)
+			compareFields((const unsigned char *)&snapshots[0].players[player], (const unsigned char *)&snapshots[1].players[player], playerFields, playerFieldCount, player);
+	}
+	else
+	{
+		printf("Replayed, both logs give the same states through tick %d, so the divergence comes from the build or machine that recorded %s.\n",
+			hashTick, unreproducedTicks[0] >= 0 ? logPaths[0] : logPaths[1]);
+		printf("Run this check with that build and compare its state dumps with these to find the fields that differ.\n");
+	}
+
+	free(hashes[0]);
+	free(hashes[1]);
+
+	GameEventManagerC::GetInstance()->setPublishing(true);
+}
+
+/*
+	Loads the two logs named after -desync on the command line, when it is present.
+	Returns false if the option is present but a log cannot be read, after saying so.
+*/
+bool loadDesyncCheck(const char *commandLine)
+{
+	const char *option = commandLine != NULL ? strstr(commandLine, desyncOption) : NULL;
+
+	if (option == NULL)
+		return true;
+
+	if (sscanf(option + strlen(desyncOption), "%259s %259s", logPaths[0], logPaths[1]) != 2)
+	{
+		printf("Usage: -desync <log> <log>\n");
+		waitForEnter();
+		return false;
+	}
+
+	for (int i = 0; i < 2; i++)
+	{
+		if (!logs[i].load(logPaths[i]))
+		{
+			printf("Could not read the match log %s\n", logPaths[i]);
+			waitForEnter();
+			return false;
+		}
+	}
+
+	desyncCheckRequested = true;
+
+	return true;
+}
+
+bool isDesyncCheckRequested()
+{
+	return desyncCheckRequested;
+}
+
+/*
+	Picks the characters of the logged match, before the match textures are gathered.
+*/
+void prepareDesyncCheck()
+{
+	for (int i = 0; i < MAX_NUMBER_OF_PLAYERS; i++)
+		PlayerManagerC::GetInstance()->setCharacter(i, logs[0].getHeader()->characters[i]);
+}
+
+/*
+	Runs the check and waits for enter before returning, so the results can be read before the game closes.
+*/
+void runDesyncCheck()
+{
+	checkLogs();
+	waitForEnter();
+}
\ No newline at end of file
@@ -0,0 +1,18 @@
+#pragma once
+/*
+	DesyncCheck.h
+
+	A check that finds where two runs of a match diverge, run instead of the game by starting it with -desync <log> <log>.
+	It compares the hash streams of the two match logs to find the first tick whose states differ, then replays both logs up to that tick
+	and reports whether each replays the way it was recorded and which fields of which PlayerC the replayed states first differ in.
+	The full state of the last ticks replayed is written next to each log as <log>.dump.txt, so runs from two builds or machines can be compared too.
+	The match textures are loaded first, as hits depend on the collision masks of the sprite sheets. Results are printed to the console.
+*/
+
+#define DESYNC_DUMP_TICKS 8
+
+bool loadDesyncCheck(const char *commandLine);
+bool isDesyncCheckRequested();
+
+void prepareDesyncCheck();
+void runDesyncCheck();
\ No newline at end of file
@@ -0,0 +1,255 @@
+/*
+	FramePacer.cpp
+
+	This file contains the implementation for functions prototyped in FramePacer.h.
+*/
+
+#define _CRT_SECURE_NO_WARNINGS
+
+#include <windows.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include "FramePacer.h"
+
+#ifndef CREATE_WAITABLE_TIMER_HIGH_RESOLUTION
+#define CREATE_WAITABLE_TIMER_HIGH_RESOLUTION 0x00000002
+#endif
+
+static const char *frameRateOption = "-fps";
+static const char *frameStatisticsOption = "-framestats";
+static int frameRate = FRAME_PACER_DEFAULT_RATE;
+static bool frameStatisticsRequested = false;
+
+FramePacerC::FramePacerC()
+{
+	mTimer = NULL;
+	mHighResolutionTimer = false;
+}
+
+/*
+	Creates the timer frames are waited for with, and starts pacing at the given rate, or without a limit at 0.
+	Without a high resolution timer, the system timer resolution is raised to a millisecond until shutdown.
+*/
+void FramePacerC::init(int framesPerSecond)
+{
+	LARGE_INTEGER frequency;
+
+	QueryPerformanceFrequency(&frequency);
+	mFrequency = frequency.QuadPart;
+
+	mFrameCounts = framesPerSecond > 0 ? mFrequency / framesPerSecond : 0;
+	mPollCounts = 0;
+
+	if (mFrameCounts > 0 && mTimer == NULL)
+	{
+		mTimer = CreateWaitableTimerEx(NULL, NULL, CREATE_WAITABLE_TIMER_HIGH_RESOLUTION, TIMER_ALL_ACCESS);
+		mHighResolutionTimer = mTimer != NULL;
+
+		if (!mHighResolutionTimer)
+		{
+			mTimer = CreateWaitableTimer(NULL, TRUE, NULL);
+			timeBeginPeriod(1);
+
+			mPollCounts = mFrequency / 1000;
+		}
+	}
+
+	restart();
+}
+
+void FramePacerC::shutdown()
+{
+	if (mTimer == NULL)
+		return;
+
+	CloseHandle(mTimer);
+	mTimer = NULL;
+
+	if (!mHighResolutionTimer)
+		timeEndPeriod(1);
+}
+
+/*
+	Makes the next frame due now and times it from now, as after the window is created.
+*/
+void FramePacerC::restart()
+{
+	LONGLONG counter = getCounter();
+
+	mNextFrame = counter;
+	mLastFrame = counter;
+	mMillisecondRemainder = 0;
+
+	resetStatistics(counter);
+}
+
+bool FramePacerC::isFrameDue()
+{
+	return mFrameCounts == 0 || getCounter() >= mNextFrame;
+}
+
+/*
+	Waits until the next frame is due or a window message arrives, whichever is first.
+	Within the last millisecond of an ordinary timer's wait it returns at once, so the caller polls until the frame is due.
+*/
+void FramePacerC::waitForFrame()
+{
+	LONGLONG remaining = mNextFrame - getCounter();
+
+	if (remaining <= mPollCounts)
+		return;
+
+	LARGE_INTEGER dueTime;
+
+	dueTime.QuadPart = -((remaining - mPollCounts) * 10000000 / mFrequency);
+
+	if (dueTime.QuadPart == 0 || !SetWaitableTimer(mTimer, &dueTime, 0, NULL, NULL, FALSE))
+		return;
+
+	MsgWaitForMultipleObjects(1, &mTimer, FALSE, INFINITE, QS_ALLINPUT);
+}
+
+/*
+	Starts a frame, scheduling the one after it. Returns the whole milliseconds since the last frame started, carrying the fraction over to the next.
+	A frame that starts more than a frame late schedules the next a full frame from now.
+*/
+DWORD FramePacerC::beginFrame()
+{
+	LONGLONG counter = getCounter();
+	LONGLONG elapsed = counter - mLastFrame;
+	LONGLONG milliseconds = (elapsed * 1000 + mMillisecondRemainder) / mFrequency;
+
+	mMillisecondRemainder = (elapsed * 1000 + mMillisecondRemainder) % mFrequency;
+	mLastFrame = counter;
+
+	if (mFrameCounts > 0)
+	{
+		mNextFrame += mFrameCounts;
+
+		if (mNextFrame <= counter)
+		{
+			mNextFrame = counter + mFrameCounts;
+			mLateFrames++;
+		}
+	}
+
+	double seconds = (double)elapsed / mFrequency;
+
+	mFrames++;
+	mFrameSeconds += seconds;
+	mFrameSquaredSeconds += seconds * seconds;
+
+	if (seconds > mWorstFrameSeconds)
+		mWorstFrameSeconds = seconds;
+
+	return (DWORD)milliseconds;
+}
+
+/*
+	Ends a frame, noting whether it was drawn, and prints the frame statistics when they are asked for and due.
+*/
+void FramePacerC::endFrame(bool drawn)
+{
+	if (drawn)
+		mDrawnFrames++;
+
+	LONGLONG counter = getCounter();
+
+	if (frameStatisticsRequested && counter - mReportStart >= FRAME_PACER_REPORT_SECONDS * mFrequency)
+	{
+		report(counter);
+		resetStatistics(counter);
+	}
+}
+
+/* Private functions */
+LONGLONG FramePacerC::getCounter()
+{
+	LARGE_INTEGER counter;
+
+	QueryPerformanceCounter(&counter);
+
+	return counter.QuadPart;
+}
+
+/*
+	Returns the CPU time the game has used in user and kernel mode, in 100 nanosecond units.
+*/
+ULONGLONG FramePacerC::getProcessTime()
+{
+	FILETIME creationTime, exitTime, kernelTime, userTime;
+	ULARGE_INTEGER kernel, user;
+
+	if (!GetProcessTimes(GetCurrentProcess(), &creationTime, &exitTime, &kernelTime, &userTime))
+		return 0;
+
+	kernel.LowPart = kernelTime.dwLowDateTime;
+	kernel.HighPart = kernelTime.dwHighDateTime;
+	user.LowPart = userTime.dwLowDateTime;
+	user.HighPart = userTime.dwHighDateTime;
+
+	return kernel.QuadPart + user.QuadPart;
+}
+
+void FramePacerC::resetStatistics(LONGLONG counter)
+{
+	mFrames = 0;
+	mDrawnFrames = 0;
+	mLateFrames = 0;
+
+	mFrameSeconds = 0.0;
+	mFrameSquaredSeconds = 0.0;
+	mWorstFrameSeconds = 0.0;
+
+	mReportStart = counter;
+	mReportProcessTime = getProcessTime();
+}
+
+/*
+	Prints the frames run and drawn since the last report, the mean, standard deviation and worst of their frame times,
+	and the CPU time the game used as a share of one core, which includes the audio and haptics threads.
+*/
+void FramePacerC::report(LONGLONG counter)
+{
+	if (mFrames == 0)
+		return;
+
+	double seconds = (double)(counter - mReportStart) / mFrequency;
+	double cpuSeconds = (double)(getProcessTime() - mReportProcessTime) / 10000000.0;
+	double mean = mFrameSeconds / mFrames;
+	double variance = mFrameSquaredSeconds / mFrames - mean * mean;
+
+	printf("%d frames, %d drawn, %d late: frame time %.2f ms mean, %.2f ms standard deviation, %.2f ms worst; CPU %.1f%% of a core\n",
+		mFrames, mDrawnFrames, mLateFrames, mean * 1000.0, sqrt(variance > 0.0 ? variance : 0.0) * 1000.0, mWorstFrameSeconds * 1000.0,
+		cpuSeconds * 100.0 / seconds);
+}
+
+/*
+	Reads -fps <rate> and -framestats from the command line. The rate is limited to FRAME_PACER_MAX_RATE.
+*/
+void requestFramePacing(const char *commandLine)
+{
+	const char *option = commandLine != NULL ? strstr(commandLine, frameRateOption) : NULL;
+
+	if (option != NULL)
+	{
+		frameRate = atoi(option + strlen(frameRateOption));
+
+		if (frameRate < 0)
+			frameRate = 0;
+		else if (frameRate > FRAME_PACER_MAX_RATE)
+			frameRate = FRAME_PACER_MAX_RATE;
+	}
+
+	frameStatisticsRequested = commandLine != NULL && strstr(commandLine, frameStatisticsOption) != NULL;
+}
+
+/*
+	Returns the frame rate the main loop is paced to, or 0 when it runs as fast as it can.
+*/
+int getFrameRate()
+{
+	return frameRate;
+}
\ No newline at end of file
@@ -0,0 +1,67 @@
+#pragma once
+/*
+	FramePacer.h
+
+	Paces the main loop to a target frame rate by sleeping until each frame is due instead of spinning on the message queue.
+	The wait is on a high resolution waitable timer where Windows has one, and otherwise on an ordinary timer with the system timer resolution raised to
+	a millisecond, finishing the last millisecond by polling. Window messages end a wait early, so the window stays responsive.
+	A frame that starts late moves the frames after it rather than running several at once to catch up.
+	Frames are timed with the performance counter, and the milliseconds handed to the update carry their fractions over, so a 60 Hz frame is 16 or 17 ms.
+	Starting the game with -fps <rate> sets the target, FRAME_PACER_DEFAULT_RATE by default; -fps 0 runs frames as fast as possible.
+	-framestats prints the CPU usage of the game and the mean, standard deviation and worst of its frame times every FRAME_PACER_REPORT_SECONDS.
+*/
+
+#include <windows.h>
+
+#define FRAME_PACER_DEFAULT_RATE 60
+#define FRAME_PACER_MAX_RATE 1000
+#define FRAME_PACER_REPORT_SECONDS 10
+
+class FramePacerC
+{
+public:
+	/* Public functions */
+	FramePacerC();
+	~FramePacerC() {};
+
+	void init(int framesPerSecond);
+	void shutdown();
+	void restart();
+	bool isFrameDue();
+	void waitForFrame();
+	DWORD beginFrame();
+	void endFrame(bool drawn);
+
+private:
+	/* Private functions */
+	LONGLONG getCounter();
+	ULONGLONG getProcessTime();
+	void resetStatistics(LONGLONG counter);
+	void report(LONGLONG counter);
+
+	/* Private data members */
+	HANDLE mTimer;
+
+	bool mHighResolutionTimer;
+
+	LONGLONG mFrequency;
+	LONGLONG mFrameCounts;
+	LONGLONG mPollCounts;
+	LONGLONG mNextFrame;
+	LONGLONG mLastFrame;
+	LONGLONG mMillisecondRemainder;
+
+	int mFrames;
+	int mDrawnFrames;
+	int mLateFrames;
+
+	double mFrameSeconds;
+	double mFrameSquaredSeconds;
+	double mWorstFrameSeconds;
+
+	LONGLONG mReportStart;
+	ULONGLONG mReportProcessTime;
+};
+
+void requestFramePacing(const char *commandLine);
+int getFrameRate();
\ No newline at end of file
@@ -0,0 +1,308 @@
+/*
+	GameEventManager.cpp
+
+	This file contains the implementation for the GameEventQueueC ring buffer and the GameEventManagerC singleton class.
+*/
+
+#include "GameEventManager.h"
+#include "LatencyMonitor.h"
+
+GameEventManagerC* GameEventManagerC::sInstance = NULL;
+
+/*
+	Returns whether an event of the type is raised by a player pressing something, rather than by the match.
+*/
+static bool isRaisedByInput(GameEventType::GameEventType type)
+{
+	switch (type)
+	{
+	case GameEventType::Jumped:
+	case GameEventType::Dashed:
+	case GameEventType::Attacked:
+	case GameEventType::SpecialUsed:
+	case GameEventType::Dodged:
+	case GameEventType::Taunted:
+		return true;
+	default:
+		return false;
+	}
+}
+
+/* GameEventQueueC */
+GameEventQueueC::GameEventQueueC()
+{
+	mHead.store(0);
+	mTail.store(0);
+}
+
+/*
+	Called from the producer thread only.
+	The slot is written before the tail is published so the consumer never sees a partially written event.
+*/
+bool GameEventQueueC::push(const GameEvent &event)
+{
+	unsigned int tail = mTail.load(std::memory_order_relaxed);
+	unsigned int head = mHead.load(std::memory_order_acquire);
+
+	if (tail - head >= GAME_EVENT_QUEUE_SIZE)
+		return false;
+
+	mEvents[tail % GAME_EVENT_QUEUE_SIZE] = event;
+	mTail.store(tail + 1, std::memory_order_release);
+
+	return true;
+}
+
+/*
+	Called from the consumer thread only.
+	Returns false when there are no events waiting.
+*/
+bool GameEventQueueC::pop(GameEvent *event)
+{
+	unsigned int head = mHead.load(std::memory_order_relaxed);
+	unsigned int tail = mTail.load(std::memory_order_acquire);
+
+	if (head == tail)
+		return false;
+
+	*event = mEvents[head % GAME_EVENT_QUEUE_SIZE];
+	mHead.store(head + 1, std::memory_order_release);
+
+	return true;
+}
+
+/* GameEventManagerC public functions */
+GameEventManagerC* GameEventManagerC::CreateInstance()
+{
+	if (sInstance == NULL)
+		sInstance = new GameEventManagerC();
+
+	return sInstance;
+}
+
+/*
+	Creates the auto-reset events used to wake the consumer threads once a tick has been published.
+*/
+void GameEventManagerC::init()
+{
+	mTick = 0;
+	mPendingCount = 0;
+	mDroppedEvents = 0;
+	mPublishing = true;
+	mBatching = false;
+
+	ZeroMemory(mInputSeconds, sizeof(mInputSeconds));
+
+	mAudioSignal = CreateEvent(NULL, FALSE, FALSE, NULL);
+	mHapticsSignal = CreateEvent(NULL, FALSE, FALSE, NULL);
+}
+
+void GameEventManagerC::shutdown()
+{
+	CloseHandle(mAudioSignal);
+	CloseHandle(mHapticsSignal);
+}
+
+/*
+	Starts collecting the events for a new simulation tick. During a batch the events of the ticks before are kept.
+*/
+void GameEventManagerC::beginTick()
+{
+	mTick++;
+
+	if (!mBatching)
+		mPendingCount = 0;
+}
+
+/*
+	Records an event for the current tick.
+	An event identical to one already raised this tick is ignored, so a sound triggered twice in one update only plays once.
+*/
+void GameEventManagerC::emit(GameEventType::GameEventType type, int playerId, const CharacterDefinition *character, int animationIndex, float pan, int duration)
+{
+	GameEvent event;
+	event.type = type;
+	event.playerId = playerId;
+	event.character = character;
+	event.animationIndex = animationIndex;
+	event.duration = duration;
+	event.pan = pan;
+	event.tick = mTick;
+	event.inputSeconds = isRaisedByInput(type) && playerId >= 0 && playerId < XUSER_MAX_COUNT ? mInputSeconds[playerId] : 0.0;
+
+	if (isDuplicate(event))
+		return;
+
+	if (mPendingCount >= MAX_EVENTS_PER_TICK)
+	{
+		mDroppedEvents++;
+		return;
+	}
+
+	mPendingEvents[mPendingCount++] = event;
+}
+
+/*
+	Publishes the events of the current tick, unless a batch is collecting them. The input times apply to that tick only.
+*/
+void GameEventManagerC::endTick()
+{
+	if (!mBatching)
+		publish();
+
+	ZeroMemory(mInputSeconds, sizeof(mInputSeconds));
+}
+
+/*
+	Publishes a single event at once, outside the ticks of the simulation, as the menus do for their sounds.
+	Like endTick, it is only called from the update thread, which is the one producer of the queues.
+*/
+void GameEventManagerC::post(GameEventType::GameEventType type, int playerId, int animationIndex)
+{
+	GameEvent event;
+	event.type = type;
+	event.playerId = playerId;
+	event.character = NULL;
+	event.animationIndex = animationIndex;
+	event.duration = 0;
+	event.pan = 0.0f;
+	event.tick = mTick;
+	event.inputSeconds = 0.0;
+
+	if (!mAudioQueue.push(event))
+		mDroppedEvents++;
+
+	if (!mHapticsQueue.push(event))
+		mDroppedEvents++;
+
+	SetEvent(mAudioSignal);
+	SetEvent(mHapticsSignal);
+}
+
+/*
+	Turns publishing on or off, for ticks that are simulated without being played, such as replaying a match to check it.
+*/
+void GameEventManagerC::setPublishing(bool publishing)
+{
+	mPublishing = publishing;
+}
+
+/*
+	Returns whether the ticks being simulated are played, so their effects outside the events, such as leaving the match, should happen.
+*/
+bool GameEventManagerC::isPublishing()
+{
+	return mPublishing;
+}
+
+/*
+	Returns the tick events are stamped with, which advances with every simulated tick.
+*/
+DWORD GameEventManagerC::getTick()
+{
+	return mTick;
+}
+
+/*
+	Puts the tick events are stamped with back, after ticks that were simulated and then undone, such as those run ahead of the match.
+*/
+void GameEventManagerC::setTick(DWORD tick)
+{
+	mTick = tick;
+}
+
+/*
+	Sets the time each player's controller was sampled for the input of the next tick, so the events the input raises carry it.
+*/
+void GameEventManagerC::setInputTimes(const double *inputSeconds)
+{
+	CopyMemory(mInputSeconds, inputSeconds, sizeof(mInputSeconds));
+}
+
+/*
+	Starts collecting the events of the ticks that follow into one batch, so a sound raised on several of them only plays once.
+	The batch holds at most MAX_EVENTS_PER_TICK events; the rest are dropped.
+*/
+void GameEventManagerC::beginBatch()
+{
+	mBatching = true;
+	mPendingCount = 0;
+}
+
+/*
+	Publishes the batch.
+*/
+void GameEventManagerC::endBatch()
+{
+	mBatching = false;
+	publish();
+}
+
+GameEventQueueC* GameEventManagerC::getAudioQueue()
+{
+	return &mAudioQueue;
+}
+
+GameEventQueueC* GameEventManagerC::getHapticsQueue()
+{
+	return &mHapticsQueue;
+}
+
+HANDLE GameEventManagerC::getAudioSignal()
+{
+	return mAudioSignal;
+}
+
+HANDLE GameEventManagerC::getHapticsSignal()
+{
+	return mHapticsSignal;
+}
+
+/* Private functions */
+bool GameEventManagerC::isDuplicate(const GameEvent &event)
+{
+	for (int i = 0; i < mPendingCount; i++)
+	{
+		GameEvent *pending = &mPendingEvents[i];
+
+		if (pending->type == event.type && pending->playerId == event.playerId && pending->animationIndex == event.animationIndex)
+		{
+			if (event.duration > pending->duration)
+				pending->duration = event.duration;
+
+			return true;
+		}
+	}
+
+	return false;
+}
+
+/*
+	Publishes the pending events to the consumer queues and wakes the consumer threads.
+	Events that do not fit in a full queue are dropped rather than stalling the simulation.
+	While publishing is turned off the events are discarded instead.
+*/
+void GameEventManagerC::publish()
+{
+	if (!mPublishing)
+		mPendingCount = 0;
+
+	if (mPendingCount == 0)
+		return;
+
+	for (int i = 0; i < mPendingCount; i++)
+	{
+		LatencyMonitorC::GetInstance()->markInput(mPendingEvents[i].inputSeconds);
+
+		if (!mAudioQueue.push(mPendingEvents[i]))
+			mDroppedEvents++;
+
+		if (!mHapticsQueue.push(mPendingEvents[i]))
+			mDroppedEvents++;
+	}
+
+	mPendingCount = 0;
+
+	SetEvent(mAudioSignal);
+	SetEvent(mHapticsSignal);
+}
\ No newline at end of file
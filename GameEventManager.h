@@ -0,0 +1,141 @@
+#pragma once
+/*
+	GameEventManager.h
+
+	This is a singleton class that collects the typed game events emitted by the simulation during a tick.
+	At the end of each tick the events are deduplicated and published to lock-free queues read by the audio and haptics threads,
+	so the update path never has to wait on a sound or a controller call.
+	When many ticks run in one update, as when fast-forwarding a replay, their events can be batched and published once, deduplicated across the ticks.
+	Events a player raises by pressing something carry the time their controller was sampled, and are handed to the LatencyMonitorC as they are published.
+*/
+
+#include <windows.h>
+#include <Xinput.h>
+#include <atomic>
+
+#define GAME_EVENT_QUEUE_SIZE 128
+#define MAX_EVENTS_PER_TICK 32
+#define CACHE_LINE_SIZE 64
+
+/*
+	Enumeration used to represent the type of event the simulation has produced.
+	Hit carries the damage delay of the hit in its duration, so listeners take the invulnerability that follows a hit from it;
+	Invulnerable is only raised for the I-frames of other moves, so a single state change never produces both.
+	Cued is raised by the sound event of a move's track, on the frame the move plays its sound.
+	MenuSound is raised by the menus and the pause menu, so menu sounds reach the audio thread in order with the rest.
+*/
+namespace GameEventType
+{
+	enum GameEventType { Invalid, Landed, Jumped, Dashed, Attacked, SpecialUsed, Dodged, Taunted, Hit, Invulnerable, KO, Cued, MenuSound, MaxType };
+}
+
+/*
+	The sound a MenuSound event plays, carried in its animation index.
+*/
+namespace MenuSound
+{
+	enum MenuSound { Open, Select, Close, Win, Count };
+}
+
+struct CharacterDefinition;
+
+/*
+	A single event raised by a player during a simulation tick.
+	The animation index selects the sound of the player's character to play, the duration is used by events that keep the controller rumbling.
+	Pan places the sound between the left (-1) and right (1) edges of the stage.
+	The input time is when the controller whose press raised the event was sampled, in performance counter seconds, or zero.
+*/
+struct GameEvent
+{
+	GameEventType::GameEventType type;
+	int playerId;
+	const CharacterDefinition *character;
+	int animationIndex;
+	int duration;
+	float pan;
+	DWORD tick;
+	double inputSeconds;
+};
+
+/*
+	Fixed-size ring buffer with exactly one producer thread and one consumer thread.
+	Neither side ever blocks, a push onto a full queue drops the event and reports failure.
+*/
+class GameEventQueueC
+{
+public:
+	/* Public functions */
+	GameEventQueueC();
+
+	bool push(const GameEvent &event);
+	bool pop(GameEvent *event);
+
+private:
+	/* Private data members */
+	GameEvent mEvents[GAME_EVENT_QUEUE_SIZE];
+
+	std::atomic<unsigned int> mHead;
+	char mHeadPadding[CACHE_LINE_SIZE - sizeof(std::atomic<unsigned int>)];
+
+	std::atomic<unsigned int> mTail;
+	char mTailPadding[CACHE_LINE_SIZE - sizeof(std::atomic<unsigned int>)];
+};
+
+class GameEventManagerC
+{
+public:
+	/* Public functions */
+	static GameEventManagerC *CreateInstance();
+	static GameEventManagerC *GetInstance() { return sInstance; };
+	~GameEventManagerC() {};
+
+	void init();
+	void shutdown();
+	void beginTick();
+	void emit(GameEventType::GameEventType type, int playerId, const CharacterDefinition *character, int animationIndex, float pan, int duration = 0);
+	void endTick();
+	void post(GameEventType::GameEventType type, int playerId, int animationIndex);
+	void setPublishing(bool publishing);
+	bool isPublishing();
+	void setInputTimes(const double *inputSeconds);
+	DWORD getTick();
+	void setTick(DWORD tick);
+	void beginBatch();
+	void endBatch();
+
+	GameEventQueueC *getAudioQueue();
+	GameEventQueueC *getHapticsQueue();
+
+	HANDLE getAudioSignal();
+	HANDLE getHapticsSignal();
+
+	/* Public data members */
+	int mDroppedEvents;
+
+private:
+	/* Private functions */
+	GameEventManagerC() {};
+
+	bool isDuplicate(const GameEvent &event);
+	void publish();
+
+	/* Private data members */
+	static GameEventManagerC *sInstance;
+
+	DWORD mTick;
+
+	bool mPublishing;
+	bool mBatching;
+
+	double mInputSeconds[XUSER_MAX_COUNT];
+
+	int mPendingCount;
+
+	GameEvent mPendingEvents[MAX_EVENTS_PER_TICK];
+
+	GameEventQueueC mAudioQueue;
+	GameEventQueueC mHapticsQueue;
+
+	HANDLE mAudioSignal;
+	HANDLE mHapticsSignal;
+};
\ No newline at end of file
@@ -0,0 +1,179 @@
+/*
+	HapticsManager.cpp
+
+	This file contains the implementation for functions prototyped in the HapticsManager.h singleton class: HapticsManagerC.
+*/
+
+#include "HapticsManager.h"
+
+HapticsManagerC* HapticsManagerC::sInstance = NULL;
+
+/* Public functions */
+HapticsManagerC* HapticsManagerC::CreateInstance()
+{
+	if (sInstance == NULL)
+		sInstance = new HapticsManagerC();
+
+	return sInstance;
+}
+
+/*
+	Starts the haptics thread. The GameEventManagerC singleton must be initialized first.
+*/
+void HapticsManagerC::init()
+{
+	for (int i = 0; i < MAX_NUMBER_OF_PLAYERS; i++)
+	{
+		mRumbling[i] = false;
+		mRumbleEnd[i] = 0;
+	}
+
+	mStopRequested.store(false);
+	mRunning.store(true);
+
+	mThread = CreateThread(NULL, 0, hapticsThreadProc, this, 0, NULL);
+}
+
+/*
+	Stops the haptics thread and makes sure no controller is left vibrating.
+*/
+void HapticsManagerC::shutdown()
+{
+	mRunning.store(false);
+	SetEvent(GameEventManagerC::GetInstance()->getHapticsSignal());
+
+	WaitForSingleObject(mThread, INFINITE);
+	CloseHandle(mThread);
+
+	for (int i = 0; i < MAX_NUMBER_OF_PLAYERS; i++)
+		stopRumble(i);
+}
+
+/*
+	Asks the haptics thread to stop every controller at its next wake up.
+*/
+void HapticsManagerC::stopAll()
+{
+	mStopRequested.store(true);
+	SetEvent(GameEventManagerC::GetInstance()->getHapticsSignal());
+}
+
+/* Private functions */
+DWORD WINAPI HapticsManagerC::hapticsThreadProc(LPVOID parameter)
+{
+	((HapticsManagerC *)parameter)->run();
+
+	return 0;
+}
+
+/*
+	Sleeps until events are published or the next rumble expires, then applies the events to the controllers.
+*/
+void HapticsManagerC::run()
+{
+	GameEventQueueC *queue = GameEventManagerC::GetInstance()->getHapticsQueue();
+	HANDLE signal = GameEventManagerC::GetInstance()->getHapticsSignal();
+	DWORD timeout = INFINITE;
+
+	while (mRunning.load())
+	{
+		WaitForSingleObject(signal, timeout);
+
+		GameEvent event;
+
+		while (queue->pop(&event))
+			handleEvent(event);
+
+		if (mStopRequested.exchange(false))
+		{
+			for (int i = 0; i < MAX_NUMBER_OF_PLAYERS; i++)
+				stopRumble(i);
+		}
+
+		timeout = expireRumbles();
+	}
+}
+
+/*
+	Hits and the invulnerability frames of other moves keep the controller rumbling for their duration, a knock out stops it immediately.
+*/
+void HapticsManagerC::handleEvent(const GameEvent &event)
+{
+	if (event.playerId < 0 || event.playerId >= MAX_NUMBER_OF_PLAYERS)
+		return;
+
+	switch (event.type)
+	{
+	case GameEventType::Hit:
+	case GameEventType::Invulnerable:
+		startRumble(event.playerId, event.duration);
+		break;
+	case GameEventType::KO:
+		stopRumble(event.playerId);
+		break;
+	default:
+		break;
+	}
+}
+
+void HapticsManagerC::startRumble(int playerId, int duration)
+{
+	if (duration <= 0)
+		return;
+
+	DWORD end = GetTickCount() + duration;
+
+	if (!mRumbling[playerId] || (int)(end - mRumbleEnd[playerId]) > 0)
+		mRumbleEnd[playerId] = end;
+
+	if (!mRumbling[playerId])
+	{
+		mRumbling[playerId] = true;
+		vibrate(playerId, leftVibration, rightVibration);
+	}
+}
+
+void HapticsManagerC::stopRumble(int playerId)
+{
+	mRumbling[playerId] = false;
+	vibrate(playerId, 0, 0);
+}
+
+/*
+	Sets the vibration motors on the given player's controller.
+*/
+void HapticsManagerC::vibrate(int playerId, int leftVal, int rightVal)
+{
+	XINPUT_VIBRATION vibration;
+
+	ZeroMemory(&vibration, sizeof(XINPUT_VIBRATION));
+
+	vibration.wLeftMotorSpeed = leftVal;
+	vibration.wRightMotorSpeed = rightVal;
+
+	XInputSetState(playerId, &vibration);
+}
+
+/*
+	Stops any rumble whose time is up and returns how long the thread may sleep before the next one ends.
+*/
+DWORD HapticsManagerC::expireRumbles()
+{
+	DWORD now = GetTickCount();
+	DWORD timeout = INFINITE;
+
+	for (int i = 0; i < MAX_NUMBER_OF_PLAYERS; i++)
+	{
+		if (!mRumbling[i])
+			continue;
+
+		int remaining = (int)(mRumbleEnd[i] - now);
+
+		if (remaining <= 0)
+			stopRumble(i);
+		else if ((DWORD)remaining < timeout)
+			timeout = remaining;
+	}
+
+	return timeout;
+}
\ No newline at end of file
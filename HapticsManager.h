@@ -0,0 +1,56 @@
+#pragma once
+/*
+	HapticsManager.h
+
+	This is a singleton class that owns the controller rumble motors.
+	It runs on its own thread, reading the game events published by the GameEventManagerC so that XInputSetState is never called from the simulation.
+*/
+
+#include <windows.h>
+#include <Xinput.h>
+#include <atomic>
+#include "GameEventManager.h"
+#include "PlayerManager.h"
+
+class HapticsManagerC
+{
+public:
+	/* Public functions */
+	static HapticsManagerC *CreateInstance();
+	static HapticsManagerC *GetInstance() { return sInstance; };
+	~HapticsManagerC() {};
+
+	void init();
+	void shutdown();
+	void stopAll();
+
+private:
+	/* Private functions */
+	HapticsManagerC() {};
+
+	static DWORD WINAPI hapticsThreadProc(LPVOID parameter);
+
+	void run();
+	void handleEvent(const GameEvent &event);
+	void startRumble(int playerId, int duration);
+	void stopRumble(int playerId);
+	void vibrate(int playerId, int leftVal, int rightVal);
+
+	DWORD expireRumbles();
+
+	/* Private data members */
+	static HapticsManagerC *sInstance;
+
+	std::atomic<bool> mRunning;
+	std::atomic<bool> mStopRequested;
+
+	bool mRumbling[MAX_NUMBER_OF_PLAYERS];
+
+	DWORD mRumbleEnd[MAX_NUMBER_OF_PLAYERS];
+
+	HANDLE mThread;
+
+	/* Private constant data */
+	const int leftVibration = 16000;
+	const int rightVibration = 8000;
+};
\ No newline at end of file
@@ -0,0 +1,268 @@
+/*
+	Kirby.cpp
+
+	This file contains the definition of Kirby: its animation tables, move timelines and sounds.
+*/
+
+#include <stddef.h>
+#include "Character.h"
+
+static const CharacterMoves kirbyMoves =
+{
+	{
+		0,0,1,1,2,2,
+		2,3,3,4,4,5,
+		5,6,6,7,7,8,
+		8,9,9,10,10,11,
+		11,12,12,13,14,15,
+		15,16,16
+	},
+
+	{
+		false,true,false,true,false,false,
+		true,false,true,false,true,false,
+		true,false,true,false,true,false,
+		true,false,true,false,true,false,
+		true,false,true,false,false,false,
+		true,false,true
+	},
+
+	/*
+		Horizontal shift in pixels of each mirrored cell, matching where the left-facing art sat in the original two-facing sheets.
+	*/
+	{
+		0,0,0,2.0f,0,0,
+		0,0,5.0f,0,4.0f,0,
+		1.0f,0,0,0,2.0f,0,
+		1.0f,0,1.0f,0,2.0f,0,
+		-1.0f,0,0,0,0,0,
+		1.0f,0,1.0f
+	},
+
+	/*
+		Horizontal hitbox extents are given for the cell as it is stored in the sprite sheet and are mirrored along with the cell.
+		These boxes keep the player inside the stage; hits are found with the hurtboxes and hitboxes of the move timelines.
+	*/
+	{
+		28.0f,28.0f,28.0f,28.0f,28.0f,28.0f,
+		28.0f,28.0f,28.0f,14.0f,14.0f,-3.0f,
+		-3.0f,28.0f,28.0f,80.0f,80.0f,28.0f,
+		28.0f,14.0f,14.0f,28.0f,28.0f,28.0f,
+		28.0f,28.0f,28.0f,28.0f,28.0f,40.0f,
+		40.0f,28.0f,28.0f
+	},
+
+	{
+		-55.0f,-55.0f,-55.0f,-55.0f,-55.0f,-55.0f,
+		-55.0f,-55.0f,-55.0f,-30.0f,-30.0f,-55.0f,
+		-55.0f,-55.0f,-55.0f,-55.0f,-55.0f,-55.0f,
+		-55.0f,-25.0f,-25.0f,-55.0f,-55.0f,-55.0f,
+		-55.0f,-55.0f,-55.0f,-55.0f,-55.0f,-20.0f,
+		-20.0f,-55.0f,-55.0f
+	},
+
+	{
+		115.0f,115.0f,115.0f,115.0f,115.0f,115.0f,
+		115.0f,115.0f,115.0f,129.0f,129.0f,146.0f,
+		146.0f,115.0f,115.0f,160.0f,160.0f,160.0f,
+		160.0f,129.0f,129.0f,115.0f,115.0f,115.0f,
+		115.0f,115.0f,115.0f,115.0f,115.0f,160.0f,
+		160.0f,180.0f,180.0f
+	},
+
+	{
+		-144.0f,-144.0f,-144.0f,-144.0f,-144.0f,-144.0f,
+		-144.0f,-144.0f,-144.0f,-144.0f,-144.0f,-144.0f,
+		-144.0f,-144.0f,-144.0f,-144.0f,-144.0f,-144.0f,
+		-144.0f,-114.0f,-114.0f,-144.0f,-144.0f,-144.0f,
+		-144.0f,-144.0f,-144.0f,-144.0f,-144.0f,-124.0f,
+		-124.0f,-134.0f,-134.0f
+	},
+
+	{
+		0,0,0,0,0,0,
+		0,0,0,500,500,450,
+		450,600,600,800,800,400,
+		400,300,300,300,300,400,
+		400,300,300,500,1000,1000,
+		1000,1000,1000
+	},
+
+	{
+		100,100,100,100,100,100,
+		100,50,50,100,100,70,
+		70,50,50,100,100,100,
+		100,70,70,50,50,70,
+		70,70,70,100,100,70,
+		70,70,70
+	},
+
+	{
+		0,0,0,0,0,0,
+		0,0,0,0,0,0,
+		0,0,0,0,0,0,
+		0,0,0,1000,1000,0,
+		0,0,0,0,1000,1000,
+		1000,0,0
+	}
+};
+
+static const CharacterSounds kirbySounds =
+{
+	{
+		"snd_se_Kirby_Landing02","snd_se_Kirby_Landing02","","","","",
+		"","","","","","",
+		"","","","","","",
+		"","","","snd_vc_kirby_Damage02","snd_vc_kirby_Damage02","",
+		"","","","snd_vc_kirby_Appeal03","","",
+		"","",""
+	},
+
+	{
+		"snd_se_Kirby_Landing02","snd_se_Kirby_Landing02","","","","snd_se_Kirby_jump01",
+		"snd_se_Kirby_jump01","snd_se_Kirby_dash_start","snd_se_Kirby_dash_start","snd_se_Kirby_smash_H01","snd_se_Kirby_smash_H01","snd_se_Kirby_smash_L01",
+		"snd_se_Kirby_smash_L01","snd_se_Kirby_AttackDash","snd_se_Kirby_AttackDash","snd_se_Kirby_Attack100","snd_se_Kirby_Attack100","snd_se_Kirby_smash_S01",
+		"snd_se_Kirby_smash_S01","snd_se_Kirby_AttackAir_L01","snd_se_Kirby_AttackAir_L01","","","snd_se_Kirby_Escape",
+		"snd_se_Kirby_Escape","","","","snd_se_Kirby_Special_S01","snd_se_Kirby_Special_C3_H01",
+		"snd_se_Kirby_Special_C3_H01","snd_se_Kirby_swing_l","snd_se_Kirby_swing_l"
+	}
+};
+
+#define N NO_MOVE_BOX
+
+/*
+	Hurtboxes first, then the hitboxes of each active frame in the order of the sprite sheet columns.
+*/
+static const MoveBox kirbyMoveBoxes[] =
+{
+	{ 28, -55, 115, -144 },
+	{ 14, -30, 129, -144 },
+	{ 28, -84, 115, -144 },
+	{ 8, -55, 95, -144 },
+	{ 14, -25, 129, -114 },
+	{ 10, -20, 134, -124 },
+	{ 28, -55, 130, -144 },
+
+	{ 18, -65, 129, -110 },
+	{ 35, -18, 126, -80 },
+
+	{ 0, -100, 144, -144 },
+	{ 23, -84, 121, -144 },
+	{ 39, -100, 112, -144 },
+
+	{ 0, -13, 135, -139 },
+	{ 13, -10, 124, -140 },
+	{ 2, -4, 120, -140 },
+	{ 20, -41, 120, -108 },
+	{ 0, -36, 116, -139 },
+
+	{ 96, -71, 141, -142 },
+	{ 96, -50, 139, -142 },
+	{ 90, -74, 103, -141 },
+
+	{ 110, -71, 138, -143 },
+
+	{ 18, -27, 117, -126 },
+	{ 29, -36, 110, -115 },
+	{ 18, -16, 117, -116 },
+
+	{ 34, -80, 113, -144 },
+
+	{ 10, 0, 143, -139 },
+	{ 3, -39, 141, -117 },
+	{ 5, -3, 138, -144 },
+	{ 10, -4, 113, -139 },
+	{ 3, -43, 141, -137 },
+	{ 4, -53, 140, -129 },
+	{ 8, -14, 135, -144 },
+
+	{ 25, -54, 94, -144 },
+	{ 17, 0, 128, -144 },
+	{ 6, 0, 138, -142 }
+};
+
+/*
+	One line per sprite sheet column, from standing to the side special.
+*/
+static const MoveFrame kirbyMoveFrames[] =
+{
+	{ 0, N },
+	{ 0, N },
+	{ 0, N },
+	{ 0, N },
+	{ 1, N }, { 1, N }, { 1, 7 }, { 1, 8 }, { 1, N },
+	{ 2, N }, { 2, N }, { 2, N }, { 2, 9 }, { 2, 10 }, { 2, 11 }, { 2, N },
+	{ 0, N }, { 0, N }, { 0, N }, { 0, 12 }, { 0, 13 }, { 0, 14 }, { 0, 15 }, { 0, 16 }, { 0, N }, { 0, N }, { 0, N },
+	{ 3, N }, { 3, N }, { 3, 17 }, { 3, N }, { 3, 18 }, { 3, N }, { 3, 19 }, { 3, N },
+	{ 0, N }, { 0, N }, { 0, 20 }, { 0, N },
+	{ 4, N }, { 4, 21 }, { 4, 22 }, { 4, 23 }, { 4, N },
+	{ 0, N },
+	{ 0, N },
+	{ 0, N },
+	{ 0, N },
+	{ 2, N }, { 2, N }, { 2, 24 }, { 2, 24 }, { 2, 24 }, { 2, 24 }, { 2, 24 }, { 2, 24 }, { 2, 24 }, { 2, 24 }, { 2, 24 },
+	{ 5, N }, { 5, N }, { 5, 25 }, { 5, 26 }, { 5, 27 }, { 5, 28 }, { 5, 29 }, { 5, 30 }, { 5, 31 }, { 5, N }, { 5, N },
+	{ 6, N }, { 6, N }, { 6, N }, { 6, N }, { 6, N }, { 6, 32 }, { 6, 33 }, { 6, 34 }, { 6, N }, { 6, N }, { 6, N }
+};
+
+/*
+	The hitbox of each move is on for its active window. Attacks and the up and side specials play their sound as the hit comes out,
+	and the dash attack lunges forward as it does.
+*/
+static const MoveEvent kirbyMoveEvents[] =
+{
+	{ 2, MoveEventType::HitBoxOn, 0, 0 }, { 2, MoveEventType::Sound, 0, 0 }, { 4, MoveEventType::HitBoxOff, 0, 0 },
+	{ 3, MoveEventType::HitBoxOn, 0, 0 }, { 3, MoveEventType::Sound, 0, 0 }, { 6, MoveEventType::HitBoxOff, 0, 0 },
+	{ 3, MoveEventType::HitBoxOn, 0, 0 }, { 3, MoveEventType::Sound, 0, 0 }, { 3, MoveEventType::Impulse, 10, 0 }, { 8, MoveEventType::HitBoxOff, 0, 0 },
+	{ 2, MoveEventType::HitBoxOn, 0, 0 }, { 2, MoveEventType::Sound, 0, 0 }, { 7, MoveEventType::HitBoxOff, 0, 0 },
+	{ 2, MoveEventType::HitBoxOn, 0, 0 }, { 2, MoveEventType::Sound, 0, 0 }, { 3, MoveEventType::HitBoxOff, 0, 0 },
+	{ 1, MoveEventType::HitBoxOn, 0, 0 }, { 1, MoveEventType::Sound, 0, 0 }, { 4, MoveEventType::HitBoxOff, 0, 0 },
+	{ 2, MoveEventType::HitBoxOn, 0, 0 }, { 11, MoveEventType::HitBoxOff, 0, 0 },
+	{ 2, MoveEventType::HitBoxOn, 0, 0 }, { 2, MoveEventType::Sound, 0, 0 }, { 9, MoveEventType::HitBoxOff, 0, 0 },
+	{ 5, MoveEventType::HitBoxOn, 0, 0 }, { 5, MoveEventType::Sound, 0, 0 }, { 8, MoveEventType::HitBoxOff, 0, 0 }
+};
+
+static const MoveTimeline kirbyTimelines[] =
+{
+	{ 0, 0, 0, 0, 1, 0 },
+	{ 1, 0, 0, 0, 1, 0 },
+	{ 2, 0, 0, 0, 1, 0 },
+	{ 3, 0, 0, 0, 1, 0 },
+	{ 4, 0, 2, 2, 1, 3 },
+	{ 9, 3, 3, 3, 1, 3 },
+	{ 16, 6, 3, 5, 3, 4 },
+	{ 27, 10, 2, 5, 1, 3 },
+	{ 35, 13, 2, 1, 1, 3 },
+	{ 39, 16, 1, 3, 1, 3 },
+	{ 44, 0, 0, 0, 1, 0 },
+	{ 45, 0, 0, 0, 1, 0 },
+	{ 46, 0, 0, 0, 1, 0 },
+	{ 47, 0, 0, 0, 1, 0 },
+	{ 48, 19, 2, 9, 0, 2 },
+	{ 59, 21, 2, 7, 2, 3 },
+	{ 70, 24, 5, 3, 3, 3 }
+};
+
+#undef N
+
+static const MoveTimelineSet kirbyMoveTimelines =
+{
+	kirbyTimelines,
+	kirbyMoveFrames,
+	kirbyMoveBoxes,
+	kirbyMoveEvents,
+	sizeof(kirbyTimelines) / sizeof(kirbyTimelines[0])
+};
+
+const CharacterDefinition kirbyCharacter =
+{
+	"Kirby",
+	"SpriteSheets/KirbySpriteSheet",
+	11,
+	17,
+	144.0f,
+	144.0f,
+	&kirbyMoves,
+	&kirbyMoveTimelines,
+	&kirbySounds
+};
\ No newline at end of file
@@ -0,0 +1,152 @@
+/*
+	LatencyMonitor.cpp
+
+	This file contains the implementation for functions prototyped in the LatencyMonitorC singleton class.
+*/
+
+#define _CRT_SECURE_NO_WARNINGS
+
+#include <windows.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "LatencyMonitor.h"
+#include "RunAhead.h"
+#include "Benchmark.h"
+
+LatencyMonitorC* LatencyMonitorC::sInstance = NULL;
+
+static const char *latencyOption = "-latency";
+static bool latencyReportRequested = false;
+
+static const char *screenStateNames[ScreenState::MaxState] = { "Invalid", "StartScreen", "LoadingScreen", "ControlScreen", "GameScreen", "EndScreen" };
+
+static int compareLatencies(const void *a, const void *b)
+{
+	float first = *(const float *)a;
+	float second = *(const float *)b;
+
+	return (first > second) - (first < second);
+}
+
+/* Public functions */
+LatencyMonitorC* LatencyMonitorC::CreateInstance()
+{
+	if (sInstance == NULL)
+		sInstance = new LatencyMonitorC();
+
+	return sInstance;
+}
+
+void LatencyMonitorC::init()
+{
+	mScreenState = ScreenState::Invalid;
+	mPendingCount = 0;
+
+	ZeroMemory(mSampleCounts, sizeof(mSampleCounts));
+}
+
+/*
+	Sets the screen state the inputs marked from now on were made in.
+*/
+void LatencyMonitorC::setScreenState(ScreenState::ScreenState state)
+{
+	mScreenState = state;
+}
+
+/*
+	Marks something the input sampled at the given time did, to be closed by the next frame presented.
+	A time of zero is input that was not read from a controller, such as that of a replay, and is ignored.
+*/
+void LatencyMonitorC::markInput(double inputSeconds)
+{
+	if (!latencyReportRequested || inputSeconds <= 0.0 || mPendingCount >= LATENCY_MAX_PENDING)
+		return;
+
+	mPendingInputs[mPendingCount] = inputSeconds;
+	mPendingStates[mPendingCount] = mScreenState;
+	mPendingCount++;
+}
+
+/*
+	Called once SwapBuffers returns. Records the latency of everything marked since the last frame.
+	Once a screen state has LATENCY_MAX_SAMPLES latencies, the oldest are replaced.
+*/
+void LatencyMonitorC::framePresented()
+{
+	if (mPendingCount == 0)
+		return;
+
+	double presentedSeconds = getBenchmarkSeconds();
+
+	for (int i = 0; i < mPendingCount; i++)
+	{
+		int state = mPendingStates[i];
+
+		mSamples[state][mSampleCounts[state] % LATENCY_MAX_SAMPLES] = (float)((presentedSeconds - mPendingInputs[i]) * 1000.0);
+		mSampleCounts[state]++;
+	}
+
+	mPendingCount = 0;
+}
+
+/*
+	Prints the latency percentiles of every screen state any input was measured in, headed by the build configuration, and waits for enter.
+*/
+void LatencyMonitorC::report()
+{
+	if (!latencyReportRequested)
+		return;
+
+	printf("Input to photon latency, %s %s build, %s simulation, run-ahead of %d ticks:\n",
+#ifdef _DEBUG
+		"debug",
+#else
+		"release",
+#endif
+		sizeof(void *) == 8 ? "64 bit" : "32 bit",
+#ifdef FIXED_POINT_SIMULATION
+		"fixed point",
+#else
+		"float",
+#endif
+		getRunAheadTicks());
+
+	for (int i = 0; i < ScreenState::MaxState; i++)
+		reportScreenState(i);
+
+	printf("Press enter to exit.\n");
+	getchar();
+}
+
+/* Private functions */
+/*
+	Prints the median, 90th and 99th percentile and worst latency of a screen state, if any input was measured in it.
+*/
+void LatencyMonitorC::reportScreenState(int state)
+{
+	static float sorted[LATENCY_MAX_SAMPLES];
+	int count = mSampleCounts[state] < LATENCY_MAX_SAMPLES ? mSampleCounts[state] : LATENCY_MAX_SAMPLES;
+
+	if (count == 0)
+		return;
+
+	memcpy(sorted, mSamples[state], count * sizeof(float));
+	qsort(sorted, count, sizeof(float), compareLatencies);
+
+	printf("  %-13s %5d inputs: median %6.2f ms, 90%% %6.2f ms, 99%% %6.2f ms, worst %6.2f ms\n", screenStateNames[state], mSampleCounts[state],
+		sorted[count / 2], sorted[count * 90 / 100], sorted[count * 99 / 100], sorted[count - 1]);
+}
+
+/*
+	Turns on latency measurement if the command line asks for it with -latency.
+*/
+void requestLatencyReport(const char *commandLine)
+{
+	latencyReportRequested = commandLine != NULL && strstr(commandLine, latencyOption) != NULL;
+}
+
+bool isLatencyReportRequested()
+{
+	return latencyReportRequested;
+}
\ No newline at end of file
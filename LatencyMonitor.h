@@ -0,0 +1,53 @@
+#pragma once
+/*
+	LatencyMonitor.h
+
+	This is a singleton class that measures the time from reading a controller to swapping in the first frame that shows what the input did.
+	Controller samples are timestamped from the performance counter as they are read. The game events a player raises by pressing something,
+	and the menu changes the first controller makes, carry the time of the sample that caused them, and are closed by the time SwapBuffers returns
+	after the next frame is drawn. The latencies are kept per screen state, and when the game closes they are printed as percentiles with the build configuration.
+	Starting the game with -latency turns it on.
+	The time ends at the swap, so the display's own delay is not included, and a press can wait up to an update before it is sampled.
+*/
+
+#include "ScreenManager.h"
+
+#define LATENCY_MAX_PENDING 64
+#define LATENCY_MAX_SAMPLES 4096
+
+class LatencyMonitorC
+{
+public:
+	/* Public functions */
+	static LatencyMonitorC *CreateInstance();
+	static LatencyMonitorC *GetInstance() { return sInstance; };
+	~LatencyMonitorC() {};
+
+	void init();
+	void setScreenState(ScreenState::ScreenState state);
+	void markInput(double inputSeconds);
+	void framePresented();
+	void report();
+
+private:
+	/* Private functions */
+	LatencyMonitorC() {};
+
+	void reportScreenState(int state);
+
+	/* Private data members */
+	static LatencyMonitorC *sInstance;
+
+	ScreenState::ScreenState mScreenState;
+
+	int mPendingCount;
+
+	double mPendingInputs[LATENCY_MAX_PENDING];
+	ScreenState::ScreenState mPendingStates[LATENCY_MAX_PENDING];
+
+	int mSampleCounts[ScreenState::MaxState];
+	float mSamples[ScreenState::MaxState][LATENCY_MAX_SAMPLES];
+};
+
+void requestLatencyReport(const char *commandLine);
+bool isLatencyReportRequested();
\ No newline at end of file
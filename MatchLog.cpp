@@ -0,0 +1,183 @@
+/*
+	MatchLog.cpp
+
+	This file contains the implementation for functions prototyped in the MatchLogC class.
+*/
+
+#define _CRT_SECURE_NO_WARNINGS
+
+#include <stdlib.h>
+#include <string.h>
+#include "MatchLog.h"
+
+static const char *matchLogOption = "-matchlog";
+static char matchLogDirectory[MAX_PATH] = "";
+
+/* Public functions */
+MatchLogC::MatchLogC()
+{
+	mFile = NULL;
+	mTicks = NULL;
+	mTickCount = 0;
+
+	memset(&mHeader, 0, sizeof(mHeader));
+}
+
+MatchLogC::~MatchLogC()
+{
+	endRecording();
+	unload();
+}
+
+/*
+	Creates the log of a match in the given directory, named by the seed, and writes its header.
+	Returns false if the file cannot be created, in which case the match is not logged.
+*/
+bool MatchLogC::beginRecording(const char *directory, unsigned long long seed, const int *characters, const MatchInput *initialInput)
+{
+	char path[MAX_PATH + 32];
+
+	endRecording();
+
+	memset(&mHeader, 0, sizeof(mHeader));
+	mHeader.magic = MATCH_LOG_MAGIC;
+	mHeader.version = MATCH_LOG_VERSION;
+	mHeader.seed = seed;
+	mHeader.stateBytes = sizeof(MatchSnapshot);
+#ifdef FIXED_POINT_SIMULATION
+	mHeader.fixedPoint = 1;
+#endif
+	mHeader.initialInput = *initialInput;
+
+	for (int i = 0; i < MAX_NUMBER_OF_PLAYERS; i++)
+		mHeader.characters[i] = characters[i];
+
+	sprintf(path, "%s/match_%llu.log", directory, seed);
+
+	mFile = fopen(path, "wb");
+
+	if (mFile == NULL)
+	{
+		printf("Could not create the match log %s\n", path);
+		return false;
+	}
+
+	fwrite(&mHeader, sizeof(mHeader), 1, mFile);
+
+	return true;
+}
+
+/*
+	Appends a tick to the log being recorded.
+*/
+void MatchLogC::record(const MatchInput *input, DWORD milliseconds, unsigned long long hash)
+{
+	MatchLogTick tick;
+
+	if (mFile == NULL)
+		return;
+
+	memset(&tick, 0, sizeof(tick));
+	tick.hash = hash;
+	tick.milliseconds = milliseconds;
+	tick.input = *input;
+
+	fwrite(&tick, sizeof(tick), 1, mFile);
+}
+
+void MatchLogC::endRecording()
+{
+	if (mFile != NULL)
+		fclose(mFile);
+
+	mFile = NULL;
+}
+
+bool MatchLogC::isRecording()
+{
+	return mFile != NULL;
+}
+
+/*
+	Reads a whole log into memory. Returns false if it cannot be read or was not written by a match log.
+	A tick cut short by the game stopping while it was written is left out.
+*/
+bool MatchLogC::load(const char *path)
+{
+	unload();
+
+	FILE *file = fopen(path, "rb");
+
+	if (file == NULL)
+		return false;
+
+	fseek(file, 0, SEEK_END);
+	long size = ftell(file);
+	fseek(file, 0, SEEK_SET);
+
+	bool valid = size >= (long)sizeof(mHeader) && fread(&mHeader, sizeof(mHeader), 1, file) == 1 &&
+		mHeader.magic == MATCH_LOG_MAGIC && mHeader.version == MATCH_LOG_VERSION;
+
+	if (valid)
+	{
+		mTickCount = (int)((size - sizeof(mHeader)) / sizeof(MatchLogTick));
+		mTicks = (MatchLogTick *)malloc(mTickCount * sizeof(MatchLogTick) + 1);
+
+		valid = mTicks != NULL && (int)fread(mTicks, sizeof(MatchLogTick), mTickCount, file) == mTickCount;
+	}
+
+	fclose(file);
+
+	if (!valid)
+		unload();
+
+	return valid;
+}
+
+void MatchLogC::unload()
+{
+	free(mTicks);
+
+	mTicks = NULL;
+	mTickCount = 0;
+}
+
+const MatchLogHeader *MatchLogC::getHeader()
+{
+	return &mHeader;
+}
+
+/*
+	Returns the tick with the given index, counted from zero, or NULL past the end of the log.
+*/
+const MatchLogTick *MatchLogC::getTick(int tick)
+{
+	if (tick < 0 || tick >= mTickCount)
+		return NULL;
+
+	return &mTicks[tick];
+}
+
+int MatchLogC::getTickCount()
+{
+	return mTickCount;
+}
+
+/*
+	Turns on match logs if the command line asks for them with -matchlog <directory>.
+*/
+void requestMatchLogs(const char *commandLine)
+{
+	const char *option = commandLine != NULL ? strstr(commandLine, matchLogOption) : NULL;
+
+	if (option != NULL)
+		sscanf(option + strlen(matchLogOption), "%259s", matchLogDirectory);
+}
+
+/*
+	Returns the directory match logs are written to, or NULL when they were not asked for.
+*/
+const char *getMatchLogDirectory()
+{
+	return matchLogDirectory[0] ? matchLogDirectory : NULL;
+}
\ No newline at end of file
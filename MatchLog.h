@@ -0,0 +1,69 @@
+#pragma once
+/*
+	MatchLog.h
+
+	A log of a match for finding where two runs of it diverge, such as two replays or the two peers of a networked match.
+	It holds the seed, characters and held input the match started with, then for every tick the controller input,
+	the length of the tick and the hash of the match state after it.
+	Starting the game with -matchlog <directory> writes a log of every match into the directory, named by the match seed.
+	Ticks are written as they are simulated, so a log is complete up to its last tick even if the game stops.
+	Logs are only read by the build that wrote them; the header records the size of its match state and whether it simulates in fixed point.
+*/
+
+#include <stdio.h>
+#include "PlayerManager.h"
+
+#define MATCH_LOG_MAGIC 0x4C4D4B4B
+#define MATCH_LOG_VERSION 1
+
+struct MatchLogHeader
+{
+	unsigned int magic;
+	unsigned int version;
+	unsigned long long seed;
+	int characters[MAX_NUMBER_OF_PLAYERS];
+	unsigned int stateBytes;
+	unsigned int fixedPoint;
+	MatchInput initialInput;
+};
+
+struct MatchLogTick
+{
+	unsigned long long hash;
+	unsigned int milliseconds;
+	MatchInput input;
+};
+
+class MatchLogC
+{
+public:
+	/* Public functions */
+	MatchLogC();
+	~MatchLogC();
+
+	bool beginRecording(const char *directory, unsigned long long seed, const int *characters, const MatchInput *initialInput);
+	void record(const MatchInput *input, DWORD milliseconds, unsigned long long hash);
+	void endRecording();
+
+	bool isRecording();
+
+	bool load(const char *path);
+	void unload();
+
+	const MatchLogHeader *getHeader();
+	const MatchLogTick *getTick(int tick);
+
+	int getTickCount();
+
+private:
+	/* Private data members */
+	FILE *mFile;
+
+	MatchLogHeader mHeader;
+	MatchLogTick *mTicks;
+
+	int mTickCount;
+};
+
+void requestMatchLogs(const char *commandLine);
+const char *getMatchLogDirectory();
\ No newline at end of file
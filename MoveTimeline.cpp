@@ -0,0 +1,87 @@
+/*
+	MoveTimeline.cpp
+
+	This file contains the implementation of the functions prototyped in MoveTimeline.h.
+*/
+
+#include <stddef.h>
+#include "MoveTimeline.h"
+
+/*
+	Returns the boxes of the given frame of a column's timeline, holding the last frame once the timeline is over.
+	Returns NULL for a column without a timeline.
+*/
+const MoveFrame* getMoveFrame(const MoveTimelineSet *set, int column, int frame)
+{
+	if (column < 0 || column >= set->timelineCount)
+		return NULL;
+
+	const MoveTimeline *timeline = &set->timelines[column];
+	int frameCount = timeline->startupFrames + timeline->activeFrames + timeline->recoveryFrames;
+
+	if (frame >= frameCount)
+		frame = frameCount - 1;
+
+	if (frame < 0)
+		frame = 0;
+
+	return &set->frames[timeline->firstFrame + frame];
+}
+
+MovePhase::MovePhase getMovePhase(const MoveTimelineSet *set, int column, int frame)
+{
+	if (column < 0 || column >= set->timelineCount)
+		return MovePhase::Recovery;
+
+	const MoveTimeline *timeline = &set->timelines[column];
+
+	if (frame < timeline->startupFrames)
+		return MovePhase::Startup;
+
+	if (frame < timeline->startupFrames + timeline->activeFrames)
+		return MovePhase::Active;
+
+	return MovePhase::Recovery;
+}
+
+/*
+	Returns the events of a column's track on the given frame, setting count to how many there are. Returns NULL if there are none.
+*/
+const MoveEvent* getMoveEvents(const MoveTimelineSet *set, int column, int frame, int *count)
+{
+	*count = 0;
+
+	if (column < 0 || column >= set->timelineCount)
+		return NULL;
+
+	const MoveTimeline *timeline = &set->timelines[column];
+	const MoveEvent *events = &set->events[timeline->firstEvent];
+	int first = 0;
+
+	while (first < timeline->eventCount && events[first].frame < frame)
+		first++;
+
+	while (first + *count < timeline->eventCount && events[first + *count].frame == frame)
+		(*count)++;
+
+	return *count > 0 ? &events[first] : NULL;
+}
+
+/*
+	Returns whether a column's track has an event of the given type on any frame.
+*/
+bool hasMoveEvent(const MoveTimelineSet *set, int column, MoveEventType::MoveEventType type)
+{
+	if (column < 0 || column >= set->timelineCount)
+		return false;
+
+	const MoveTimeline *timeline = &set->timelines[column];
+
+	for (int i = 0; i < timeline->eventCount; i++)
+	{
+		if (set->events[timeline->firstEvent + i].type == type)
+			return true;
+	}
+
+	return false;
+}
\ No newline at end of file
@@ -0,0 +1,94 @@
+#pragma once
+/*
+	MoveTimeline.h
+
+	A move timeline describes, frame by frame, where a character can be hit and where its move hits others.
+	Every column of a character's sprite sheet has a timeline made of startup, active and recovery windows counted in animation frames.
+	Each frame names a hurtbox and, during the active window, an optional hitbox out of a shared table of boxes,
+	so the whole set is three small contiguous tables and a lookup is two array indexes.
+	Frames past the end of a timeline hold its last frame, so a move recovers until its animation changes.
+	Each timeline also carries a track of events keyed to exact frames: the sound of the move, its hitbox switching on and off,
+	and velocity impulses. They are raised once each as the move reaches their frame, every event of a frame together.
+*/
+
+#define NO_MOVE_BOX 0xFF
+
+/*
+	Enumeration used to represent which window of a move a frame falls in.
+*/
+namespace MovePhase
+{
+	enum MovePhase { Startup, Active, Recovery };
+}
+
+/*
+	Enumeration used to represent what an event of a move's track does.
+	A move's hitbox only hits between its HitBoxOn and HitBoxOff events, so one move can hit in several windows.
+*/
+namespace MoveEventType
+{
+	enum MoveEventType { HitBoxOn, HitBoxOff, Sound, Impulse };
+}
+
+/*
+	A box given for the cell as it is stored in the sprite sheet, like the hitboxes of PlayerC: x from the left edge of the cell
+	and y downward from its top as negative values. Boxes are mirrored along with the cell for left-facing animations.
+*/
+struct MoveBox
+{
+	short startX;
+	short startY;
+	short endX;
+	short endY;
+};
+
+/*
+	The boxes of one animation frame, as indexes into the box table. Frames without a hitbox use NO_MOVE_BOX.
+*/
+struct MoveFrame
+{
+	unsigned char hurtBox;
+	unsigned char hitBox;
+};
+
+/*
+	An event of a move's track. Impulses are added to the player's velocity, horizontally in tenths of their speed in the direction they face
+	and vertically in tenths of their jump speed. Frames count from the start of the move and may lie past the end of its timeline.
+*/
+struct MoveEvent
+{
+	unsigned char frame;
+	unsigned char type;
+
+	signed char impulseX;
+	signed char impulseY;
+};
+
+/*
+	The frames of one sprite sheet column, stored from firstFrame in the frame table, and its events, stored in frame order from firstEvent in the event table.
+*/
+struct MoveTimeline
+{
+	unsigned short firstFrame;
+	unsigned short firstEvent;
+
+	unsigned char startupFrames;
+	unsigned char activeFrames;
+	unsigned char recoveryFrames;
+	unsigned char eventCount;
+};
+
+struct MoveTimelineSet
+{
+	const MoveTimeline *timelines;
+	const MoveFrame *frames;
+	const MoveBox *boxes;
+	const MoveEvent *events;
+
+	int timelineCount;
+};
+
+const MoveFrame *getMoveFrame(const MoveTimelineSet *set, int column, int frame);
+MovePhase::MovePhase getMovePhase(const MoveTimelineSet *set, int column, int frame);
+const MoveEvent *getMoveEvents(const MoveTimelineSet *set, int column, int frame, int *count);
+bool hasMoveEvent(const MoveTimelineSet *set, int column, MoveEventType::MoveEventType type);
\ No newline at end of file
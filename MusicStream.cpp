@@ -0,0 +1,321 @@
+/*
+	MusicStream.cpp
+
+	This file contains the implementation for functions prototyped in the MusicStreamC class.
+*/
+
+#define _CRT_SECURE_NO_WARNINGS
+
+#include <string.h>
+#include "MusicStream.h"
+#include "AssetPackage.h"
+
+/* Public functions */
+MusicStreamC::MusicStreamC()
+{
+	mRunning.store(false);
+	mSegmentCount = 0;
+	mDevice = NULL;
+	mThread = NULL;
+	mBufferDone = CreateEvent(NULL, FALSE, FALSE, NULL);
+}
+
+MusicStreamC::~MusicStreamC()
+{
+	stop();
+	CloseHandle(mBufferDone);
+}
+
+/*
+	Starts looping the given segments on the worker thread, replacing whatever was playing.
+	A segment without a right channel file plays its left channel on both sides.
+*/
+void MusicStreamC::play(const char **leftPaths, const char **rightPaths, int segmentCount)
+{
+	stop();
+
+	if (segmentCount > MAX_MUSIC_SEGMENTS)
+		segmentCount = MAX_MUSIC_SEGMENTS;
+
+	for (int i = 0; i < segmentCount; i++)
+	{
+		strncpy(mLeftPaths[i], leftPaths[i], MAX_PATH - 1);
+		mLeftPaths[i][MAX_PATH - 1] = 0;
+		strncpy(mRightPaths[i], rightPaths[i], MAX_PATH - 1);
+		mRightPaths[i][MAX_PATH - 1] = 0;
+	}
+
+	mSegmentCount = segmentCount;
+
+	if (mSegmentCount == 0)
+		return;
+
+	mRunning.store(true);
+	mThread = CreateThread(NULL, 0, streamThreadProc, this, 0, NULL);
+}
+
+/*
+	Stops the worker thread and waits for it to release the output device.
+*/
+void MusicStreamC::stop()
+{
+	if (mThread == NULL)
+		return;
+
+	mRunning.store(false);
+	SetEvent(mBufferDone);
+
+	WaitForSingleObject(mThread, INFINITE);
+	CloseHandle(mThread);
+	mThread = NULL;
+}
+
+bool MusicStreamC::isPlaying()
+{
+	return mThread != NULL && mRunning.load();
+}
+
+/* Private functions */
+DWORD WINAPI MusicStreamC::streamThreadProc(LPVOID parameter)
+{
+	((MusicStreamC *)parameter)->run();
+
+	return 0;
+}
+
+/*
+	Keeps every output buffer queued on the device, refilling each one as soon as the device hands it back.
+*/
+void MusicStreamC::run()
+{
+	if (!openSegment(0) || !openDevice())
+	{
+		mLeftFile.close();
+		mRightFile.close();
+		mRunning.store(false);
+		return;
+	}
+
+	for (int i = 0; i < MUSIC_BUFFER_COUNT; i++)
+	{
+		fillBuffer(&mHeaders[i]);
+		waveOutWrite(mDevice, &mHeaders[i], sizeof(WAVEHDR));
+	}
+
+	while (mRunning.load())
+	{
+		WaitForSingleObject(mBufferDone, INFINITE);
+
+		for (int i = 0; i < MUSIC_BUFFER_COUNT && mRunning.load(); i++)
+		{
+			if (mHeaders[i].dwFlags & WHDR_DONE)
+			{
+				fillBuffer(&mHeaders[i]);
+				waveOutWrite(mDevice, &mHeaders[i], sizeof(WAVEHDR));
+			}
+		}
+	}
+
+	closeDevice();
+
+	mLeftFile.close();
+	mRightFile.close();
+}
+
+/*
+	Fills an output buffer with interleaved stereo frames at the device rate.
+	Segments recorded at another rate are stepped through with linear interpolation.
+*/
+void MusicStreamC::fillBuffer(WAVEHDR *header)
+{
+	short *output = (short *)header->lpData;
+
+	for (int i = 0; i < MUSIC_BUFFER_FRAMES; i++)
+	{
+		while (mPhase >= 0x10000)
+		{
+			mPhase -= 0x10000;
+
+			mPreviousFrame[0] = mCurrentFrame[0];
+			mPreviousFrame[1] = mCurrentFrame[1];
+			nextSourceFrame(mCurrentFrame);
+		}
+
+		int fraction = mPhase >> 1;
+
+		output[0] = (short)(mPreviousFrame[0] + (((mCurrentFrame[0] - mPreviousFrame[0]) * fraction) >> 15));
+		output[1] = (short)(mPreviousFrame[1] + (((mCurrentFrame[1] - mPreviousFrame[1]) * fraction) >> 15));
+		output += 2;
+
+		mPhase += mStep;
+	}
+}
+
+/*
+	Returns the next stereo frame of the current segment, moving on to the next segment when it runs out.
+	Produces silence if none of the segments can be read.
+*/
+void MusicStreamC::nextSourceFrame(short *frame)
+{
+	if (mSourcePosition >= mSourceFrames)
+	{
+		mSourceFrames = readSourceChunk();
+		mSourcePosition = 0;
+
+		for (int attempts = 0; mSourceFrames == 0 && attempts < mSegmentCount; attempts++)
+		{
+			if (openNextSegment())
+				mSourceFrames = readSourceChunk();
+		}
+
+		if (mSourceFrames == 0)
+		{
+			frame[0] = 0;
+			frame[1] = 0;
+			return;
+		}
+	}
+
+	frame[0] = mLeftSource[mSourcePosition];
+	frame[1] = mRightSource[mSourcePosition];
+	mSourcePosition++;
+}
+
+/*
+	Opens the output device as 16-bit stereo at the rate of the first segment.
+	The device signals mBufferDone every time it finishes playing a buffer.
+*/
+bool MusicStreamC::openDevice()
+{
+	WAVEFORMATEX format;
+
+	ZeroMemory(&format, sizeof(WAVEFORMATEX));
+
+	format.wFormatTag = WAVE_FORMAT_PCM;
+	format.nChannels = 2;
+	format.nSamplesPerSec = mOutputRate;
+	format.wBitsPerSample = 16;
+	format.nBlockAlign = format.nChannels * format.wBitsPerSample / 8;
+	format.nAvgBytesPerSec = format.nSamplesPerSec * format.nBlockAlign;
+
+	if (waveOutOpen(&mDevice, WAVE_MAPPER, &format, (DWORD_PTR)mBufferDone, 0, CALLBACK_EVENT) != MMSYSERR_NOERROR)
+	{
+		mDevice = NULL;
+		return false;
+	}
+
+	for (int i = 0; i < MUSIC_BUFFER_COUNT; i++)
+	{
+		ZeroMemory(&mHeaders[i], sizeof(WAVEHDR));
+		mHeaders[i].lpData = (LPSTR)mBufferData[i];
+		mHeaders[i].dwBufferLength = sizeof(mBufferData[i]);
+
+		waveOutPrepareHeader(mDevice, &mHeaders[i], sizeof(WAVEHDR));
+	}
+
+	return true;
+}
+
+void MusicStreamC::closeDevice()
+{
+	if (mDevice == NULL)
+		return;
+
+	waveOutReset(mDevice);
+
+	for (int i = 0; i < MUSIC_BUFFER_COUNT; i++)
+		waveOutUnprepareHeader(mDevice, &mHeaders[i], sizeof(WAVEHDR));
+
+	waveOutClose(mDevice);
+	mDevice = NULL;
+}
+
+/*
+	Opens a channel file out of the asset package when it is packaged, otherwise from disk.
+*/
+bool MusicStreamC::openWave(WaveFileC *file, const char *path)
+{
+	AssetPackageC *package = AssetPackageC::GetInstance();
+	int size = 0;
+	const unsigned char *data = package != NULL ? package->getAssetData(path, &size) : NULL;
+
+	return data != NULL ? file->openMemory(data, size) : file->open(path);
+}
+
+/*
+	Opens the channel files of a segment and resets the read position.
+	The first segment opened decides the output rate of the stream.
+*/
+bool MusicStreamC::openSegment(int segment)
+{
+	mCurrentSegment = segment;
+
+	if (!openWave(&mLeftFile, mLeftPaths[segment]) || mLeftFile.getChannels() > MAX_MUSIC_SOURCE_CHANNELS)
+		return false;
+
+	mHasRightFile = openWave(&mRightFile, mRightPaths[segment]) && mRightFile.getChannels() <= MAX_MUSIC_SOURCE_CHANNELS;
+
+	if (mHasRightFile && mRightFile.getSampleRate() != mLeftFile.getSampleRate())
+		mHasRightFile = false;
+
+	if (segment == 0 && mDevice == NULL)
+	{
+		mOutputRate = mLeftFile.getSampleRate();
+		mPhase = 0;
+		mPreviousFrame[0] = mPreviousFrame[1] = 0;
+		mCurrentFrame[0] = mCurrentFrame[1] = 0;
+	}
+
+	mStep = (unsigned int)(((unsigned long long)mLeftFile.getSampleRate() << 16) / mOutputRate);
+	mSourceFrames = 0;
+	mSourcePosition = 0;
+
+	return true;
+}
+
+bool MusicStreamC::openNextSegment()
+{
+	return openSegment((mCurrentSegment + 1) % mSegmentCount);
+}
+
+/*
+	Reads the next chunk of the current segment into the left and right source buffers.
+	Returns the number of frames available, zero at the end of the segment.
+*/
+int MusicStreamC::readSourceChunk()
+{
+	if (!mLeftFile.isOpen())
+		return 0;
+
+	int frames = readChannel(&mLeftFile, mLeftSource, MUSIC_SOURCE_FRAMES, false);
+
+	if (mHasRightFile)
+	{
+		int rightFrames = readChannel(&mRightFile, mRightSource, frames, true);
+
+		for (int i = rightFrames; i < frames; i++)
+			mRightSource[i] = mLeftSource[i];
+	}
+	else
+	{
+		memcpy(mRightSource, mLeftSource, frames * sizeof(short));
+	}
+
+	return frames;
+}
+
+/*
+	Reads frames from a channel file and keeps a single channel of each frame.
+	Mono files are used as they are, stereo files contribute their first or last channel.
+*/
+int MusicStreamC::readChannel(WaveFileC *file, short *destination, int frames, bool useLastChannel)
+{
+	int channels = file->getChannels();
+	int channel = useLastChannel ? channels - 1 : 0;
+	int framesRead = file->read(mReadBuffer, frames);
+
+	for (int i = 0; i < framesRead; i++)
+		destination[i] = mReadBuffer[i * channels + channel];
+
+	return framesRead;
+}
\ No newline at end of file
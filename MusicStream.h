@@ -0,0 +1,85 @@
+#pragma once
+/*
+	MusicStream.h
+
+	This class streams background music on its own output device so it is never cut off by sound effects.
+	Each music segment is stored as a pair of files holding the left and right channels.
+	A worker thread reads the pairs in small chunks, interleaves them into stereo and chains the segments back to back in a loop,
+	so only a few kilobytes of music are resident at any time.
+	The channel files are read out of the asset package when they are packaged.
+*/
+
+#include <windows.h>
+#include <atomic>
+#include "WaveFile.h"
+
+#define MAX_MUSIC_SEGMENTS 8
+#define MUSIC_BUFFER_COUNT 2
+#define MUSIC_BUFFER_FRAMES 4096
+#define MUSIC_SOURCE_FRAMES 1024
+#define MAX_MUSIC_SOURCE_CHANNELS 2
+
+class MusicStreamC
+{
+public:
+	/* Public functions */
+	MusicStreamC();
+	~MusicStreamC();
+
+	void play(const char **leftPaths, const char **rightPaths, int segmentCount);
+	void stop();
+
+	bool isPlaying();
+
+private:
+	/* Private functions */
+	static DWORD WINAPI streamThreadProc(LPVOID parameter);
+
+	void run();
+	void fillBuffer(WAVEHDR *header);
+	void nextSourceFrame(short *frame);
+
+	bool openDevice();
+	void closeDevice();
+	bool openWave(WaveFileC *file, const char *path);
+	bool openSegment(int segment);
+	bool openNextSegment();
+
+	int readSourceChunk();
+	int readChannel(WaveFileC *file, short *destination, int frames, bool useLastChannel);
+
+	/* Private data members */
+	std::atomic<bool> mRunning;
+
+	bool mHasRightFile;
+
+	int mSegmentCount;
+	int mCurrentSegment;
+	int mOutputRate;
+	int mSourceFrames;
+	int mSourcePosition;
+
+	unsigned int mStep;
+	unsigned int mPhase;
+
+	short mPreviousFrame[2];
+	short mCurrentFrame[2];
+
+	short mLeftSource[MUSIC_SOURCE_FRAMES];
+	short mRightSource[MUSIC_SOURCE_FRAMES];
+	short mReadBuffer[MUSIC_SOURCE_FRAMES * MAX_MUSIC_SOURCE_CHANNELS];
+	short mBufferData[MUSIC_BUFFER_COUNT][MUSIC_BUFFER_FRAMES * 2];
+
+	char mLeftPaths[MAX_MUSIC_SEGMENTS][MAX_PATH];
+	char mRightPaths[MAX_MUSIC_SEGMENTS][MAX_PATH];
+
+	WaveFileC mLeftFile;
+	WaveFileC mRightFile;
+
+	WAVEHDR mHeaders[MUSIC_BUFFER_COUNT];
+
+	HWAVEOUT mDevice;
+
+	HANDLE mBufferDone;
+	HANDLE mThread;
+};
\ No newline at end of file
@@ -14,20 +14,23 @@
 #include "Player.h"
 #include "glut.h"
 #include "SOIL.h"
-#include "SoundManager.h"
+#include "GameEventManager.h"
 
 /* Public functions */
 /*
 	Instantiates the sprites a player is responsible for.
-	Loads the sprite sheets for a player into memory.
+	Loads the sprite sheets for a player into memory, drawn from the given sprite sheet of the character's palettes.
 */
-PlayerC::PlayerC(char *spritePath, char *tilePath, SpriteC *digits, float spriteHeight, float spriteWidth, float initPosX, float initPosY, float initVelX, float initVelY, int id, float speed)
+PlayerC::PlayerC(const CharacterDefinition *character, char *spritePath, char *tilePath, SpriteC *digits, float initPosX, float initPosY, float initVelX, float initVelY, int id, float speed)
 {
 	mId = id;
-	mPixelsPerMillisecondSpeed = speed;
-	mSpriteHandler = new SpriteC(spritePath, spriteHeight, spriteWidth, rowsInSpriteSheet, columnsInSpriteSheet);
+	mCharacter = character;
+	mMoves = character->moves;
+	mPixelsPerMillisecondSpeed = SimScalar(speed);
+	mSpriteHandler = new SpriteC(spritePath, character->spriteHeight, character->spriteWidth, character->rowsInSpriteSheet, character->columnsInSpriteSheet);
 	mPlayerTile = new SpriteC(tilePath, playerTileHeight, playerTileWidth, 1, 1);
 	mDigits = digits;
+	mConnected = false;
 
 	reset(initPosX, initPosY, initVelX, initVelY);
 }
@@ -66,7 +69,12 @@ void PlayerC::update(DWORD milliseconds)
 */
 void PlayerC::render()
 {
-	mSpriteHandler->render(mPosition, mU, mV);
+	int animation = (int)mU;
+	Coord2D spritePosition = toCoord2D(mSimPosition);
+
+	spritePosition.x += mMoves->mirrorOffsets[animation];
+
+	mSpriteHandler->render(spritePosition, (float)mMoves->sheetColumns[animation], mV, true, mMoves->mirroredAnimations[animation]);
 
 	mPlayerTile->render(mTilePosition, 0, 0, false);
 
@@ -75,13 +83,14 @@ void PlayerC::render()
 
 /*
 	Sets the player's data members to their starting values.
+	The controller input starts released, so buttons held as the match starts are pressed on its first tick.
 */
 void PlayerC::reset(float x, float y, float vX, float vY)
 {
-	mVelocity.x = vX;
-	mVelocity.y = vY;
-	mPosition.x = x;
-	mPosition.y = y;
+	mSimVelocity.x = SimScalar(vX);
+	mSimVelocity.y = SimScalar(vY);
+	mSimPosition.x = SimScalar(x);
+	mSimPosition.y = SimScalar(y);
 
 	mTilePosition.x = x;
 	mTilePosition.y = tileHeight;
@@ -94,10 +103,8 @@ void PlayerC::reset(float x, float y, float vX, float vY)
 		mTilePosition.x += mSpriteHandler->mWidth - evenPlayerTileWidthOffset;
 	}
 
-	mIsJumping = true;
-	mIsDoubleJumping = true;
+	mState = PlayerState::DoubleJumping;
 	mUseGravity = true;
-	mIsDashing = false;
 	mDead = false;
 	mAttacking = false;
 	mBeingHit = false;
@@ -105,52 +112,131 @@ void PlayerC::reset(float x, float y, float vX, float vY)
 	mV = 0;
 	mCurrentActionDelay = 0;
 	mCurrentAnimationFrame = 0;
-	mCurrentFrameMilliseconds = 100.0f;
+	mMoveFrame = 0;
+	mHitBoxActive = false;
+	mCurrentFrameMilliseconds = 100;
 	mDamageDelay = 0;
 	mHealth = 100;
 	mLastDamageTaken = 0;
 	mLastDamageDealt = 0;
+	mHeightBeforeJump = SimScalar(0);
+
+	ZeroMemory(&mControllerState, sizeof(mControllerState));
+	ZeroMemory(&mPreviousControllerState, sizeof(mPreviousControllerState));
 
 	changeSpriteState((mId % 2) + Jump);
+	mLastU = -1;
 	mLastAction = PlayerAction::Invalid;
 }
 
 /*
-	Sets the vibration motors on the player's controller.
+	Sets the controller input of the coming tick, read by PlayerManagerC for every player at the start of the tick.
 */
-void PlayerC::vibrate(int leftVal, int rightVal)
+void PlayerC::setInput(bool connected, const XINPUT_GAMEPAD *gamepad)
 {
-	XINPUT_VIBRATION vibration;
-
-	ZeroMemory(&vibration, sizeof(XINPUT_VIBRATION));
+	ZeroMemory(&mControllerState, sizeof(mControllerState));
 
-	vibration.wLeftMotorSpeed = leftVal;
-	vibration.wRightMotorSpeed = rightVal;
+	mConnected = connected;
+	mControllerState.Gamepad = *gamepad;
+}
 
-	XInputSetState(mId, &vibration);
+/*
+	Copies every data member the simulation changes into the snapshot.
+*/
+void PlayerC::saveState(PlayerSnapshot *snapshot)
+{
+	ZeroMemory(snapshot, sizeof(*snapshot));
+
+	snapshot->lastDamageDealt = mLastDamageDealt;
+	snapshot->lastDamageTaken = mLastDamageTaken;
+	snapshot->lastAction = mLastAction;
+	snapshot->state = mState;
+	snapshot->health = mHealth;
+	snapshot->currentAnimationFrame = mCurrentAnimationFrame;
+	snapshot->moveFrame = mMoveFrame;
+	snapshot->currentActionDelay = mCurrentActionDelay;
+	snapshot->damageDelay = mDamageDelay;
+	snapshot->currentFrameMilliseconds = mCurrentFrameMilliseconds;
+	snapshot->millisecondsPerFrame = mMillisecondsPerFrame;
+
+	snapshot->lastDirectionalInput = mLastDirectionalInput;
+	snapshot->u = mU;
+	snapshot->v = mV;
+	snapshot->lastU = mLastU;
+
+	snapshot->heightBeforeJump = mHeightBeforeJump;
+	snapshot->position = mSimPosition;
+	snapshot->velocity = mSimVelocity;
+
+	snapshot->hitBoxStart = mSpriteHandler->mHitBoxStart;
+	snapshot->hitBoxEnd = mSpriteHandler->mHitBoxEnd;
+
+	snapshot->gamepad = mControllerState.Gamepad;
+	snapshot->previousGamepad = mPreviousControllerState.Gamepad;
+
+	snapshot->connected = mConnected;
+	snapshot->dead = mDead;
+	snapshot->beingHit = mBeingHit;
+	snapshot->attacking = mAttacking;
+	snapshot->useGravity = mUseGravity;
+	snapshot->hitBoxActive = mHitBoxActive;
 }
 
 /*
-	Determines whether a player's controller is connected or not.
-	Sets the state of the controller in the process.
+	Sets every data member the simulation changes from the snapshot, putting the player back in the state it was saved in.
 */
-BOOL PlayerC::isConnected()
+void PlayerC::restoreState(const PlayerSnapshot *snapshot)
 {
+	mLastDamageDealt = snapshot->lastDamageDealt;
+	mLastDamageTaken = snapshot->lastDamageTaken;
+	mLastAction = (PlayerAction::PlayerAction)snapshot->lastAction;
+	mState = snapshot->state;
+	mHealth = snapshot->health;
+	mCurrentAnimationFrame = snapshot->currentAnimationFrame;
+	mMoveFrame = snapshot->moveFrame;
+	mCurrentActionDelay = snapshot->currentActionDelay;
+	mDamageDelay = snapshot->damageDelay;
+	mCurrentFrameMilliseconds = snapshot->currentFrameMilliseconds;
+	mMillisecondsPerFrame = snapshot->millisecondsPerFrame;
+
+	mLastDirectionalInput = snapshot->lastDirectionalInput;
+	mU = snapshot->u;
+	mV = snapshot->v;
+	mLastU = snapshot->lastU;
+
+	mHeightBeforeJump = snapshot->heightBeforeJump;
+	mSimPosition = snapshot->position;
+	mSimVelocity = snapshot->velocity;
+
+	mSpriteHandler->mHitBoxStart = snapshot->hitBoxStart;
+	mSpriteHandler->mHitBoxEnd = snapshot->hitBoxEnd;
+
 	ZeroMemory(&mControllerState, sizeof(mControllerState));
-	DWORD state = XInputGetState(mId, &mControllerState);
+	ZeroMemory(&mPreviousControllerState, sizeof(mPreviousControllerState));
+	mControllerState.Gamepad = snapshot->gamepad;
+	mPreviousControllerState.Gamepad = snapshot->previousGamepad;
+
+	mConnected = snapshot->connected;
+	mDead = snapshot->dead;
+	mBeingHit = snapshot->beingHit;
+	mAttacking = snapshot->attacking;
+	mUseGravity = snapshot->useGravity;
+	mHitBoxActive = snapshot->hitBoxActive;
+}
 
-	return state == ERROR_SUCCESS;
+/*
+	Returns whether the player's controller was connected when the input of this tick was read.
+*/
+BOOL PlayerC::isConnected()
+{
+	return mConnected;
 }
 
 /*
-	Gets the controller state, setting mControllerState and returning the value.
+	Returns the controller input of this tick.
 */
 XINPUT_STATE PlayerC::getControllerState()
 {
-	ZeroMemory(&mControllerState, sizeof(mControllerState));
-
-	XInputGetState(mId, &mControllerState);
-
 	return mControllerState;
 }
 
@@ -161,7 +247,71 @@ XINPUT_STATE PlayerC::getPreviousControllerState()
 
 Coord2D PlayerC::getPosition()
 {
-	return mPosition;
+	return toCoord2D(mSimPosition);
+}
+
+SimCoord2D PlayerC::getSimPosition()
+{
+	return mSimPosition;
+}
+
+/*
+	Places the collision mask of the cell the player is drawn with, at the same position and facing render() draws it.
+	The position is rounded to whole pixels from the simulation's numbers, so the placement is as deterministic as the simulation.
+*/
+bool PlayerC::getCollisionFrame(CollisionFrame *frame)
+{
+	int animation = (int)mU;
+	SimScalar left = mSimPosition.x + SimScalar(mMoves->mirrorOffsets[animation]);
+
+	return mSpriteHandler->getCollisionFrame(roundToInt(left), roundToInt(-mSimPosition.y), mMoves->sheetColumns[animation], (int)mV, mMoves->mirroredAnimations[animation], frame);
+}
+
+/*
+	Gets the hitbox of the current animation frame relative to the player's position.
+	Returns false while the move's track has its hitbox switched off or on frames without a hitbox.
+*/
+bool PlayerC::getHitBox(SimCoord2D *start, SimCoord2D *end)
+{
+	int column = mMoves->sheetColumns[(int)mU];
+	const MoveFrame *frame = getMoveFrame(mCharacter->timelines, column, mMoveFrame);
+
+	if (!mHitBoxActive || frame == NULL || frame->hitBox == NO_MOVE_BOX)
+		return false;
+
+	getMoveBox(frame->hitBox, start, end);
+
+	return true;
+}
+
+/*
+	Gets the hurtbox of the current animation frame relative to the player's position,
+	falling back to the hitbox of the sprite for animations without a timeline.
+*/
+void PlayerC::getHurtBox(SimCoord2D *start, SimCoord2D *end)
+{
+	const MoveFrame *frame = getMoveFrame(mCharacter->timelines, mMoves->sheetColumns[(int)mU], mMoveFrame);
+
+	if (frame == NULL)
+	{
+		start->x = SimScalar(mSpriteHandler->mHitBoxStart.x);
+		start->y = SimScalar(mSpriteHandler->mHitBoxStart.y);
+		end->x = SimScalar(mSpriteHandler->mHitBoxEnd.x);
+		end->y = SimScalar(mSpriteHandler->mHitBoxEnd.y);
+		return;
+	}
+
+	getMoveBox(frame->hurtBox, start, end);
+}
+
+/*
+	Returns true while the current animation frame of an attack has a hitbox, the only frames hits are checked on.
+*/
+bool PlayerC::isHitActive()
+{
+	SimCoord2D start, end;
+
+	return mAttacking && getHitBox(&start, &end);
 }
 
 /* Private functions */
@@ -184,21 +334,19 @@ void PlayerC::resetAttackCollision()
 
 /*
 	Determines whether to allow the player to be hit by checking the current damage delay.
-	Vibrates the controller if the player is unable to take damage.
+	The controller rumble during the delay is driven by the Hit or Invulnerable event raised when the delay is set.
 */
 void PlayerC::handleDamageDelay(DWORD milliseconds)
 {
-	mDamageDelay -= milliseconds;
+	mDamageDelay -= (int)milliseconds;
 
 	if (mDamageDelay <= 0)
 	{
-		vibrate(0, 0);
 		mDamageDelay = 0;
 		handleBeingHit();
 	}
 	else
 	{
-		vibrate(leftVibration, rightVibration);
 		mBeingHit = false;
 	}
 }
@@ -209,17 +357,15 @@ void PlayerC::handleDamageDelay(DWORD milliseconds)
 */
 void PlayerC::handleActionDelay(DWORD milliseconds)
 {
-	mCurrentActionDelay -= milliseconds;
+	mCurrentActionDelay -= (int)milliseconds;
 
 	if (mCurrentActionDelay <= 0)
 	{
 		mCurrentActionDelay = 0;
 		resetAttackCollision();
 
-		handleHorizontalMovement();
-		handleActions();
+		handleInput();
 		setAttacking();
-		handleJumping();
 	}
 }
 
@@ -231,7 +377,7 @@ void PlayerC::handleBeingHit()
 	if (mBeingHit)
 	{
 		mBeingHit = false;
-		mVelocity.x = 0;
+		mSimVelocity.x = SimScalar(0);
 
 		int index = Damage;
 
@@ -239,35 +385,16 @@ void PlayerC::handleBeingHit()
 			index += 1;
 
 		changeSpriteState(index);
+		emitEvent(GameEventType::Hit, index, mMoves->damageDelays[index]);
 
 		mLastAction = PlayerAction::Damaged;
 		mHealth -= mLastDamageTaken;
 
 		if (mHealth <= 0)
-			mDead = true;
-	}
-}
-
-/*
-	Checks player input to see if they are initiating a jump, sets their y velocity and triggers an animation if so.
-*/
-void PlayerC::handleJumping()
-{
-	if (mControllerState.Gamepad.sThumbLY > deadValue && !mIsDoubleJumping && !(mPreviousControllerState.Gamepad.sThumbLY > deadValue))
-	{
-		if (mIsJumping)
-		{
-			mIsDoubleJumping = true;
-		}
-		else
 		{
-			mIsJumping = true;
-			mHeightBeforeJump = mPosition.y;
+			mDead = true;
+			emitEvent(GameEventType::KO, index);
 		}
-
-		mVelocity.y = jumpSpeed;
-
-		applyAction(Jump);
 	}
 }
 
@@ -278,84 +405,24 @@ void PlayerC::handleFalling()
 {
 	if (!mUseGravity)
 	{
-		if (mIsDoubleJumping && mPosition.y >= (mHeightBeforeJump + jumpHeight + jumpHeight))
+		if (isDoubleJumping(mState) && mSimPosition.y >= (mHeightBeforeJump + jumpHeight + jumpHeight))
 		{
 			mUseGravity = true;
-			mVelocity.y = 0;
+			mSimVelocity.y = SimScalar(0);
 		}
-		else if (mIsJumping && mPosition.y >= (mHeightBeforeJump + jumpHeight))
+		else if (isAirborne(mState) && mSimPosition.y >= (mHeightBeforeJump + jumpHeight))
 		{
 			mUseGravity = true;
-			mVelocity.y = 0;
+			mSimVelocity.y = SimScalar(0);
 		}
 	}
 
 	if (mUseGravity)
 	{
 		if (mControllerState.Gamepad.sThumbLY < -deadValue && mControllerState.Gamepad.sThumbLX < deadValue && mControllerState.Gamepad.sThumbLX > -deadValue && mCurrentActionDelay <= 0)
-			mVelocity.y = -terminalVelocity;
-		else
-			mVelocity.y -= gravityAcceleration;
-	}
-}
-
-/*
-	Sets the appropriate animation and velocity depending on the directional inputs of the player.
-*/
-void PlayerC::handleHorizontalMovement()
-{
-	if (mControllerState.Gamepad.sThumbLX < -deadValue)
-	{
-		if (mIsDashing || inputToDash())
-		{
-			mVelocity.x = -2 * mPixelsPerMillisecondSpeed;
-		}
-		else
-		{
-			mVelocity.x = -1 * mPixelsPerMillisecondSpeed;
-		}
-
-		if (!mIsJumping && mIsDashing)
-			changeSpriteState(Dash + 1);
-		else if (!mIsJumping)
-			changeSpriteState(Walk + 1);
-		else
-			changeSpriteState(Jump + 1);
-
-		mLastDirectionalInput = mControllerState.Gamepad.sThumbLX;
-	}
-	else if (mControllerState.Gamepad.sThumbLX > deadValue)
-	{
-		if (mIsDashing || inputToDash())
-		{
-			mVelocity.x = 2 * mPixelsPerMillisecondSpeed;
-		}
-		else
-		{
-			mVelocity.x = mPixelsPerMillisecondSpeed;
-		}
-
-		if (!mIsJumping && mIsDashing)
-			changeSpriteState(Dash);
-		else if (!mIsJumping)
-			changeSpriteState(Walk);
+			mSimVelocity.y = -terminalVelocity;
 		else
-			changeSpriteState(Jump);
-
-		mLastDirectionalInput = mControllerState.Gamepad.sThumbLX;
-	}
-	else
-	{
-		mVelocity.x = 0;
-		mIsDashing = false;
-
-		if (!mIsJumping)
-		{
-			if (mLastDirectionalInput > deadValue)
-				changeSpriteState(Stand);
-			else
-				changeSpriteState(Stand + 1);
-		}
+			mSimVelocity.y -= gravityAcceleration;
 	}
 }
 
@@ -364,17 +431,20 @@ void PlayerC::handleHorizontalMovement()
 */
 void PlayerC::handleCollision()
 {
-	if (mPosition.y >= (ceilingHeight - mSpriteHandler->mHitBoxStart.y))
+	SimScalar ceiling = SimScalar(ceilingHeight - mSpriteHandler->mHitBoxStart.y);
+	SimScalar ground = SimScalar(floorHeight - mSpriteHandler->mHitBoxEnd.y);
+
+	if (mSimPosition.y >= ceiling)
 	{
-		mPosition.y = ceilingHeight - mSpriteHandler->mHitBoxStart.y;
+		mSimPosition.y = ceiling;
 	}
 
-	if (mPosition.y <= (floorHeight - mSpriteHandler->mHitBoxEnd.y))
+	if (mSimPosition.y <= ground)
 	{
-		mPosition.y = floorHeight - mSpriteHandler->mHitBoxEnd.y;
-		mVelocity.y = 0;
+		mSimPosition.y = ground;
+		mSimVelocity.y = SimScalar(0);
 
-		if (mIsJumping)
+		if (isAirborne(mState))
 		{
 			int index = Stand;
 
@@ -383,25 +453,27 @@ void PlayerC::handleCollision()
 				index += 1;
 			}
 
-			SoundManagerC::GetInstance()->playKirbySound(index);
+			emitEvent(GameEventType::Landed, index);
 			changeSpriteState(index);
 		}
 
-		mIsJumping = false;
-		mIsDoubleJumping = false;
+		mState = getLandedState(mState);
 		mUseGravity = false;
 	}
 
-	if (mPosition.x <= (leftBound - mSpriteHandler->mHitBoxStart.x))
+	SimScalar leftWall = SimScalar(leftBound - mSpriteHandler->mHitBoxStart.x);
+	SimScalar rightWall = SimScalar(rightBound - mSpriteHandler->mHitBoxEnd.x);
+
+	if (mSimPosition.x <= leftWall)
 	{
-		mPosition.x = leftBound - mSpriteHandler->mHitBoxStart.x;
-		mVelocity.x = 0;
+		mSimPosition.x = leftWall;
+		mSimVelocity.x = SimScalar(0);
 	}
 
-	if (mPosition.x >= (rightBound - mSpriteHandler->mHitBoxEnd.x))
+	if (mSimPosition.x >= rightWall)
 	{
-		mPosition.x = rightBound - mSpriteHandler->mHitBoxEnd.x;
-		mVelocity.x = 0;
+		mSimPosition.x = rightWall;
+		mSimVelocity.x = SimScalar(0);
 	}
 }
 
@@ -410,146 +482,59 @@ void PlayerC::handleCollision()
 */
 void PlayerC::applyVelocity(DWORD milliseconds)
 {
-	if (mVelocity.y > terminalVelocity)
-		mVelocity.y = terminalVelocity;
+	if (mSimVelocity.y > terminalVelocity)
+		mSimVelocity.y = terminalVelocity;
 
-	if (mVelocity.y < -terminalVelocity)
-		mVelocity.y = -terminalVelocity;
+	if (mSimVelocity.y < -terminalVelocity)
+		mSimVelocity.y = -terminalVelocity;
 
-	mPosition.x = mPosition.x + (mVelocity.x * milliseconds);
-	mPosition.y = mPosition.y + (mVelocity.y * milliseconds);
+	mSimPosition.x = mSimPosition.x + (mSimVelocity.x * (int)milliseconds);
+	mSimPosition.y = mSimPosition.y + (mSimVelocity.y * (int)milliseconds);
 }
 
 /*
-	Sets the action of the player this frame and initiates their animation if applicable.
+	Takes the transition out of the player's state for this tick's input, changing animations and raising events in the order of its steps.
+	The player turns to face any direction the stick is held in.
 */
-void PlayerC::handleActions()
+void PlayerC::handleInput()
 {
-	mLastAction = PlayerAction::Invalid;
-
-	if (mControllerState.Gamepad.wButtons & (XINPUT_GAMEPAD_X | XINPUT_GAMEPAD_Y))
-	{
-		mVelocity.x = 0;
-		changeSpriteState(Taunting);
-		mLastAction = PlayerAction::Taunt;
-
-		SoundManagerC::GetInstance()->playKirbySound(Taunting);
-	}
-	else if (mControllerState.Gamepad.wButtons & XINPUT_GAMEPAD_A)
-	{
-		if (mControllerState.Gamepad.sThumbLY > deadValue && !mIsJumping)
-		{
-			mVelocity.x = 0;
-			mLastDamageDealt = largeDamage;
-
-			applyAction(UpAttack);
-		}
-		else if (mControllerState.Gamepad.sThumbLY < -deadValue && !mIsJumping)
-		{
-			mVelocity.x = 0;
-			mLastDamageDealt = largeDamage;
-
-			applyAction(DownAttack);
-		}
-		else if (mIsDashing && !mIsJumping && !(mPreviousControllerState.Gamepad.wButtons & XINPUT_GAMEPAD_A))
-		{
-			mIsDashing = false;
-			mLastDamageDealt = smallDamage;
+	int intent = getPlayerIntent(&mControllerState.Gamepad, &mPreviousControllerState.Gamepad, deadValue, triggerDeadValue);
+	const PlayerTransition *transition = getPlayerTransition(mState, mLastDirectionalInput <= 0, intent);
 
-			applyAction(DashAttack);
-		}
-		else if ((mControllerState.Gamepad.sThumbLX < -deadValue || mControllerState.Gamepad.sThumbLX > deadValue) && !mIsJumping)
-		{
-			mVelocity.x = 0;
-			mLastDamageDealt = largeDamage;
-
-			applyAction(SideAttack);
-		}
-		else if (!mIsJumping)
-		{
-			mVelocity.x = 0;
-			mLastDamageDealt = smallDamage;
-
-			applyAction(RapidPunch);
-		}
-		else if (mIsJumping && !(mPreviousControllerState.Gamepad.wButtons & XINPUT_GAMEPAD_A))
-		{
-			mLastDamageDealt = largeDamage;
+	if (mControllerState.Gamepad.sThumbLX < -deadValue || mControllerState.Gamepad.sThumbLX > deadValue)
+		mLastDirectionalInput = mControllerState.Gamepad.sThumbLX;
 
-			applyAction(Aerial);
-		}
+	if (transition->events[TransitionStep::Movement] != GameEventType::Invalid)
+		emitEvent((GameEventType::GameEventType)transition->events[TransitionStep::Movement], transition->animations[TransitionStep::Movement]);
 
-		mLastAction = PlayerAction::Attack;
-	}
-	else if (mControllerState.Gamepad.wButtons & XINPUT_GAMEPAD_B)
+	for (int step = 0; step < TRANSITION_STEPS; step++)
 	{
-		if (mControllerState.Gamepad.sThumbLY < -deadValue)
-		{
-			mVelocity.x = 0;
-			mVelocity.y = -terminalVelocity;
-
-			mIsJumping = false;
-			mIsDoubleJumping = false;
-
-			mLastDamageDealt = smallDamage;
-
-			changeSpriteState(DownSpecial);
-
-			SoundManagerC::GetInstance()->playKirbySound(DownSpecial);
-
-			mLastAction = PlayerAction::Special;
-		}
-		else if (mControllerState.Gamepad.sThumbLY > deadValue)
-		{
-			mIsJumping = true;
-			mIsDoubleJumping = true;
-			mVelocity.y = jumpSpeed * 1.5f;
-
-			mLastDamageDealt = smallDamage;
-
-			applyAction(UpSpecial);
-			mLastAction = PlayerAction::Special;
-		}
-		else if (mControllerState.Gamepad.sThumbLX > deadValue || mControllerState.Gamepad.sThumbLX < -deadValue)
-		{
-			mVelocity.x = 0;
+		if (transition->animations[step] == NO_TRANSITION_ANIMATION)
+			continue;
 
-			if (!mIsJumping)
-				mVelocity.y = -terminalVelocity;
+		changeSpriteState(transition->animations[step]);
 
-			mLastDamageDealt = smallDamage;
-
-			applyAction(SideSpecial);
-			mLastAction = PlayerAction::Special;
-		}
+		if (step != TransitionStep::Movement && transition->events[step] != GameEventType::Invalid)
+			emitEvent((GameEventType::GameEventType)transition->events[step], transition->animations[step]);
 	}
-	else if (mControllerState.Gamepad.bLeftTrigger > triggerDeadValue || mControllerState.Gamepad.bRightTrigger > triggerDeadValue)
-	{
-		if (mControllerState.Gamepad.sThumbLX > deadValue || mControllerState.Gamepad.sThumbLX < -deadValue)
-		{
-			applyAction(DodgeRoll);
-		}
-		else
-		{
-			mVelocity.x = 0;
-			applyAction(Block);
-		}
 
-		mLastAction = PlayerAction::Dodge;
-	}
-}
+	if (transition->startsJump)
+		mHeightBeforeJump = mSimPosition.y;
 
-/*
-	Applies the action specified by the index to the sprite and plays any corresponding sounds.
-*/
-void PlayerC::applyAction(int spriteStartIndex)
-{
-	if (mLastDirectionalInput <= 0)
-		spriteStartIndex += 1;
+	mSimVelocity.x = mPixelsPerMillisecondSpeed * transition->velocityX;
+
+	if (transition->velocityY == TransitionVelocity::Rise)
+		mSimVelocity.y = jumpSpeed;
+	else if (transition->velocityY == TransitionVelocity::HighRise)
+		mSimVelocity.y = jumpSpeed * 3 / 2;
+	else if (transition->velocityY == TransitionVelocity::Dive)
+		mSimVelocity.y = -terminalVelocity;
 
-	changeSpriteState(spriteStartIndex);
+	if (transition->damage != TransitionDamage::Keep)
+		mLastDamageDealt = transition->damage == TransitionDamage::Large ? largeDamage : smallDamage;
 
-	SoundManagerC::GetInstance()->playKirbySound(spriteStartIndex);
+	mLastAction = (PlayerAction::PlayerAction)transition->action;
+	mState = transition->nextState;
 }
 
 /*
@@ -565,33 +550,58 @@ void PlayerC::setAttacking()
 
 /*
 	Sets the current animation frame, sprite hitbox and animation times based on the given action index.
+	The horizontal extent of the hitbox is mirrored for left-facing animations.
+	Changing animation, or starting an action that lasts a set time, restarts the move timeline and the drawn animation from their first frame
+	and raises the events of that frame, so the row drawn always matches the hitbox and events.
 */
 void PlayerC::changeSpriteState(int u)
 {
+	bool restarted = u != (int)mU || mMoves->animationDurations[u] != 0;
+
+	if (restarted)
+	{
+		mMoveFrame = 0;
+		mHitBoxActive = false;
+		mCurrentAnimationFrame = 0;
+		mCurrentFrameMilliseconds = 0;
+	}
+
 	mV = mCurrentAnimationFrame;
 	mU = u;
 
-	mSpriteHandler->mHitBoxStart.x = collisionStartX[u];
-	mSpriteHandler->mHitBoxStart.y = collisionStartY[u];
-	mSpriteHandler->mHitBoxEnd.x = collisionEndX[u];
-	mSpriteHandler->mHitBoxEnd.y = collisionEndY[u];
+	mSpriteHandler->mHitBoxStart.x = mMoves->collisionStartX[u];
+	mSpriteHandler->mHitBoxStart.y = mMoves->collisionStartY[u];
+	mSpriteHandler->mHitBoxEnd.x = mMoves->collisionEndX[u];
+	mSpriteHandler->mHitBoxEnd.y = mMoves->collisionEndY[u];
+
+	if (mMoves->mirroredAnimations[u])
+		mSpriteHandler->mirrorHitBox(mMoves->mirrorOffsets[u]);
 
 	setAnimationTimes(u);
+
+	if (restarted)
+		handleMoveEvents();
 }
 
 /*
 	Sets the duration and speed of an animation as well as it's I-frames.
+	The I-frames of a damage animation are announced by the Hit event, which carries the same delay, so only other moves raise Invulnerable.
 */
 void PlayerC::setAnimationTimes(int u)
 {
-	if (animationDurations[u] != 0)
-		mCurrentActionDelay = animationDurations[u];
+	if (mMoves->animationDurations[u] != 0)
+		mCurrentActionDelay = mMoves->animationDurations[u];
 
-	if (animationSpeeds[u] != 0)
-		mMillisecondsPerFrame = animationSpeeds[u];
+	if (mMoves->animationSpeeds[u] != 0)
+		mMillisecondsPerFrame = mMoves->animationSpeeds[u];
 
-	if (damageDelays[u] != 0)
-		mDamageDelay = damageDelays[u];
+	if (mMoves->damageDelays[u] != 0)
+	{
+		mDamageDelay = mMoves->damageDelays[u];
+
+		if (u != Damage && u != Damage + 1)
+			emitEvent(GameEventType::Invulnerable, u, mMoves->damageDelays[u]);
+	}
 }
 
 /*
@@ -610,41 +620,65 @@ void PlayerC::updateSprite()
 }
 
 /*
-	Iterates the animation to the next frame in the set if the frame duration is over.
+	Iterates the animation through every frame whose duration is over, carrying the time left into the next frame
+	so animations keep the same pace at any frame rate, and raises the events of each move frame reached.
 */
 void PlayerC::updateAnimationFrameTime(DWORD milliseconds)
 {
-	mCurrentFrameMilliseconds += milliseconds;
+	mCurrentFrameMilliseconds += (int)milliseconds;
 
-	if (mCurrentFrameMilliseconds >= mMillisecondsPerFrame)
+	while (mCurrentFrameMilliseconds >= mMillisecondsPerFrame)
 	{
-		mCurrentFrameMilliseconds = 0;
+		mCurrentFrameMilliseconds -= mMillisecondsPerFrame;
 		mCurrentAnimationFrame = (mCurrentAnimationFrame + 1) % mSpriteHandler->getRows();
+		mMoveFrame++;
+
+		handleMoveEvents();
 	}
 }
 
 /*
-	Determines whether the player has entered to dash horizontally or not.
-	Sets the isDashing data member.
+	Applies the events of the move's track on the frame the move has reached.
+	Sounds are raised as game events, hitboxes are switched on and off, and impulses are added to the velocity in the direction the animation faces.
 */
-bool PlayerC::inputToDash()
+void PlayerC::handleMoveEvents()
 {
-	bool result = false;
+	int animation = (int)mU;
+	int count;
+	const MoveEvent *events = getMoveEvents(mCharacter->timelines, mMoves->sheetColumns[animation], mMoveFrame, &count);
 
-	if (!mIsJumping && mLastDirectionalInput > deadValue && mControllerState.Gamepad.sThumbLX > deadValue && mPreviousControllerState.Gamepad.sThumbLX < deadValue)
-	{
-		result = true;
-		mIsDashing = true;
-		SoundManagerC::GetInstance()->playKirbySound(Dash);
-	}
-	else if (!mIsJumping && mLastDirectionalInput < -deadValue && mControllerState.Gamepad.sThumbLX < -deadValue && mPreviousControllerState.Gamepad.sThumbLX > -deadValue)
+	for (int i = 0; i < count; i++)
 	{
-		result = true;
-		mIsDashing = true;
-		SoundManagerC::GetInstance()->playKirbySound(Dash + 1);
+		switch (events[i].type)
+		{
+		case MoveEventType::HitBoxOn:
+			mHitBoxActive = true;
+			break;
+		case MoveEventType::HitBoxOff:
+			mHitBoxActive = false;
+			break;
+		case MoveEventType::Sound:
+			emitEvent(GameEventType::Cued, animation);
+			break;
+		case MoveEventType::Impulse:
+			mSimVelocity.x += mPixelsPerMillisecondSpeed * (mMoves->mirroredAnimations[animation] ? -events[i].impulseX : events[i].impulseX) / 10;
+			mSimVelocity.y += jumpSpeed * events[i].impulseY / 10;
+			break;
+		default:
+			break;
+		}
 	}
+}
+
+/*
+	Raises a game event for this player in the current simulation tick.
+	The event is panned by the center of the player's hit box across the stage.
+*/
+void PlayerC::emitEvent(GameEventType::GameEventType type, int animationIndex, int duration)
+{
+	float center = toFloat(mSimPosition.x) + (mSpriteHandler->mHitBoxStart.x + mSpriteHandler->mHitBoxEnd.x) / 2.0f;
 
-	return result;
+	GameEventManagerC::GetInstance()->emit(type, mId, mCharacter, animationIndex, center / rightBound, duration);
 }
 
 /*
@@ -687,4 +721,24 @@ void PlayerC::drawHealthDigits()
 	mDigits->render(digitPosition, tensU, 0, false);
 	digitPosition.x += (digitWidth - 1);
 	mDigits->render(digitPosition, onesU, 0, false);
+}
+
+/*
+	Gets a box of the move timelines relative to the player's position, mirrored along with the cell for left-facing animations.
+*/
+void PlayerC::getMoveBox(int box, SimCoord2D *start, SimCoord2D *end)
+{
+	const MoveBox *moveBox = &mCharacter->timelines->boxes[box];
+	int animation = (int)mU;
+
+	start->x = SimScalar((int)moveBox->startX);
+	start->y = SimScalar((int)moveBox->startY);
+	end->x = SimScalar((int)moveBox->endX);
+	end->y = SimScalar((int)moveBox->endY);
+
+	if (mMoves->mirroredAnimations[animation])
+	{
+		start->x = SimScalar(mSpriteHandler->mWidth - moveBox->endX + mMoves->mirrorOffsets[animation]);
+		end->x = SimScalar(mSpriteHandler->mWidth - moveBox->startX + mMoves->mirrorOffsets[animation]);
+	}
 }
\ No newline at end of file
@@ -4,6 +4,12 @@
 
 	This class is used to represent one of four possible players.
 	This file and the associated class contains constants that are used by PlayerC instantiations to interact within the game.
+	The tables that drive a player's animations, moves and sounds belong to the character it plays, shared by every player of that character.
+	A player's position and velocity are simulation numbers from SimulationMath.h, floats or fixed point depending on the build.
+	What a player does with their controller input is looked up in the transitions of PlayerStateMachine.h.
+	The controller input of each tick is handed to the player by PlayerManagerC rather than read by the player, so a match can be played from a log.
+	Everything the simulation changes about a player can be saved into a PlayerSnapshot, which is what the match hashes every tick,
+	and restored from one, which is how a replay seeks.
 */
 
 #include <windows.h>
@@ -13,9 +19,14 @@
 #include "baseTypes.h"
 #include "glut.h"
 #include "Sprite.h"
+#include "GameEventManager.h"
+#include "Character.h"
+#include "PlayerStateMachine.h"
+#include "SimulationMath.h"
 
 /*
-	Indexes into the sprite sheet for each animation type
+	Indexes of each animation type. Animations with a left-facing variant store it at index + 1.
+	The sprite sheet only holds the right-facing cells; the character's sheetColumns maps each index to its column and left-facing variants are drawn mirrored.
 */
 #define Stand 0
 #define Walk 2
@@ -43,22 +54,71 @@ namespace PlayerAction
 	enum PlayerAction { Invalid, TestAction, Attack, Special, Dodge, Taunt, Damaged, MaxState };
 }
 
+/*
+	Every data member of a player that the simulation changes, including the hitbox it keeps in its sprite.
+	Snapshots are cleared before they are filled, so two snapshots of the same state are the same bytes.
+*/
+struct PlayerSnapshot
+{
+	int lastDamageDealt;
+	int lastDamageTaken;
+	int lastAction;
+	int state;
+	int health;
+	int currentAnimationFrame;
+	int moveFrame;
+	int currentActionDelay;
+	int damageDelay;
+	int currentFrameMilliseconds;
+	int millisecondsPerFrame;
+
+	float lastDirectionalInput;
+	float u, v;
+	float lastU;
+
+	SimScalar heightBeforeJump;
+
+	SimCoord2D position;
+	SimCoord2D velocity;
+
+	Coord2D hitBoxStart, hitBoxEnd;
+
+	XINPUT_GAMEPAD gamepad;
+	XINPUT_GAMEPAD previousGamepad;
+
+	bool connected;
+	bool dead;
+	bool beingHit;
+	bool attacking;
+	bool useGravity;
+	bool hitBoxActive;
+};
+
 class PlayerC : ObjectC
 {
 public:
 	/* Public Functions */
-	PlayerC(char *spritePath, char *tilePath, SpriteC *digits, float spriteHeight, float spriteWidth, float initPosX, float initPosY, float initVelX, float initVelY, int id, float speed);
+	PlayerC(const CharacterDefinition *character, char *spritePath, char *tilePath, SpriteC *digits, float initPosX, float initPosY, float initVelX, float initVelY, int id, float speed);
 	~PlayerC();
 
 	void update(DWORD milliseconds);
 	void render();
 	void reset(float x, float y, float vX, float vY);
-	void vibrate(int leftVal = 0, int rightVal = 0);
+
+	void setInput(bool connected, const XINPUT_GAMEPAD *gamepad);
+	void saveState(PlayerSnapshot *snapshot);
+	void restoreState(const PlayerSnapshot *snapshot);
 
 	BOOL isConnected();
 	XINPUT_STATE getControllerState();
 	XINPUT_STATE getPreviousControllerState();
 	Coord2D getPosition();
+	SimCoord2D getSimPosition();
+
+	bool getCollisionFrame(CollisionFrame *frame);
+	bool getHitBox(SimCoord2D *start, SimCoord2D *end);
+	void getHurtBox(SimCoord2D *start, SimCoord2D *end);
+	bool isHitActive();
 
 	/* Public data members */
 	bool mDead;
@@ -79,43 +139,50 @@ private:
 	void handleDamageDelay(DWORD milliseconds);
 	void handleActionDelay(DWORD milliseconds);
 	void handleBeingHit();
-	void handleJumping();
 	void handleFalling();
-	void handleHorizontalMovement();
 	void handleCollision();
 	void applyVelocity(DWORD milliseconds);
-	void handleActions();
-	void applyAction(int spriteStartIndex);
+	void handleInput();
 	void setAttacking();
 	void changeSpriteState(int u);
 	void setAnimationTimes(int u);
 	void updateSprite();
 	void updateAnimationFrameTime(DWORD milliseconds);
-	bool inputToDash();
+	void handleMoveEvents();
+	void emitEvent(GameEventType::GameEventType type, int animationIndex, int duration = 0);
 	void drawHealthDigits();
+	void getMoveBox(int box, SimCoord2D *start, SimCoord2D *end);
 
 	/* Private data members */
-	bool mIsJumping;
-	bool mIsDoubleJumping;
+	bool mConnected;
 	bool mUseGravity;
-	bool mIsDashing;
+	bool mHitBoxActive;
 
+	int mState;
 	int mHealth;
 	int mCurrentAnimationFrame;
+	int mMoveFrame;
+	int mCurrentActionDelay;
+	int mDamageDelay;
+	int mCurrentFrameMilliseconds;
+	int mMillisecondsPerFrame;
 
-	float mPixelsPerMillisecondSpeed;
 	float mLastDirectionalInput;
-	float mHeightBeforeJump;
-	float mCurrentActionDelay;
-	float mDamageDelay;
 	float mU, mV;
 	float mLastU;
-	float mCurrentFrameMilliseconds;
-	float mMillisecondsPerFrame;
 
 	SpriteC *mPlayerTile;
 	SpriteC *mDigits;
 
+	const CharacterDefinition *mCharacter;
+	const CharacterMoves *mMoves;
+
+	SimScalar mPixelsPerMillisecondSpeed;
+	SimScalar mHeightBeforeJump;
+
+	SimCoord2D mSimPosition;
+	SimCoord2D mSimVelocity;
+
 	Coord2D mTilePosition;
 
 	XINPUT_STATE mControllerState;
@@ -126,23 +193,19 @@ private:
 
 	const short deadValue = 15000;
 
-	const int rowsInSpriteSheet = 11;
-	const int columnsInSpriteSheet = 33;
 	const int ceilingHeight = 380;
 	const int floorHeight = -250;
 	const int leftBound = -512;
 	const int rightBound = 512;
-	const int leftVibration = 16000;
-	const int rightVibration = 8000;
 	const int largeDamage = 10;
 	const int smallDamage = 5;
 
 	const float playerTileHeight = 71.0f;
 	const float playerTileWidth = 130.0f;
-	const float jumpHeight = 200.0f;
-	const float terminalVelocity = 2.0f;
-	const float gravityAcceleration = 0.04f;
-	const float jumpSpeed = 1.15f;
+	const SimScalar jumpHeight = SimScalar(200.0f);
+	const SimScalar terminalVelocity = SimScalar(2.0f);
+	const SimScalar gravityAcceleration = SimScalar(0.04f);
+	const SimScalar jumpSpeed = SimScalar(1.15f);
 	const float tileHeight = -300.0f;
 	const float evenPlayerTileWidthOffset = 184.0f;
 	const float evenPlayerDigitXOffset = 2.0f;
@@ -150,74 +213,4 @@ private:
 	const float oddPlayerDigitXOffset = 50.0f;
 	const float oddPlayerDigitYOffset = 14.0f;
 	const float digitWidth = 20.0f;
-
-	const float collisionStartX[33] =
-	{
-		28.0f,28.0f,28.0f,28.0f,28.0f,28.0f,
-		28.0f,28.0f,28.0f,14.0f,14.0f,-3.0f,
-		-3.0f,28.0f,28.0f,80.0f,-16.0f,28.0f,
-		-17.0f,14.0f,14.0f,28.0f,28.0f,28.0f,
-		28.0f,28.0f,28.0f,28.0f,28.0f,40.0f,
-		-17.0f,28.0f,-37.0f
-	};
-
-	const float collisionStartY[33] =
-	{
-		-55.0f,-55.0f,-55.0f,-55.0f,-55.0f,-55.0f,
-		-55.0f,-55.0f,-55.0f,-30.0f,-30.0f,-55.0f,
-		-55.0f,-55.0f,-55.0f,-55.0f,-55.0f,-55.0f,
-		-55.0f,-25.0f,-25.0f,-55.0f,-55.0f,-55.0f,
-		-55.0f,-55.0f,-55.0f,-55.0f,-55.0f,-20.0f,
-		-20.0f,-55.0f,-55.0f
-	};
-
-	const float collisionEndX[33] =
-	{
-		115.0f,115.0f,115.0f,115.0f,115.0f,115.0f,
-		115.0f,115.0f,115.0f,129.0f,129.0f,146.0f,
-		146.0f,115.0f,115.0f,160.0f,64.0f,160.0f,
-		115.0f,129.0f,129.0f,115.0f,115.0f,115.0f,
-		115.0f,115.0f,115.0f,115.0f,115.0f,160.0f,
-		103.0f,180.0f,115.0f
-	};
-
-	const float collisionEndY[33] =
-	{
-		-144.0f,-144.0f,-144.0f,-144.0f,-144.0f,-144.0f,
-		-144.0f,-144.0f,-144.0f,-144.0f,-144.0f,-144.0f,
-		-144.0f,-144.0f,-144.0f,-144.0f,-144.0f,-144.0f,
-		-144.0f,-114.0f,-114.0f,-144.0f,-144.0f,-144.0f,
-		-144.0f,-144.0f,-144.0f,-144.0f,-144.0f,-124.0f,
-		-124.0f,-134.0f,-134.0f
-	};
-
-	const float animationDurations[33] =
-	{
-		0,0,0,0,0,0,
-		0,0,0,500.0f,500.0f,450.0f,
-		450.0f,600.0f,600.0f,800.0f,800.0f,400.0f,
-		400.0f,300.0f,300.0f,300.0f,300.0f,400.0f,
-		400.0f,300.0f,300.0f,500.0f,1000.0f,1000.0f,
-		1000.0f,1000.0f,1000.0f
-	};
-
-	const float animationSpeeds[33] =
-	{
-		100.0f,100.0f,100.0f,100.0f,100.0f,100.0,
-		100.0f,50.0f,50.0f,100.0f,100.0f,70.0f,
-		70.0f,50.0f,50.0f,100.0f,100.0f,100.0f,
-		100.0f,70.0f,70.0f,50.0f,50.0f,70.0f,
-		70.0f,70.0f,70.0f,100.0f,100.0f,70.0f,
-		70.0f,70.0f,70.0f
-	};
-
-	const float damageDelays[33] =
-	{
-		0,0,0,0,0,0,
-		0,0,0,0,0,0,
-		0,0,0,0,0,0,
-		0,0,0,1000.0f,1000.0f,0,
-		0,0,0,0,1000.0f,1000.0f,
-		1000.0f,0,0
-	};
 };
\ No newline at end of file
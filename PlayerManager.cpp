@@ -16,6 +16,34 @@
 #include "PlayerManager.h"
 #include "ScreenManager.h"
 #include "SoundManager.h"
+#include "GameEventManager.h"
+#include "HapticsManager.h"
+#include "TextureManager.h"
+#include "AssetPackage.h"
+#include "MatchLog.h"
+#include "Replay.h"
+#include "DesyncCheck.h"
+#include "StateHash.h"
+#include "Benchmark.h"
+
+#define MAX_REPLAY_TICKS_PER_UPDATE (4 * REPLAY_MAX_SPEED)
+
+#define DETERMINISM_SEED 0x4b69726279ULL
+#define DETERMINISM_TICKS 3600
+#define DETERMINISM_TICK_MILLISECONDS 16
+#define DETERMINISM_HOLD_TICKS 20
+#define DETERMINISM_SCRIPTED_MOVES 15
+
+/*
+	The hash the determinism check's match ends in. Both were produced by g++ 12 on x86-64 at -O0 and -O2, with SSE2 scalar floats.
+	The fixed point hash is the same on every compiler and architecture. The float hash is only valid for the compiler that produced it:
+	a build with no float hash of its own, such as the shipping MSVC x86 one, checks that the match repeats and prints the hash to check in here.
+*/
+#ifdef FIXED_POINT_SIMULATION
+#define DETERMINISM_EXPECTED_HASH 0xf1aeb2d5ed9cb4c2ULL
+#elif defined(__GNUC__) && defined(__x86_64__)
+#define DETERMINISM_EXPECTED_HASH 0xbb91415eaf0ec116ULL
+#endif
 
 PlayerManagerC* PlayerManagerC::sInstance = NULL;
 
@@ -29,69 +57,132 @@ PlayerManagerC* PlayerManagerC::CreateInstance()
 }
 
 /*
-	Initializes the manager by instantiating the players and creating commonly used sprites 
+	Initializes the manager by instantiating the players and creating commonly used sprites, then starts a match with the controllers as they are held.
+	When match logs or replays were asked for on the command line, the match is logged or recorded from its first tick,
+	unless a desync check is running, whose matches are replays of logs and not new ones.
+	When a replay was loaded, the match it recorded is started instead and played from it.
 */
 void PlayerManagerC::init()
 {
-	int i;
+	MatchInput input;
 
 	if (!mLoaded)
+		createPlayers();
+
+	if (isPlayingReplay())
 	{
-		mDigits = new SpriteC(digitsPath, 20.0f, 20.0f, 1, 11);
-		mPauseScreenSprite = new SpriteC(pauseScreenPath, 384.0f, 512.0f, 1, 1);
+		mMatchSeed = mPlayback->getHeader()->seed;
+		mReplayButtons = 0;
+		mReplaySpeed = getRequestedReplaySpeed();
+		mReplayMilliseconds = 0;
+
+		restart(&mPlayback->getHeader()->initialInput);
+		return;
 	}
 
-	for (i = 0; i < MAX_NUMBER_OF_PLAYERS; i++)
+	readInput(&input);
+	restart(&input);
+
+	mLastInput = input;
+	mRunAheadMilliseconds = 0;
+	mRunAheadCost.reset();
+
+	if (getMatchLogDirectory() != NULL && !isDesyncCheckRequested())
 	{
-		if (!mLoaded)
-		{
-			char tileFileName[30];
-			char spriteSheetFileName[50];
-			char numberComponent[2] = { (char)i + '0', 0 };
-			strcpy(tileFileName, tilePath);
-			strcat(tileFileName, numberComponent);
-			strcat(tileFileName, fileType);
-
-			strcpy(spriteSheetFileName, spritePath);
-			strcat(spriteSheetFileName, numberComponent);
-			strcat(spriteSheetFileName, fileType);
-
-			mPlayerArray[i] = new PlayerC(spriteSheetFileName, tileFileName, mDigits, playerSpriteHeight, playerSpriteWidth, spawnXLocations[i], spawnYLocations[i], 0, 0, i, playerSpeed);
-		}
-		else
-		{
-			mPlayerArray[i]->reset(spawnXLocations[i], spawnYLocations[i], 0, 0);
-		}
+		if (mLog == NULL)
+			mLog = new MatchLogC();
 
-		if (mPlayerArray[i]->isConnected())
-		{
-			mPreviousControllerStates[i] = mPlayerArray[i]->getControllerState();
-		}
+		mLog->beginRecording(getMatchLogDirectory(), mMatchSeed, mCharacters, &input);
+	}
+
+	if (getReplayDirectory() != NULL && !isDesyncCheckRequested())
+	{
+		if (mRecorder == NULL)
+			mRecorder = new ReplayC();
+
+		mRecorder->beginRecording(getReplayDirectory(), mMatchSeed, mCharacters, &input);
+	}
+}
+
+/*
+	Puts every player back at their spawn location and starts the match over from its seed.
+	The given input is taken as held before the first tick, so pausing needs start to be pressed again.
+*/
+void PlayerManagerC::restart(const MatchInput *input)
+{
+	for (int i = 0; i < mNumberOfPlayers; i++)
+	{
+		mPlayerArray[i]->reset(spawnXLocations[i], spawnYLocations[i], 0, 0);
+		mPlayerArray[i]->setInput((input->connected & (1 << i)) != 0, &input->gamepads[i]);
+
+		ZeroMemory(&mPreviousControllerStates[i], sizeof(mPreviousControllerStates[i]));
+		mPreviousControllerStates[i].Gamepad = input->gamepads[i];
 	}
 
+	mRandom.seed(mMatchSeed);
+
 	mGameOver = false;
 	mWinner = 0;
 
-	mNumberOfPlayers = i;
-
 	mPaused = false;
 	mPausedBy = 0;
 
+	mTick = 0;
+
 	pauseScreenPosition.x = pauseScreenStartX;
 	pauseScreenPosition.y = pauseScreenStartY;
 
-	mLoaded = true;
+	saveState(&mSnapshot);
+	mStateHash = hashState(&mSnapshot, sizeof(mSnapshot));
 }
 
 /*
-	Updates players in game, applying pauses and attacks as necessary.
+	Reads the controllers and runs a tick of the match with their input, logging and recording the tick when the match is being logged or recorded.
+	While a replay plays, the tick is taken from the replay instead.
 */
 void PlayerManagerC::update(DWORD milliseconds)
+{
+	MatchInput input;
+
+	if (isPlayingReplay())
+	{
+		updateReplay(milliseconds);
+		return;
+	}
+
+	readInput(&input);
+
+	mLastInput = input;
+
+	GameEventManagerC::GetInstance()->setInputTimes(mInputSeconds);
+
+	if (milliseconds > 0)
+		mRunAheadMilliseconds = milliseconds;
+
+	if (mRecorder != NULL && mRecorder->isRecording())
+		mRecorder->record(&mSnapshot, &input, milliseconds);
+
+	tick(&input, milliseconds);
+
+	if (mLog != NULL && mLog->isRecording())
+		mLog->record(&input, milliseconds, mStateHash);
+}
+
+/*
+	Runs one tick of the match with the given input, applying pauses and attacks as necessary, and hashes the state it ends in.
+	Attacks are only applied on the active frames of a move.
+	The game events raised by the players and the pause menu during the tick are published as one batch at the end of it, so a tick simulated without publishing is silent.
+*/
+void PlayerManagerC::tick(const MatchInput *input, DWORD milliseconds)
 {
 	int playersLeft = 0;
 
+	GameEventManagerC::GetInstance()->beginTick();
+
 	for (int i = 0; i < mNumberOfPlayers; i++)
 	{
+		mPlayerArray[i]->setInput((input->connected & (1 << i)) != 0, &input->gamepads[i]);
+
 		if (mPlayerArray[i]->isConnected() && !mPlayerArray[i]->mDead)
 		{
 			playersLeft++;
@@ -102,7 +193,7 @@ void PlayerManagerC::update(DWORD milliseconds)
 			mPlayerArray[i]->update(milliseconds);
 		}
 
-		if (mPlayerArray[i]->mAttacking)
+		if (mPlayerArray[i]->isHitActive())
 		{
 			applyAttacks(mPlayerArray[i]);
 		}
@@ -111,18 +202,171 @@ void PlayerManagerC::update(DWORD milliseconds)
 	handleGameOver(playersLeft);
 
 	handlePauseMenu();
+
+	GameEventManagerC::GetInstance()->endTick();
+
+	mTick++;
+
+	saveState(&mSnapshot);
+	mStateHash = hashState(&mSnapshot, sizeof(mSnapshot));
 }
 
+/*
+	Reads the state of every player slot's controller, noting the time each was sampled at for measuring latency.
+*/
+void PlayerManagerC::readInput(MatchInput *input)
+{
+	ZeroMemory(input, sizeof(*input));
+
+	for (int i = 0; i < MAX_NUMBER_OF_PLAYERS; i++)
+	{
+		XINPUT_STATE state;
+
+		ZeroMemory(&state, sizeof(state));
+
+		DWORD result = XInputGetState(i, &state);
+
+		mInputSeconds[i] = getBenchmarkSeconds();
+
+		if (result == ERROR_SUCCESS)
+		{
+			input->connected |= 1 << i;
+			input->gamepads[i] = state.Gamepad;
+		}
+	}
+}
+
+/*
+	Copies everything the simulation changes over the match into the snapshot.
+*/
+void PlayerManagerC::saveState(MatchSnapshot *snapshot)
+{
+	ZeroMemory(snapshot, sizeof(*snapshot));
+
+	for (int i = 0; i < mNumberOfPlayers; i++)
+	{
+		mPlayerArray[i]->saveState(&snapshot->players[i]);
+		snapshot->previousGamepads[i] = mPreviousControllerStates[i].Gamepad;
+	}
+
+	snapshot->random = mRandom.getState();
+	snapshot->tick = mTick;
+	snapshot->pausedBy = mPausedBy;
+	snapshot->winner = mWinner;
+	snapshot->paused = mPaused;
+	snapshot->gameOver = mGameOver;
+}
+
+/*
+	Puts the match back in the state the snapshot was saved in.
+*/
+void PlayerManagerC::restoreState(const MatchSnapshot *snapshot)
+{
+	for (int i = 0; i < mNumberOfPlayers; i++)
+	{
+		mPlayerArray[i]->restoreState(&snapshot->players[i]);
+
+		ZeroMemory(&mPreviousControllerStates[i], sizeof(mPreviousControllerStates[i]));
+		mPreviousControllerStates[i].Gamepad = snapshot->previousGamepads[i];
+	}
+
+	mRandom.setState(snapshot->random);
+	mTick = snapshot->tick;
+	mPausedBy = snapshot->pausedBy;
+	mWinner = snapshot->winner;
+	mPaused = snapshot->paused;
+	mGameOver = snapshot->gameOver;
+
+	mSnapshot = *snapshot;
+	mStateHash = hashState(&mSnapshot, sizeof(mSnapshot));
+}
+
+/*
+	Loads a replay to play instead of the next match, picking the characters it was recorded with. Returns false if it cannot be played.
+*/
+bool PlayerManagerC::loadReplay(const char *path)
+{
+	if (mPlayback == NULL)
+		mPlayback = new ReplayC();
+
+	if (!mPlayback->load(path))
+	{
+		printf("Could not read the replay %s\n", path);
+		return false;
+	}
+
+	for (int i = 0; i < MAX_NUMBER_OF_PLAYERS; i++)
+		setCharacter(i, mPlayback->getHeader()->characters[i]);
+
+	printf("Playing a replay of %d ticks from %d bytes\n", mPlayback->getTickCount(), mPlayback->getFileBytes());
+
+	return true;
+}
+
+/*
+	Moves the replay being played to the given tick: restores the keyframe before it and simulates the ticks from there, at most a chunk of them.
+	The game events of the ticks simulated are not published, so seeking is silent.
+*/
+void PlayerManagerC::seekReplay(int tick)
+{
+	MatchSnapshot keyframe;
+	MatchInput input;
+	DWORD milliseconds;
+	int keyframeTick;
+
+	if (tick >= mPlayback->getTickCount())
+		tick = mPlayback->getTickCount() - 1;
+
+	if (tick < 0 || !mPlayback->getKeyframe(tick, &keyframe, &keyframeTick))
+		return;
+
+	restoreState(&keyframe);
+
+	GameEventManagerC::GetInstance()->setPublishing(false);
+
+	for (int i = keyframeTick; i < tick && mPlayback->getTick(i, &input, &milliseconds); i++)
+		this->tick(&input, milliseconds);
+
+	GameEventManagerC::GetInstance()->setPublishing(true);
+}
+
+bool PlayerManagerC::isPlayingReplay()
+{
+	return mPlayback != NULL && mPlayback->isLoaded();
+}
+
+/*
+	Draws the players, ahead of the match when run-ahead is on and the match is being played rather than paused, over or replayed.
+*/
 void PlayerManagerC::render()
 {
-	renderPlayers();
+	if (getRunAheadTicks() > 0 && !isPlayingReplay() && !mPaused && !mGameOver && mRunAheadMilliseconds > 0)
+		renderPlayersAhead(getRunAheadTicks());
+	else
+		renderPlayers();
 
 	if (mPaused)
 		renderPauseScreen();
 }
 
+/*
+	Deletes the players and the sprites they share, dropping their references to the match textures, and closes the log and replay of the match.
+	A replay that was played is done with, so the next match is played with the controllers.
+	The next call to init() creates them again.
+*/
 void PlayerManagerC::shutdown()
 {
+	mRunAheadCost.print(getRunAheadTicks());
+
+	if (mLog != NULL)
+		mLog->endRecording();
+
+	if (mRecorder != NULL)
+		mRecorder->endRecording();
+
+	if (mPlayback != NULL)
+		mPlayback->unload();
+
 	if (mLoaded)
 	{
 		for (int i = 0; i < mNumberOfPlayers; i++)
@@ -133,6 +377,56 @@ void PlayerManagerC::shutdown()
 		delete mPauseScreenSprite;
 		delete mDigits;
 	}
+
+	mLoaded = false;
+}
+
+/*
+	Adds every texture the match uses to the given scope, so they are resident before init() creates the sprites that share them.
+	Sprite sheets that were trimmed add their atlas texture, which is the one their sprites draw with, along with a collision mask for hits.
+	Only the sprite sheets of the characters picked for the match are added, in the palette of each slot.
+*/
+void PlayerManagerC::addAssets(TextureScopeC *scope)
+{
+	SpriteAtlasC atlas;
+	char fileName[50];
+
+	mAssetsAdded = true;
+
+	scope->add(digitsPath);
+	scope->add(pauseScreenPath);
+
+	for (int i = 0; i < MAX_NUMBER_OF_PLAYERS; i++)
+	{
+		getPlayerAssetPath(fileName, getCharacter(mCharacters[i])->spriteSheetPath, i);
+		atlas.load(fileName);
+		scope->add(atlas.getTexturePath(), true);
+
+		getPlayerAssetPath(fileName, tilePath, i);
+		scope->add(fileName);
+	}
+}
+
+/*
+	Picks the character a player slot plays from the roster. The pick takes effect when init() next creates the players.
+	It must be made before addAssets() builds the match's texture scope, which only holds the sprite sheets of the characters picked then
+	and is never rebuilt, as the desync check and replays do while the screens are set up.
+*/
+void PlayerManagerC::setCharacter(int playerNumber, int character)
+{
+	assert(playerNumber <= (MAX_NUMBER_OF_PLAYERS - 1));
+	assert(!mAssetsAdded);
+
+	if (getCharacter(character) != NULL)
+		mCharacters[playerNumber] = character;
+}
+
+/*
+	Sets the seed of the match's random number generator. It takes effect when init() next starts a match.
+*/
+void PlayerManagerC::setMatchSeed(unsigned long long seed)
+{
+	mMatchSeed = seed;
 }
 
 PlayerC* PlayerManagerC::getPlayer(int playerNumber)
@@ -144,8 +438,116 @@ PlayerC* PlayerManagerC::getPlayer(int playerNumber)
 
 /* Private functions */
 
+/*
+	Creates the sprites the players share and every player, as the character picked for its slot, sharing that character's tables with any other player of it.
+*/
+void PlayerManagerC::createPlayers()
+{
+	mDigits = new SpriteC(digitsPath, 20.0f, 20.0f, 1, 11);
+	mPauseScreenSprite = new SpriteC(pauseScreenPath, 384.0f, 512.0f, 1, 1);
+
+	for (int i = 0; i < MAX_NUMBER_OF_PLAYERS; i++)
+	{
+		const CharacterDefinition *character = getCharacter(mCharacters[i]);
+		char tileFileName[30];
+		char spriteSheetFileName[50];
+
+		getPlayerAssetPath(tileFileName, tilePath, i);
+		getPlayerAssetPath(spriteSheetFileName, character->spriteSheetPath, i);
+
+		mPlayerArray[i] = new PlayerC(character, spriteSheetFileName, tileFileName, mDigits, spawnXLocations[i], spawnYLocations[i], 0, 0, i, playerSpeed);
+	}
+
+	mNumberOfPlayers = MAX_NUMBER_OF_PLAYERS;
+	mLoaded = true;
+}
+
+/*
+	Runs the ticks of the replay being played that fit in the time since the last update, scaled by the replay speed,
+	after seeking when the first controller's shoulder buttons are pressed and changing speed when its D-pad is pressed.
+	The game events of the ticks are published as one batch, so fast-forwarding plays each sound once per update rather than once per tick.
+	Once the replay runs out, play returns to the main menu.
+*/
+void PlayerManagerC::updateReplay(DWORD milliseconds)
+{
+	XINPUT_STATE controls;
+	MatchInput input;
+	DWORD tickMilliseconds;
+	int ticks = 0;
+
+	ZeroMemory(&controls, sizeof(controls));
+	XInputGetState(0, &controls);
+
+	WORD pressed = controls.Gamepad.wButtons & ~mReplayButtons;
+
+	mReplayButtons = controls.Gamepad.wButtons;
+
+	if (pressed & XINPUT_GAMEPAD_LEFT_SHOULDER)
+		seekReplay(mTick > REPLAY_SEEK_TICKS ? mTick - REPLAY_SEEK_TICKS : 0);
+	else if (pressed & XINPUT_GAMEPAD_RIGHT_SHOULDER)
+		seekReplay(mTick + REPLAY_SEEK_TICKS);
+
+	if ((pressed & XINPUT_GAMEPAD_DPAD_RIGHT) && mReplaySpeed < REPLAY_MAX_SPEED)
+		mReplaySpeed *= 2;
+	else if ((pressed & XINPUT_GAMEPAD_DPAD_LEFT) && mReplaySpeed > 1)
+		mReplaySpeed /= 2;
+
+	if (mReplaySpeed == REPLAY_UNCAPPED)
+	{
+		playReplayUncapped();
+		return;
+	}
+
+	mReplayMilliseconds += milliseconds * mReplaySpeed;
+
+	GameEventManagerC::GetInstance()->beginBatch();
+
+	while (!mGameOver && mPlayback->getTick(mTick, &input, &tickMilliseconds) && (int)tickMilliseconds <= mReplayMilliseconds && ticks < MAX_REPLAY_TICKS_PER_UPDATE)
+	{
+		tick(&input, tickMilliseconds);
+
+		mReplayMilliseconds -= tickMilliseconds;
+		ticks++;
+	}
+
+	GameEventManagerC::GetInstance()->endBatch();
+
+	if (ticks == MAX_REPLAY_TICKS_PER_UPDATE)
+		mReplayMilliseconds = 0;
+
+	if (!mGameOver && mTick >= (unsigned int)mPlayback->getTickCount())
+		ScreenManagerC::GetInstance()->returnToMainMenu();
+}
+
+/*
+	Runs the rest of the replay in one update without publishing its game events, so nothing is drawn or heard until the match ends,
+	and prints how fast it ran.
+*/
+void PlayerManagerC::playReplayUncapped()
+{
+	MatchInput input;
+	DWORD tickMilliseconds;
+	unsigned int firstTick = mTick;
+	DWORD start = GetTickCount();
+
+	GameEventManagerC::GetInstance()->setPublishing(false);
+
+	while (!mGameOver && mPlayback->getTick(mTick, &input, &tickMilliseconds))
+		tick(&input, tickMilliseconds);
+
+	GameEventManagerC::GetInstance()->setPublishing(true);
+
+	DWORD elapsed = GetTickCount() - start;
+
+	printf("Played %u ticks of the replay in %lu ms\n", mTick - firstTick, elapsed);
+
+	if (!mGameOver)
+		ScreenManagerC::GetInstance()->returnToMainMenu();
+}
+
 /*
 	If there are one or less players left the game is over and the winner is the one that isn't dead.
+	Rumble is only stopped for a tick that is being played, not one simulated silently.
 */
 void PlayerManagerC::handleGameOver(int playersLeft)
 {
@@ -153,21 +555,20 @@ void PlayerManagerC::handleGameOver(int playersLeft)
 	{
 		mGameOver = true;
 
+		if (GameEventManagerC::GetInstance()->isPublishing())
+			HapticsManagerC::GetInstance()->stopAll();
+
 		for (int i = 0; i < mNumberOfPlayers; i++)
 		{
-			if (mPlayerArray[i]->isConnected())
-			{
-				mPlayerArray[i]->vibrate(0, 0);
-
-				if (!mPlayerArray[i]->mDead)
-					mWinner = i;
-			}
+			if (mPlayerArray[i]->isConnected() && !mPlayerArray[i]->mDead)
+				mWinner = i;
 		}
 	}
 }
 
 /*
-	Manages the pause menu states and plays sounds when transitioning.
+	Manages the pause menu states and raises menu sound events when transitioning.
+	Leaving the match from the pause menu only happens on a tick that is being played, so seeking, checking or running ahead through it stays in the match.
 */
 void PlayerManagerC::handlePauseMenu()
 {
@@ -185,20 +586,22 @@ void PlayerManagerC::handlePauseMenu()
 				{
 					mPaused = false;
 
-					SoundManagerC::GetInstance()->playCloseMenuSound();
+					GameEventManagerC::GetInstance()->emit(GameEventType::MenuSound, MENU_PLAYER_ID, NULL, MenuSound::Close, 0.0f);
 				}
 				else if (!mPaused)
 				{
 					mPaused = true;
 					mPausedBy = i;
 
-					SoundManagerC::GetInstance()->playMenuSound();
+					GameEventManagerC::GetInstance()->emit(GameEventType::MenuSound, MENU_PLAYER_ID, NULL, MenuSound::Open, 0.0f);
 				}
 			}
 			else if (mPaused && controllerState.Gamepad.wButtons & XINPUT_GAMEPAD_BACK && i == mPausedBy)
 			{
 				mPaused = false;
-				ScreenManagerC::GetInstance()->returnToMainMenu();
+
+				if (GameEventManagerC::GetInstance()->isPublishing())
+					ScreenManagerC::GetInstance()->returnToMainMenu();
 			}
 
 			mPreviousControllerStates[i] = controllerState;
@@ -233,36 +636,100 @@ void PlayerManagerC::renderPlayers()
 	}
 }
 
+/*
+	Saves the match, runs the given number of ticks with the input and length of the last update, draws the players and restores the match.
+	The input repeats the last tick's, so no button is pressed anew and the ticks cannot pause or leave the match; their game events are not published,
+	and the event manager's tick is put back with the match, so the events of the next real tick are stamped with it.
+	The time taken apart from drawing is added to the cost of run-ahead.
+*/
+void PlayerManagerC::renderPlayersAhead(int ticks)
+{
+	MatchSnapshot present = mSnapshot;
+	DWORD eventTick = GameEventManagerC::GetInstance()->getTick();
+	double start = getBenchmarkSeconds();
+
+	GameEventManagerC::GetInstance()->setPublishing(false);
+
+	for (int i = 0; i < ticks && !mGameOver; i++)
+		tick(&mLastInput, mRunAheadMilliseconds);
+
+	GameEventManagerC::GetInstance()->setPublishing(true);
+	GameEventManagerC::GetInstance()->setTick(eventTick);
+
+	double simulated = getBenchmarkSeconds();
+
+	renderPlayers();
+
+	double rendered = getBenchmarkSeconds();
+
+	restoreState(&present);
+
+	mRunAheadCost.add((simulated - start) + (getBenchmarkSeconds() - rendered));
+}
+
 void PlayerManagerC::renderPauseScreen()
 {
 	mPauseScreenSprite->render(pauseScreenPosition, 0, 0, false);
 }
 
 /*
-	Returns whether or not two player's hitboxes are overlapping.
+	Builds the path of a per-player asset by appending the player number and file type to the given prefix.
+*/
+void PlayerManagerC::getPlayerAssetPath(char *destination, const char *prefix, int playerNumber)
+{
+	char numberComponent[2] = { (char)playerNumber + '0', 0 };
+
+	strcpy(destination, prefix);
+	strcat(destination, numberComponent);
+	strcat(destination, fileType);
+}
+
+/*
+	Returns whether or not the attacker's hitbox overlaps the defender's hurtbox.
+	Once the boxes overlap, the pixels the players are drawn with must overlap too, within both boxes, when their sprite sheets have collision masks.
 */
 bool PlayerManagerC::collidesWithPlayer(PlayerC *attacker, PlayerC *defender)
 {
 	bool collisionDetected = false;
+	SimCoord2D hitBoxStart, hitBoxEnd, hurtBoxStart, hurtBoxEnd;
 
-	if (attacker == defender)
+	if (attacker == defender || !attacker->getHitBox(&hitBoxStart, &hitBoxEnd))
 	{
 		collisionDetected = false;
 	}
 	else
 	{
-		Coord2D attackerWithStartOffset = offsetCoordinate(attacker->getPosition(), attacker->mSpriteHandler->mHitBoxStart);
-		Coord2D defenderWithStartOffset = offsetCoordinate(defender->getPosition(), defender->mSpriteHandler->mHitBoxStart);
-		Coord2D attackerWithEndOffset = offsetCoordinate(attacker->getPosition(), attacker->mSpriteHandler->mHitBoxEnd);
-		Coord2D defenderWithEndOffset = offsetCoordinate(defender->getPosition(), defender->mSpriteHandler->mHitBoxEnd);
+		defender->getHurtBox(&hurtBoxStart, &hurtBoxEnd);
+
+		SimCoord2D attackerWithStartOffset = offsetCoordinate(attacker->getSimPosition(), hitBoxStart);
+		SimCoord2D defenderWithStartOffset = offsetCoordinate(defender->getSimPosition(), hurtBoxStart);
+		SimCoord2D attackerWithEndOffset = offsetCoordinate(attacker->getSimPosition(), hitBoxEnd);
+		SimCoord2D defenderWithEndOffset = offsetCoordinate(defender->getSimPosition(), hurtBoxEnd);
 
 		collisionDetected = boxesIntersect(attackerWithStartOffset, attackerWithEndOffset, defenderWithStartOffset, defenderWithEndOffset);
+
+		CollisionFrame attackerFrame;
+		CollisionFrame defenderFrame;
+
+		if (collisionDetected && attacker->getCollisionFrame(&attackerFrame) && defender->getCollisionFrame(&defenderFrame))
+		{
+			SimScalar overlapLeft = attackerWithStartOffset.x > defenderWithStartOffset.x ? attackerWithStartOffset.x : defenderWithStartOffset.x;
+			SimScalar overlapTop = attackerWithStartOffset.y < defenderWithStartOffset.y ? attackerWithStartOffset.y : defenderWithStartOffset.y;
+			SimScalar overlapRight = attackerWithEndOffset.x < defenderWithEndOffset.x ? attackerWithEndOffset.x : defenderWithEndOffset.x;
+			SimScalar overlapBottom = attackerWithEndOffset.y > defenderWithEndOffset.y ? attackerWithEndOffset.y : defenderWithEndOffset.y;
+			int left = roundToInt(overlapLeft);
+			int top = roundToInt(-overlapTop);
+			int right = roundToInt(overlapRight);
+			int bottom = roundToInt(-overlapBottom);
+
+			collisionDetected = CollisionMaskC::clipFrame(&attackerFrame, left, top, right, bottom) && CollisionMaskC::framesOverlap(&attackerFrame, &defenderFrame);
+		}
 	}
 
 	return collisionDetected;
 }
 
-bool PlayerManagerC::boxesIntersect(Coord2D topLeftA, Coord2D bottomRightA, Coord2D topLeftB, Coord2D bottomRightB)
+bool PlayerManagerC::boxesIntersect(SimCoord2D topLeftA, SimCoord2D bottomRightA, SimCoord2D topLeftB, SimCoord2D bottomRightB)
 {
 	return topLeftA.x < bottomRightB.x && bottomRightA.x > topLeftB.x && bottomRightA.y < topLeftB.y && topLeftA.y > bottomRightB.y;
 }
@@ -270,11 +737,164 @@ bool PlayerManagerC::boxesIntersect(Coord2D topLeftA, Coord2D bottomRightA, Coor
 /*
 	Returns a coordinate that is the sum of the two given coordinates.
 */
-Coord2D PlayerManagerC::offsetCoordinate(Coord2D coordinate, Coord2D offset)
+SimCoord2D PlayerManagerC::offsetCoordinate(SimCoord2D coordinate, SimCoord2D offset)
 {
-	Coord2D withOffset = coordinate;
+	SimCoord2D withOffset = coordinate;
 	withOffset.x += offset.x;
 	withOffset.y += offset.y;
 
 	return withOffset;
+}
+
+/*
+	Fills in the input of every slot on a tick of the determinism check's match. Each player holds one of a set of moves for a while,
+	picked from the tick and slot alone: standing, walking and dashing either way, jumping, every attack and special, guarding, rolling and taunting.
+	Start and back are never pressed, so the match is never paused or left.
+*/
+static void getScriptedInput(unsigned int tick, MatchInput *input)
+{
+	ZeroMemory(input, sizeof(*input));
+
+	input->connected = (1 << MAX_NUMBER_OF_PLAYERS) - 1;
+
+	for (int i = 0; i < MAX_NUMBER_OF_PLAYERS; i++)
+	{
+		XINPUT_GAMEPAD *gamepad = &input->gamepads[i];
+		unsigned int segment = (tick + i * 7) / DETERMINISM_HOLD_TICKS;
+		unsigned int noise = (segment * 4 + i) * 2654435761u;
+		short side = (noise >> 8) & 1 ? 32767 : -32768;
+
+		switch ((noise >> 16) % DETERMINISM_SCRIPTED_MOVES)
+		{
+		case 0:
+			break;
+		case 1:
+		case 2:
+			gamepad->sThumbLX = side;
+			break;
+		case 3:
+			gamepad->sThumbLX = side;
+			gamepad->sThumbLY = (segment & 1) ? 32767 : 0;
+			break;
+		case 4:
+			gamepad->sThumbLY = 32767;
+			break;
+		case 5:
+			gamepad->wButtons = (tick & 4) ? XINPUT_GAMEPAD_A : 0;
+			break;
+		case 6:
+			gamepad->wButtons = XINPUT_GAMEPAD_A;
+			gamepad->sThumbLY = 32767;
+			break;
+		case 7:
+			gamepad->wButtons = XINPUT_GAMEPAD_A;
+			gamepad->sThumbLY = -32768;
+			break;
+		case 8:
+			gamepad->wButtons = XINPUT_GAMEPAD_A;
+			gamepad->sThumbLX = side;
+			break;
+		case 9:
+			gamepad->wButtons = XINPUT_GAMEPAD_B;
+			gamepad->sThumbLY = -32768;
+			break;
+		case 10:
+			gamepad->wButtons = XINPUT_GAMEPAD_B;
+			gamepad->sThumbLY = 32767;
+			break;
+		case 11:
+			gamepad->wButtons = XINPUT_GAMEPAD_B;
+			gamepad->sThumbLX = side;
+			break;
+		case 12:
+			gamepad->bLeftTrigger = 255;
+			break;
+		case 13:
+			gamepad->bRightTrigger = 255;
+			gamepad->sThumbLX = side;
+			break;
+		case 14:
+			gamepad->wButtons = XINPUT_GAMEPAD_X;
+			break;
+		}
+	}
+}
+
+/*
+	Plays a scripted match through tick() from a fixed seed, twice, and compares the hash of the state it ends in
+	with the one checked in for this build, in floats or in fixed point. A mismatch, or two runs that differ, fails the benchmarks.
+	The game has not started when the benchmarks run, so the managers the match needs are created here and no texture is ever uploaded:
+	hits are decided by the boxes alone, and the hash depends on the simulation's code and not on the assets.
+	When a change to the simulation is meant to change its results, the expected hash is updated to the one printed.
+*/
+void benchmarkDeterminism()
+{
+	AssetPackageC::CreateInstance();
+	TextureManagerC::CreateInstance();
+	GameEventManagerC::CreateInstance();
+	PlayerManagerC::CreateInstance();
+
+	AssetPackageC::GetInstance()->init();
+	TextureManagerC::GetInstance()->init();
+	GameEventManagerC::GetInstance()->init();
+	GameEventManagerC::GetInstance()->setPublishing(false);
+
+	PlayerManagerC *match = PlayerManagerC::GetInstance();
+	MatchInput input;
+	MatchSnapshot state;
+	unsigned long long hashes[2];
+	double seconds = 0.0;
+
+	match->setMatchSeed(DETERMINISM_SEED);
+	match->init();
+
+	for (int run = 0; run < 2; run++)
+	{
+		getScriptedInput(0, &input);
+		match->restart(&input);
+
+		double start = getBenchmarkSeconds();
+
+		for (unsigned int tick = 0; tick < DETERMINISM_TICKS; tick++)
+		{
+			getScriptedInput(tick, &input);
+			match->tick(&input, DETERMINISM_TICK_MILLISECONDS);
+		}
+
+		seconds += getBenchmarkSeconds() - start;
+		hashes[run] = match->getStateHash();
+	}
+
+	match->saveState(&state);
+
+	printf("  %d ticks of a %s match: %.2f us per tick, health %d %d %d %d\n", DETERMINISM_TICKS,
+#ifdef FIXED_POINT_SIMULATION
+		"fixed point",
+#else
+		"float",
+#endif
+		seconds * 1e6 / (2.0 * DETERMINISM_TICKS), state.players[0].health, state.players[1].health, state.players[2].health, state.players[3].health);
+#ifdef DETERMINISM_EXPECTED_HASH
+	printf("  final state hash %016llx, expected %016llx\n", hashes[0], DETERMINISM_EXPECTED_HASH);
+#else
+	printf("  final state hash %016llx, no expected float hash is checked in for this compiler; check this one in to compare against it\n", hashes[0]);
+#endif
+
+	if (hashes[0] != hashes[1])
+	{
+		printf("  DETERMINISM CHECK FAILED: the same match ended in %016llx and then %016llx\n", hashes[0], hashes[1]);
+		failBenchmark();
+	}
+#ifdef DETERMINISM_EXPECTED_HASH
+	else if (hashes[0] != DETERMINISM_EXPECTED_HASH)
+	{
+		printf("  DETERMINISM CHECK FAILED: the simulation no longer gives the results checked in for this build\n");
+		failBenchmark();
+	}
+#endif
+
+	match->shutdown();
+	GameEventManagerC::GetInstance()->shutdown();
+	TextureManagerC::GetInstance()->shutdown();
+	AssetPackageC::GetInstance()->shutdown();
 }
\ No newline at end of file
@@ -3,13 +3,50 @@
 	PlayerManager.h		written by Louis Hofer
 
 	This is a singleton class that is responsible for managing the state and interaction between all players it instantiates.
+	Each player slot plays the character picked for it from the roster, drawn with the palette of the slot.
+	The match owns the random number generator anything in it draws from, seeded explicitly when the match starts.
+	Each tick, the controller input of every slot is read once and handed to the players, then the state of the match is hashed,
+	so the same seed and input always give the same hashes and two runs of a match can be compared tick by tick.
+	A match can be recorded as a replay, and a replay can be played instead of the controllers, seeking through it by restoring its keyframes
+	and fast-forwarding it by running many ticks in an update, of which only the last is drawn.
+	With run-ahead on, the players are drawn a tick or two ahead of the match, simulated from a saved state that is then restored.
 */
 
 #include "Player.h"
+#include "random.h"
+#include "RunAhead.h"
 #include "types.h"
 
 #define MAX_NUMBER_OF_PLAYERS 4
 
+class MatchLogC;
+class ReplayC;
+
+/*
+	The controller input of every player slot for one tick: a bit for each connected slot and the gamepad of each.
+	Along with the length of the tick, it is everything the simulation is given from outside.
+*/
+struct MatchInput
+{
+	unsigned int connected;
+	XINPUT_GAMEPAD gamepads[MAX_NUMBER_OF_PLAYERS];
+};
+
+/*
+	Everything the simulation changes over a match, cleared before it is filled so it can be hashed and compared as bytes.
+*/
+struct MatchSnapshot
+{
+	PlayerSnapshot players[MAX_NUMBER_OF_PLAYERS];
+	XINPUT_GAMEPAD previousGamepads[MAX_NUMBER_OF_PLAYERS];
+	RandomState random;
+	unsigned int tick;
+	int pausedBy;
+	int winner;
+	bool paused;
+	bool gameOver;
+};
+
 class PlayerManagerC
 {
 public:
@@ -19,9 +56,27 @@ public:
 	~PlayerManagerC() {};
 
 	void init();
+	void restart(const MatchInput *input);
 	void update(DWORD milliseconds);
+	void tick(const MatchInput *input, DWORD milliseconds);
+	void readInput(MatchInput *input);
+	void saveState(MatchSnapshot *snapshot);
+	void restoreState(const MatchSnapshot *snapshot);
+
+	bool loadReplay(const char *path);
+	void seekReplay(int tick);
+	bool isPlayingReplay();
 	void render();
 	void shutdown();
+	void addAssets(TextureScopeC *scope);
+	void setCharacter(int playerNumber, int character);
+	void setMatchSeed(unsigned long long seed);
+
+	unsigned long long getMatchSeed() { return mMatchSeed; };
+	unsigned long long getStateHash() { return mStateHash; };
+	unsigned int getTick() { return mTick; };
+	int getPlayerCharacter(int playerNumber) { return mCharacters[playerNumber]; };
+	RandomC *getRandom() { return &mRandom; };
 
 	PlayerC* getPlayer(int playerNumber);
 
@@ -33,23 +88,53 @@ private:
 	/* Private functions */
 	PlayerManagerC() {};
 
+	void createPlayers();
+	void updateReplay(DWORD milliseconds);
+	void playReplayUncapped();
 	void handleGameOver(int playersLeft);
 	void handlePauseMenu();
 	void applyAttacks(PlayerC *player);
 	void renderPlayers();
+	void renderPlayersAhead(int ticks);
 	void renderPauseScreen();
+	void getPlayerAssetPath(char *destination, const char *prefix, int playerNumber);
 
 	bool collidesWithPlayer(PlayerC *attacker, PlayerC *defender);
-	bool boxesIntersect(Coord2D topLeftA, Coord2D bottomRightA, Coord2D topLeftB, Coord2D bottomRightB);
+	bool boxesIntersect(SimCoord2D topLeftA, SimCoord2D bottomRightA, SimCoord2D topLeftB, SimCoord2D bottomRightB);
 
-	Coord2D offsetCoordinate(Coord2D coordinate, Coord2D offset);
+	SimCoord2D offsetCoordinate(SimCoord2D coordinate, SimCoord2D offset);
 
 	/* Private data members */
 	bool mPaused;
 	bool mLoaded = false;
+	bool mAssetsAdded = false;
 
 	int mPausedBy;
 	int mNumberOfPlayers;
+	int mCharacters[MAX_NUMBER_OF_PLAYERS] = { 0, 0, 0, 0 };
+
+	unsigned int mTick;
+
+	unsigned long long mMatchSeed = 0;
+	unsigned long long mStateHash;
+
+	RandomC mRandom;
+
+	MatchSnapshot mSnapshot;
+
+	MatchLogC *mLog = NULL;
+	ReplayC *mRecorder = NULL;
+	ReplayC *mPlayback = NULL;
+
+	WORD mReplayButtons;
+
+	int mReplaySpeed;
+	int mReplayMilliseconds;
+
+	MatchInput mLastInput;
+	double mInputSeconds[MAX_NUMBER_OF_PLAYERS];
+	DWORD mRunAheadMilliseconds;
+	RunAheadCostC mRunAheadCost;
 
 	static PlayerManagerC *sInstance;
 
@@ -63,15 +148,12 @@ private:
 	/* Private constant data */
 	const float pauseScreenStartX = -256.0f;
 	const float pauseScreenStartY = 192.0f;
-	const float playerSpriteHeight = 144.0f;
-	const float playerSpriteWidth = 144.0f;
 	const float playerSpeed = 0.3f;
 
 	const float spawnXLocations[4] = { -450, 360, -180, 90 };
 	const float spawnYLocations[4] = { -50, -50, -50, -50 };
 
 	const char *tilePath = "Screens/Player";
-	const char *spritePath = "SpriteSheets/KirbySpriteSheet";
 	const char *fileType = ".png";
 
 	char *digitsPath = "SpriteSheets/digits.png";
@@ -0,0 +1,573 @@
+/*
+	PlayerStateMachine.cpp
+
+	This file contains the rules a player's transitions are built from, the transition table generated from them and the input classification.
+	The rules are constexpr functions of a table index, each answering one question about the transition it stands for,
+	so the compiler evaluates all of them for every index and the game only ever reads the results.
+*/
+
+#define _CRT_SECURE_NO_WARNINGS
+
+#include <stdio.h>
+#include <string.h>
+#include <utility>
+#include "PlayerStateMachine.h"
+#include "Player.h"
+#include "Benchmark.h"
+
+#define BENCHMARK_PLAYERS 4
+#define BENCHMARK_TICKS 4000000
+#define BENCHMARK_HOLD_TICKS 12
+#define BENCHMARK_CHECK_INPUTS 20000
+
+/*
+	What a table index stands for: the state and facing a transition leaves from, and the intent it is taken for.
+*/
+constexpr int getStartState(int index) { return index / PLAYER_INTENTS / 2; }
+constexpr bool startsFacingLeft(int index) { return index / PLAYER_INTENTS % 2 != 0; }
+constexpr int getHorizontalIntent(int index) { return index % HorizontalIntent::Count; }
+constexpr int getVerticalIntent(int index) { return index / HorizontalIntent::Count % VerticalIntent::Count; }
+constexpr int getButtonIntent(int index) { return index % PLAYER_INTENTS / (HorizontalIntent::Count * VerticalIntent::Count); }
+
+constexpr bool holdsDirection(int index) { return getHorizontalIntent(index) != HorizontalIntent::None; }
+constexpr bool holdsLeft(int index) { return getHorizontalIntent(index) == HorizontalIntent::Left || getHorizontalIntent(index) == HorizontalIntent::LeftTapped; }
+constexpr bool holdsUp(int index) { return getVerticalIntent(index) == VerticalIntent::Up || getVerticalIntent(index) == VerticalIntent::UpPressed; }
+constexpr bool holdsDown(int index) { return getVerticalIntent(index) == VerticalIntent::Down; }
+constexpr bool pressesAttack(int index) { return getButtonIntent(index) == ButtonIntent::AttackPressed; }
+
+/*
+	Movement: a held direction walks, or runs at twice the speed while dashing, and turns the player to face it.
+	A dash starts when a grounded player taps the direction they already face. Letting go of the stick stops the player and the dash.
+*/
+constexpr bool startsDash(int index)
+{
+	return !isDashing(getStartState(index)) && !isAirborne(getStartState(index)) &&
+		((getHorizontalIntent(index) == HorizontalIntent::LeftTapped && startsFacingLeft(index)) ||
+		(getHorizontalIntent(index) == HorizontalIntent::RightTapped && !startsFacingLeft(index)));
+}
+
+constexpr bool dashesAfterMovement(int index)
+{
+	return holdsDirection(index) && (isDashing(getStartState(index)) || startsDash(index));
+}
+
+constexpr int getStateAfterMovement(int index)
+{
+	return (getStartState(index) & ~1) | (dashesAfterMovement(index) ? 1 : 0);
+}
+
+constexpr bool facesLeft(int index)
+{
+	return holdsDirection(index) ? holdsLeft(index) : startsFacingLeft(index);
+}
+
+constexpr int getMovementVelocityX(int index)
+{
+	return !holdsDirection(index) ? 0 : (dashesAfterMovement(index) ? 2 : 1) * (holdsLeft(index) ? -1 : 1);
+}
+
+constexpr int getMovementAnimation(int index)
+{
+	return holdsDirection(index) ?
+		(isAirborne(getStartState(index)) ? Jump : dashesAfterMovement(index) ? Dash : Walk) + (holdsLeft(index) ? 1 : 0) :
+		(isAirborne(getStartState(index)) ? NO_TRANSITION_ANIMATION : Stand + (facesLeft(index) ? 1 : 0));
+}
+
+/*
+	Action: the move the button picks, given the stick and whether the player is on the ground, as an animation index facing right.
+*/
+constexpr int getAttack(int index)
+{
+	return !isAirborne(getStateAfterMovement(index)) && holdsUp(index) ? UpAttack :
+		!isAirborne(getStateAfterMovement(index)) && holdsDown(index) ? DownAttack :
+		!isAirborne(getStateAfterMovement(index)) && isDashing(getStateAfterMovement(index)) && pressesAttack(index) ? DashAttack :
+		!isAirborne(getStateAfterMovement(index)) && holdsDirection(index) ? SideAttack :
+		!isAirborne(getStateAfterMovement(index)) ? RapidPunch :
+		pressesAttack(index) ? Aerial : NO_TRANSITION_ANIMATION;
+}
+
+constexpr int getSpecial(int index)
+{
+	return holdsDown(index) ? DownSpecial : holdsUp(index) ? UpSpecial : holdsDirection(index) ? SideSpecial : NO_TRANSITION_ANIMATION;
+}
+
+constexpr int getMove(int index)
+{
+	return getButtonIntent(index) == ButtonIntent::Taunt ? Taunting :
+		getButtonIntent(index) == ButtonIntent::Attack || getButtonIntent(index) == ButtonIntent::AttackPressed ? getAttack(index) :
+		getButtonIntent(index) == ButtonIntent::Special ? getSpecial(index) :
+		getButtonIntent(index) == ButtonIntent::Guard ? (holdsDirection(index) ? DodgeRoll : Block) : NO_TRANSITION_ANIMATION;
+}
+
+/*
+	The taunt and the down special have a single animation; every other move turns with the player.
+*/
+constexpr int getActionAnimation(int index)
+{
+	return getMove(index) == NO_TRANSITION_ANIMATION || getMove(index) == Taunting || getMove(index) == DownSpecial ? getMove(index) :
+		getMove(index) + (facesLeft(index) ? 1 : 0);
+}
+
+constexpr int getActionEvent(int index)
+{
+	return getMove(index) == Taunting ? GameEventType::Taunted :
+		getMove(index) == DownSpecial || getMove(index) == UpSpecial || getMove(index) == SideSpecial ? GameEventType::SpecialUsed :
+		getMove(index) == DodgeRoll || getMove(index) == Block ? GameEventType::Dodged :
+		getMove(index) != NO_TRANSITION_ANIMATION ? GameEventType::Attacked : GameEventType::Invalid;
+}
+
+/*
+	Moves that are performed standing still stop the player; dash attacks, aerials, up specials and dodge rolls carry their momentum.
+*/
+constexpr bool stopsPlayer(int index)
+{
+	return getMove(index) == Taunting || getMove(index) == UpAttack || getMove(index) == DownAttack || getMove(index) == SideAttack ||
+		getMove(index) == RapidPunch || getMove(index) == DownSpecial || getMove(index) == SideSpecial || getMove(index) == Block;
+}
+
+/*
+	The down special drops the player to the ground and the up special launches them as high as a double jump, both keeping a dash.
+	A dash attack ends the dash.
+*/
+constexpr int getStateAfterAction(int index)
+{
+	return getMove(index) == DownSpecial ? getLandedState(getStateAfterMovement(index)) :
+		getMove(index) == UpSpecial ? PlayerState::DoubleJumping | (getStateAfterMovement(index) & 1) :
+		getMove(index) == DashAttack ? getStateAfterMovement(index) & ~1 : getStateAfterMovement(index);
+}
+
+constexpr int getActionVelocityY(int index)
+{
+	return getMove(index) == DownSpecial || (getMove(index) == SideSpecial && !isAirborne(getStateAfterMovement(index))) ? TransitionVelocity::Dive :
+		getMove(index) == UpSpecial ? TransitionVelocity::HighRise : TransitionVelocity::Keep;
+}
+
+constexpr int getDamage(int index)
+{
+	return getMove(index) == UpAttack || getMove(index) == DownAttack || getMove(index) == SideAttack || getMove(index) == Aerial ? TransitionDamage::Large :
+		getMove(index) == DashAttack || getMove(index) == RapidPunch || getActionEvent(index) == GameEventType::SpecialUsed ? TransitionDamage::Small : TransitionDamage::Keep;
+}
+
+/*
+	Every attack button press counts as an attack, even an airborne one held from an earlier tick; specials only count when one is used.
+*/
+constexpr int getAction(int index)
+{
+	return getButtonIntent(index) == ButtonIntent::Taunt ? PlayerAction::Taunt :
+		getButtonIntent(index) == ButtonIntent::Attack || getButtonIntent(index) == ButtonIntent::AttackPressed ? PlayerAction::Attack :
+		getButtonIntent(index) == ButtonIntent::Special && getMove(index) != NO_TRANSITION_ANIMATION ? PlayerAction::Special :
+		getButtonIntent(index) == ButtonIntent::Guard ? PlayerAction::Dodge : PlayerAction::Invalid;
+}
+
+/*
+	Leap: pressing up jumps from the ground, or double jumps in the air, until the player has double jumped.
+*/
+constexpr bool leaps(int index)
+{
+	return getVerticalIntent(index) == VerticalIntent::UpPressed && !isDoubleJumping(getStateAfterAction(index));
+}
+
+constexpr int getEndState(int index)
+{
+	return !leaps(index) ? getStateAfterAction(index) :
+		(isAirborne(getStateAfterAction(index)) ? PlayerState::DoubleJumping : PlayerState::Jumping) | (getStateAfterAction(index) & 1);
+}
+
+constexpr PlayerTransition makeTransition(int index)
+{
+	return PlayerTransition
+	{
+		{
+			(signed char)getMovementAnimation(index),
+			(signed char)getActionAnimation(index),
+			(signed char)(leaps(index) ? Jump + (facesLeft(index) ? 1 : 0) : NO_TRANSITION_ANIMATION)
+		},
+		{
+			(unsigned char)(startsDash(index) ? GameEventType::Dashed : GameEventType::Invalid),
+			(unsigned char)getActionEvent(index),
+			(unsigned char)(leaps(index) ? GameEventType::Jumped : GameEventType::Invalid)
+		},
+		(signed char)(stopsPlayer(index) ? 0 : getMovementVelocityX(index)),
+		(unsigned char)(leaps(index) ? TransitionVelocity::Rise : getActionVelocityY(index)),
+		(unsigned char)getDamage(index),
+		(unsigned char)getAction(index),
+		(unsigned char)getEndState(index),
+		leaps(index) && !isAirborne(getStateAfterAction(index))
+	};
+}
+
+struct PlayerTransitionTable
+{
+	PlayerTransition transitions[PLAYER_TRANSITIONS];
+};
+
+template <int... Indexes>
+constexpr PlayerTransitionTable buildTransitionTable(std::integer_sequence<int, Indexes...>)
+{
+	return PlayerTransitionTable{ { makeTransition(Indexes)... } };
+}
+
+static constexpr PlayerTransitionTable transitionTable = buildTransitionTable(std::make_integer_sequence<int, PLAYER_TRANSITIONS>());
+
+static_assert(transitionTable.transitions[PlayerState::Grounded * 2 * PLAYER_INTENTS].animations[TransitionStep::Movement] == Stand, "an idle grounded player stands");
+static_assert(transitionTable.transitions[(PlayerState::DoubleJumping * 2 + 1) * PLAYER_INTENTS].animations[TransitionStep::Movement] == NO_TRANSITION_ANIMATION, "an idle airborne player keeps their animation");
+
+/*
+	The button intent for each combination of taunt, attack, special and guard buttons held, from the highest bit down.
+*/
+static const unsigned char buttonIntents[16] =
+{
+	ButtonIntent::None, ButtonIntent::Guard, ButtonIntent::Special, ButtonIntent::Special,
+	ButtonIntent::Attack, ButtonIntent::Attack, ButtonIntent::Attack, ButtonIntent::Attack,
+	ButtonIntent::Taunt, ButtonIntent::Taunt, ButtonIntent::Taunt, ButtonIntent::Taunt,
+	ButtonIntent::Taunt, ButtonIntent::Taunt, ButtonIntent::Taunt, ButtonIntent::Taunt
+};
+
+/*
+	Reduces this tick's and the last tick's controller state to an intent, using comparisons rather than branches.
+	X and Y taunt, A attacks, B uses a special and either trigger guards, in that order of priority.
+*/
+int getPlayerIntent(const XINPUT_GAMEPAD *gamepad, const XINPUT_GAMEPAD *previousGamepad, short deadValue, BYTE triggerDeadValue)
+{
+	int left = gamepad->sThumbLX < -deadValue;
+	int right = gamepad->sThumbLX > deadValue;
+	int tapped = (left & (previousGamepad->sThumbLX > -deadValue)) | (right & (previousGamepad->sThumbLX < deadValue));
+	int horizontal = left * HorizontalIntent::Left + right * HorizontalIntent::Right + tapped * (HorizontalIntent::LeftTapped - HorizontalIntent::Left);
+
+	int up = gamepad->sThumbLY > deadValue;
+	int upPressed = up & (previousGamepad->sThumbLY <= deadValue);
+	int vertical = up * VerticalIntent::Up + upPressed * (VerticalIntent::UpPressed - VerticalIntent::Up) + (gamepad->sThumbLY < -deadValue) * VerticalIntent::Down;
+
+	int taunt = (gamepad->wButtons & (XINPUT_GAMEPAD_X | XINPUT_GAMEPAD_Y)) != 0;
+	int attack = (gamepad->wButtons & XINPUT_GAMEPAD_A) != 0;
+	int special = (gamepad->wButtons & XINPUT_GAMEPAD_B) != 0;
+	int guard = (gamepad->bLeftTrigger > triggerDeadValue) | (gamepad->bRightTrigger > triggerDeadValue);
+	int button = buttonIntents[(taunt << 3) | (attack << 2) | (special << 1) | guard];
+	int attackPressed = (button == ButtonIntent::Attack) & ((previousGamepad->wButtons & XINPUT_GAMEPAD_A) == 0);
+
+	button += attackPressed * (ButtonIntent::AttackPressed - ButtonIntent::Attack);
+
+	return (button * VerticalIntent::Count + vertical) * HorizontalIntent::Count + horizontal;
+}
+
+const PlayerTransition *getPlayerTransition(int state, bool facingLeft, int intent)
+{
+	return &transitionTable.transitions[(state * 2 + (facingLeft ? 1 : 0)) * PLAYER_INTENTS + intent];
+}
+
+/*
+	Fills a gamepad with input that changes every few ticks, walking, dashing, jumping and pressing buttons the way a player would.
+*/
+static void getBenchmarkInput(unsigned int *noise, XINPUT_GAMEPAD *gamepad)
+{
+	static const short stickValues[5] = { 0, 32767, -32768, 20000, -20000 };
+	static const WORD buttons[6] = { 0, XINPUT_GAMEPAD_A, XINPUT_GAMEPAD_B, XINPUT_GAMEPAD_X, 0, 0 };
+
+	*noise = *noise * 1664525u + 1013904223u;
+
+	gamepad->sThumbLX = stickValues[(*noise >> 8) % 5];
+	gamepad->sThumbLY = stickValues[(*noise >> 12) % 5];
+	gamepad->wButtons = buttons[(*noise >> 16) % 6];
+	gamepad->bLeftTrigger = ((*noise >> 20) % 8) == 0 ? 255 : 0;
+	gamepad->bRightTrigger = 0;
+}
+
+/*
+	Applies a transition's state and facing the way PlayerC does, and sums what it sets so the work is not optimized away.
+*/
+static int applyBenchmarkTransition(const PlayerTransition *transition, const XINPUT_GAMEPAD *gamepad, int *state, bool *facingLeft)
+{
+	*state = transition->nextState;
+
+	if (gamepad->sThumbLX < -15000 || gamepad->sThumbLX > 15000)
+		*facingLeft = gamepad->sThumbLX < 0;
+
+	return transition->animations[TransitionStep::Movement] + transition->animations[TransitionStep::Action] + transition->animations[TransitionStep::Leap] +
+		transition->velocityX + transition->velocityY + transition->action;
+}
+
+/*
+	A copy of the branches PlayerC decided its actions with before the transition table, kept as the benchmark's baseline:
+	handleHorizontalMovement, inputToDash, handleActions and handleJumping, in the order the update ran them,
+	with the flags and the stick value they read unpacked from the state and facing, and what they set recorded as a transition.
+*/
+static PlayerTransition evaluateBranches(int state, bool facingLeft, const XINPUT_GAMEPAD *gamepad, const XINPUT_GAMEPAD *previousGamepad)
+{
+	const short deadValue = 15000;
+	const BYTE triggerDeadValue = 100;
+	bool jumping = isAirborne(state);
+	bool doubleJumping = isDoubleJumping(state);
+	bool dashing = isDashing(state);
+	float lastDirectionalInput = facingLeft ? -32768.0f : 32767.0f;
+	PlayerTransition result = { { NO_TRANSITION_ANIMATION, NO_TRANSITION_ANIMATION, NO_TRANSITION_ANIMATION },
+		{ GameEventType::Invalid, GameEventType::Invalid, GameEventType::Invalid }, 0, TransitionVelocity::Keep, TransitionDamage::Keep, PlayerAction::Invalid, 0, false };
+	int velocityX = 0;
+
+	/* handleHorizontalMovement and inputToDash */
+	if (gamepad->sThumbLX < -deadValue)
+	{
+		if (!dashing && !jumping && lastDirectionalInput < -deadValue && previousGamepad->sThumbLX > -deadValue)
+		{
+			dashing = true;
+			result.events[TransitionStep::Movement] = GameEventType::Dashed;
+		}
+
+		velocityX = dashing ? -2 : -1;
+
+		if (!jumping && dashing)
+			result.animations[TransitionStep::Movement] = Dash + 1;
+		else if (!jumping)
+			result.animations[TransitionStep::Movement] = Walk + 1;
+		else
+			result.animations[TransitionStep::Movement] = Jump + 1;
+
+		lastDirectionalInput = gamepad->sThumbLX;
+	}
+	else if (gamepad->sThumbLX > deadValue)
+	{
+		if (!dashing && !jumping && lastDirectionalInput > deadValue && previousGamepad->sThumbLX < deadValue)
+		{
+			dashing = true;
+			result.events[TransitionStep::Movement] = GameEventType::Dashed;
+		}
+
+		velocityX = dashing ? 2 : 1;
+
+		if (!jumping && dashing)
+			result.animations[TransitionStep::Movement] = Dash;
+		else if (!jumping)
+			result.animations[TransitionStep::Movement] = Walk;
+		else
+			result.animations[TransitionStep::Movement] = Jump;
+
+		lastDirectionalInput = gamepad->sThumbLX;
+	}
+	else
+	{
+		velocityX = 0;
+		dashing = false;
+
+		if (!jumping)
+			result.animations[TransitionStep::Movement] = lastDirectionalInput > deadValue ? Stand : Stand + 1;
+	}
+
+	int turn = lastDirectionalInput <= 0 ? 1 : 0;
+
+	/* handleActions */
+	if (gamepad->wButtons & (XINPUT_GAMEPAD_X | XINPUT_GAMEPAD_Y))
+	{
+		velocityX = 0;
+		result.animations[TransitionStep::Action] = Taunting;
+		result.events[TransitionStep::Action] = GameEventType::Taunted;
+		result.action = PlayerAction::Taunt;
+	}
+	else if (gamepad->wButtons & XINPUT_GAMEPAD_A)
+	{
+		int move = NO_TRANSITION_ANIMATION;
+
+		if (gamepad->sThumbLY > deadValue && !jumping)
+		{
+			velocityX = 0;
+			result.damage = TransitionDamage::Large;
+			move = UpAttack;
+		}
+		else if (gamepad->sThumbLY < -deadValue && !jumping)
+		{
+			velocityX = 0;
+			result.damage = TransitionDamage::Large;
+			move = DownAttack;
+		}
+		else if (dashing && !jumping && !(previousGamepad->wButtons & XINPUT_GAMEPAD_A))
+		{
+			dashing = false;
+			result.damage = TransitionDamage::Small;
+			move = DashAttack;
+		}
+		else if ((gamepad->sThumbLX < -deadValue || gamepad->sThumbLX > deadValue) && !jumping)
+		{
+			velocityX = 0;
+			result.damage = TransitionDamage::Large;
+			move = SideAttack;
+		}
+		else if (!jumping)
+		{
+			velocityX = 0;
+			result.damage = TransitionDamage::Small;
+			move = RapidPunch;
+		}
+		else if (jumping && !(previousGamepad->wButtons & XINPUT_GAMEPAD_A))
+		{
+			result.damage = TransitionDamage::Large;
+			move = Aerial;
+		}
+
+		if (move != NO_TRANSITION_ANIMATION)
+		{
+			result.animations[TransitionStep::Action] = move + turn;
+			result.events[TransitionStep::Action] = GameEventType::Attacked;
+		}
+
+		result.action = PlayerAction::Attack;
+	}
+	else if (gamepad->wButtons & XINPUT_GAMEPAD_B)
+	{
+		if (gamepad->sThumbLY < -deadValue)
+		{
+			velocityX = 0;
+			result.velocityY = TransitionVelocity::Dive;
+			jumping = false;
+			doubleJumping = false;
+			result.damage = TransitionDamage::Small;
+			result.animations[TransitionStep::Action] = DownSpecial;
+			result.events[TransitionStep::Action] = GameEventType::SpecialUsed;
+			result.action = PlayerAction::Special;
+		}
+		else if (gamepad->sThumbLY > deadValue)
+		{
+			jumping = true;
+			doubleJumping = true;
+			result.velocityY = TransitionVelocity::HighRise;
+			result.damage = TransitionDamage::Small;
+			result.animations[TransitionStep::Action] = UpSpecial + turn;
+			result.events[TransitionStep::Action] = GameEventType::SpecialUsed;
+			result.action = PlayerAction::Special;
+		}
+		else if (gamepad->sThumbLX > deadValue || gamepad->sThumbLX < -deadValue)
+		{
+			velocityX = 0;
+
+			if (!jumping)
+				result.velocityY = TransitionVelocity::Dive;
+
+			result.damage = TransitionDamage::Small;
+			result.animations[TransitionStep::Action] = SideSpecial + turn;
+			result.events[TransitionStep::Action] = GameEventType::SpecialUsed;
+			result.action = PlayerAction::Special;
+		}
+	}
+	else if (gamepad->bLeftTrigger > triggerDeadValue || gamepad->bRightTrigger > triggerDeadValue)
+	{
+		if (gamepad->sThumbLX > deadValue || gamepad->sThumbLX < -deadValue)
+		{
+			result.animations[TransitionStep::Action] = DodgeRoll + turn;
+		}
+		else
+		{
+			velocityX = 0;
+			result.animations[TransitionStep::Action] = Block + turn;
+		}
+
+		result.events[TransitionStep::Action] = GameEventType::Dodged;
+		result.action = PlayerAction::Dodge;
+	}
+
+	/* handleJumping */
+	if (gamepad->sThumbLY > deadValue && !doubleJumping && !(previousGamepad->sThumbLY > deadValue))
+	{
+		if (jumping)
+		{
+			doubleJumping = true;
+		}
+		else
+		{
+			jumping = true;
+			result.startsJump = true;
+		}
+
+		result.velocityY = TransitionVelocity::Rise;
+		result.animations[TransitionStep::Leap] = Jump + turn;
+		result.events[TransitionStep::Leap] = GameEventType::Jumped;
+	}
+
+	result.velocityX = (signed char)velocityX;
+	result.nextState = (unsigned char)((doubleJumping ? PlayerState::DoubleJumping : jumping ? PlayerState::Jumping : PlayerState::Grounded) | (dashing ? 1 : 0));
+
+	return result;
+}
+
+/*
+	Simulates the decisions of four players over a stream of scripted input, once through a copy of the branches the update used to run
+	and once looking the transitions up in the generated table. Players land every few ticks, as they would on the stage, so every state is visited.
+	Both must make the same decisions; any that differ are counted and reported.
+*/
+void benchmarkPlayerStateMachine()
+{
+	static XINPUT_GAMEPAD inputs[BENCHMARK_PLAYERS][2];
+	double seconds[2];
+	int checksums[2];
+	int mismatches = 0;
+
+	for (int method = 0; method < 2; method++)
+	{
+		unsigned int noise = 12345;
+		int states[BENCHMARK_PLAYERS] = { PlayerState::DoubleJumping, PlayerState::DoubleJumping, PlayerState::DoubleJumping, PlayerState::DoubleJumping };
+		bool facingLeft[BENCHMARK_PLAYERS] = { false, true, false, true };
+		int checksum = 0;
+
+		memset(inputs, 0, sizeof(inputs));
+
+		double start = getBenchmarkSeconds();
+
+		for (int tick = 0; tick < BENCHMARK_TICKS; tick++)
+		{
+			for (int i = 0; i < BENCHMARK_PLAYERS; i++)
+			{
+				XINPUT_GAMEPAD *gamepad = &inputs[i][tick & 1];
+				XINPUT_GAMEPAD *previousGamepad = &inputs[i][(tick & 1) ^ 1];
+
+				if ((tick + i) % BENCHMARK_HOLD_TICKS == 0)
+					getBenchmarkInput(&noise, gamepad);
+				else
+					*gamepad = *previousGamepad;
+
+				if ((tick + i * 3) % (BENCHMARK_HOLD_TICKS * 5) == 0)
+					states[i] = getLandedState(states[i]);
+
+				PlayerTransition evaluated;
+				const PlayerTransition *transition;
+
+				if (method == 0)
+				{
+					evaluated = evaluateBranches(states[i], facingLeft[i], gamepad, previousGamepad);
+					transition = &evaluated;
+				}
+				else
+				{
+					transition = getPlayerTransition(states[i], facingLeft[i], getPlayerIntent(gamepad, previousGamepad, 15000, 100));
+				}
+
+				checksum += applyBenchmarkTransition(transition, gamepad, &states[i], &facingLeft[i]);
+			}
+		}
+
+		seconds[method] = getBenchmarkSeconds() - start;
+		checksums[method] = checksum;
+	}
+
+	for (int state = 0; state < PlayerState::MaxState; state++)
+	{
+		for (int facing = 0; facing < 2; facing++)
+		{
+			for (int i = 0; i < BENCHMARK_CHECK_INPUTS; i++)
+			{
+				unsigned int noise = i * 2654435761u;
+				XINPUT_GAMEPAD gamepad, previousGamepad;
+
+				getBenchmarkInput(&noise, &previousGamepad);
+				getBenchmarkInput(&noise, &gamepad);
+
+				PlayerTransition evaluated = evaluateBranches(state, facing != 0, &gamepad, &previousGamepad);
+
+				if (memcmp(&evaluated, getPlayerTransition(state, facing != 0, getPlayerIntent(&gamepad, &previousGamepad, 15000, 100)), sizeof(evaluated)))
+					mismatches++;
+			}
+		}
+	}
+
+	printf("  branches per tick:  %6.2f ns per player tick\n", seconds[0] * 1e9 / ((double)BENCHMARK_TICKS * BENCHMARK_PLAYERS));
+	printf("  transition table:   %6.2f ns per player tick, %.2fx the speed of the branches, %d KB table\n", seconds[1] * 1e9 / ((double)BENCHMARK_TICKS * BENCHMARK_PLAYERS),
+		seconds[0] / seconds[1], (int)(sizeof(transitionTable) / 1024));
+
+	if (checksums[0] != checksums[1] || mismatches != 0)
+		printf("  DECISIONS DIFFER: %d of %d checked inputs\n", mismatches, PlayerState::MaxState * 2 * BENCHMARK_CHECK_INPUTS);
+}
\ No newline at end of file
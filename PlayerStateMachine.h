@@ -0,0 +1,104 @@
+#pragma once
+/*
+	PlayerStateMachine.h
+
+	The decision a player makes on each tick they are free to act, taken as a single lookup in a table of transitions.
+	A player's state is whether they are grounded, jumping or double jumping, whether they are dashing, and which way they face.
+	The controller input of a tick is reduced to an intent: one horizontal, one vertical and one button choice.
+	The transition out of every state for every intent is worked out when the game is compiled, in the order the steps always apply:
+	the movement, then the action, then the jump. Each records the animations to change to and the events to raise at each step,
+	the velocities, damage and action to set, and the state the player ends up in.
+	New moves are added to the rules in PlayerStateMachine.cpp and the table follows.
+*/
+
+#include <windows.h>
+#include <Xinput.h>
+
+#define NO_TRANSITION_ANIMATION -1
+#define TRANSITION_STEPS 3
+
+/*
+	How a player is moving. Every state has a dashing variant at state + 1, as a dash carries on through jumps.
+*/
+namespace PlayerState
+{
+	enum PlayerState { Grounded, GroundedDashing, Jumping, JumpingDashing, DoubleJumping, DoubleJumpingDashing, MaxState };
+}
+
+/*
+	The left stick's horizontal choice. A tapped direction was pushed this tick, which starts a dash towards the way the player faces.
+*/
+namespace HorizontalIntent
+{
+	enum HorizontalIntent { None, Left, Right, LeftTapped, RightTapped, Count };
+}
+
+/*
+	The left stick's vertical choice. Up is pressed on the tick it is pushed, which jumps.
+*/
+namespace VerticalIntent
+{
+	enum VerticalIntent { None, Up, UpPressed, Down, Count };
+}
+
+/*
+	The button a player acts with, the highest priority of those held. Attack is pressed on the tick A is pushed.
+*/
+namespace ButtonIntent
+{
+	enum ButtonIntent { None, Guard, Special, Attack, AttackPressed, Taunt, Count };
+}
+
+#define PLAYER_INTENTS (HorizontalIntent::Count * VerticalIntent::Count * ButtonIntent::Count)
+#define PLAYER_TRANSITIONS (PlayerState::MaxState * 2 * PLAYER_INTENTS)
+
+/*
+	The steps of a transition, in the order they apply.
+*/
+namespace TransitionStep
+{
+	enum TransitionStep { Movement, Action, Leap };
+}
+
+/*
+	The vertical velocity a transition leaves the player with.
+*/
+namespace TransitionVelocity
+{
+	enum TransitionVelocity { Keep, Rise, HighRise, Dive };
+}
+
+/*
+	The damage a transition sets the player to deal.
+*/
+namespace TransitionDamage
+{
+	enum TransitionDamage { Keep, Small, Large };
+}
+
+/*
+	The animation index each step changes to, or NO_TRANSITION_ANIMATION, and the game event raised with it.
+	The movement event is raised before its animation changes, as a dash starts before the player moves; the others after.
+	The horizontal velocity is in multiples of the player's speed.
+*/
+struct PlayerTransition
+{
+	signed char animations[TRANSITION_STEPS];
+	unsigned char events[TRANSITION_STEPS];
+
+	signed char velocityX;
+	unsigned char velocityY;
+	unsigned char damage;
+	unsigned char action;
+	unsigned char nextState;
+
+	bool startsJump;
+};
+
+constexpr bool isAirborne(int state) { return state >= PlayerState::Jumping; }
+constexpr bool isDoubleJumping(int state) { return state >= PlayerState::DoubleJumping; }
+constexpr bool isDashing(int state) { return (state & 1) != 0; }
+constexpr int getLandedState(int state) { return state & 1; }
+
+int getPlayerIntent(const XINPUT_GAMEPAD *gamepad, const XINPUT_GAMEPAD *previousGamepad, short deadValue, BYTE triggerDeadValue);
+const PlayerTransition *getPlayerTransition(int state, bool facingLeft, int intent);
\ No newline at end of file
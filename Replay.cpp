@@ -0,0 +1,710 @@
+/*
+	Replay.cpp
+
+	This file contains the implementation for functions prototyped in the ReplayC class.
+*/
+
+#define _CRT_SECURE_NO_WARNINGS
+
+#include <stdlib.h>
+#include <string.h>
+#include "Replay.h"
+#include "StateHash.h"
+
+/*
+	Bits of the fields of an input run that changed from the run before it.
+*/
+#define INPUT_BUTTONS 0x01
+#define INPUT_LEFT_TRIGGER 0x02
+#define INPUT_RIGHT_TRIGGER 0x04
+#define INPUT_LEFT_THUMB_X 0x08
+#define INPUT_LEFT_THUMB_Y 0x10
+#define INPUT_RIGHT_THUMB_X 0x20
+#define INPUT_RIGHT_THUMB_Y 0x40
+#define INPUT_CONNECTED 0x80
+
+static const char *recordReplaysOption = "-recordreplays";
+static const char *replayOption = "-replay";
+static const char *replaySpeedOption = "-replayspeed";
+static const char *uncappedSpeed = "uncapped";
+static char replayDirectory[MAX_PATH] = "";
+static char requestedReplay[MAX_PATH] = "";
+static int requestedReplaySpeed = 1;
+
+static unsigned char chunkBuffer[REPLAY_MAX_CHUNK_BYTES];
+
+/*
+	Writes a number seven bits to a byte, lowest first, with the top bit set on every byte but the last.
+*/
+static unsigned char *writeNumber(unsigned char *output, unsigned int value)
+{
+	while (value >= 0x80)
+	{
+		*output++ = (unsigned char)(value | 0x80);
+		value >>= 7;
+	}
+
+	*output++ = (unsigned char)value;
+
+	return output;
+}
+
+/*
+	Reads a number written by writeNumber(). Returns NULL if the number runs past the end.
+*/
+static const unsigned char *readNumber(const unsigned char *input, const unsigned char *end, unsigned int *value)
+{
+	*value = 0;
+
+	for (int shift = 0; input < end && shift < 35; shift += 7)
+	{
+		unsigned char byte = *input++;
+
+		*value |= (unsigned int)(byte & 0x7f) << shift;
+
+		if (!(byte & 0x80))
+			return input;
+	}
+
+	return NULL;
+}
+
+/*
+	Writes the difference between two thumbstick positions, folded so small differences either way take one byte.
+*/
+static unsigned char *writeThumbDifference(unsigned char *output, short from, short to)
+{
+	int difference = (int)to - (int)from;
+
+	return writeNumber(output, difference >= 0 ? (unsigned int)difference << 1 : ((unsigned int)(-difference) << 1) - 1);
+}
+
+static const unsigned char *readThumbDifference(const unsigned char *input, const unsigned char *end, short *thumb)
+{
+	unsigned int folded;
+
+	input = readNumber(input, end, &folded);
+
+	if (input != NULL)
+		*thumb = (short)(*thumb + ((folded & 1) ? -(int)((folded + 1) >> 1) : (int)(folded >> 1)));
+
+	return input;
+}
+
+/*
+	Writes the bytes as runs of zero bytes, given by their length, each followed by a run of other bytes, given by its length and the bytes.
+*/
+static unsigned char *writeZeroRuns(unsigned char *output, const unsigned char *bytes, int count)
+{
+	int i = 0;
+
+	while (i < count)
+	{
+		int zeros = 0;
+		int literals = 0;
+
+		while (i + zeros < count && bytes[i + zeros] == 0)
+			zeros++;
+
+		while (i + zeros + literals < count && (bytes[i + zeros + literals] != 0 || (i + zeros + literals + 1 < count && bytes[i + zeros + literals + 1] != 0)))
+			literals++;
+
+		output = writeNumber(output, zeros);
+		output = writeNumber(output, literals);
+
+		memcpy(output, bytes + i + zeros, literals);
+		output += literals;
+
+		i += zeros + literals;
+	}
+
+	return output;
+}
+
+static bool readZeroRuns(const unsigned char *input, const unsigned char *end, unsigned char *bytes, int count)
+{
+	int i = 0;
+
+	while (i < count)
+	{
+		unsigned int zeros;
+		unsigned int literals;
+
+		input = readNumber(input, end, &zeros);
+		input = input != NULL ? readNumber(input, end, &literals) : NULL;
+
+		if (input == NULL || zeros > (unsigned int)(count - i) || literals > (unsigned int)(count - i) - zeros || literals > (unsigned int)(end - input))
+			return false;
+
+		memset(bytes + i, 0, zeros);
+		memcpy(bytes + i + zeros, input, literals);
+
+		input += literals;
+		i += zeros + literals;
+	}
+
+	return true;
+}
+
+/*
+	Finds the option on the command line, followed by a space or the end, so one option is not found as the start of another.
+*/
+static const char *findOption(const char *commandLine, const char *option)
+{
+	int length = (int)strlen(option);
+
+	for (const char *found = commandLine != NULL ? strstr(commandLine, option) : NULL; found != NULL; found = strstr(found + 1, option))
+	{
+		if (found[length] == ' ' || found[length] == 0)
+			return found + length;
+	}
+
+	return NULL;
+}
+
+static bool isSameInput(const MatchInput *first, const MatchInput *second, int player)
+{
+	unsigned int bit = 1 << player;
+
+	return (first->connected & bit) == (second->connected & bit) && memcmp(&first->gamepads[player], &second->gamepads[player], sizeof(XINPUT_GAMEPAD)) == 0;
+}
+
+/* Public functions */
+ReplayC::ReplayC()
+{
+	mFile = NULL;
+	mChunks = NULL;
+	mChunkCapacity = 0;
+	mData = NULL;
+	mSize = 0;
+	mChunkTicks = 0;
+	mDecodedChunk = -1;
+
+	memset(&mHeader, 0, sizeof(mHeader));
+}
+
+ReplayC::~ReplayC()
+{
+	endRecording();
+	unload();
+}
+
+/*
+	Creates the replay of a match in the given directory, named by the seed, and writes a header that endRecording() completes.
+	Returns false if the file cannot be created, in which case the match is not recorded.
+*/
+bool ReplayC::beginRecording(const char *directory, unsigned long long seed, const int *characters, const MatchInput *initialInput)
+{
+	char path[MAX_PATH + 32];
+
+	endRecording();
+	unload();
+
+	mHeader.magic = REPLAY_MAGIC;
+	mHeader.version = REPLAY_VERSION;
+	mHeader.seed = seed;
+	mHeader.stateBytes = sizeof(MatchSnapshot);
+#ifdef FIXED_POINT_SIMULATION
+	mHeader.fixedPoint = 1;
+#endif
+	mHeader.initialInput = *initialInput;
+
+	for (int i = 0; i < MAX_NUMBER_OF_PLAYERS; i++)
+		mHeader.characters[i] = characters[i];
+
+	sprintf(path, "%s/match_%llu.replay", directory, seed);
+
+	mFile = fopen(path, "wb");
+
+	if (mFile == NULL)
+	{
+		printf("Could not create the replay %s\n", path);
+		return false;
+	}
+
+	fwrite(&mHeader, sizeof(mHeader), 1, mFile);
+
+	return true;
+}
+
+/*
+	Adds a tick to the replay being recorded, given the state of the match before the tick, which starts a chunk as its keyframe.
+	The chunk is written once it is full.
+*/
+void ReplayC::record(const MatchSnapshot *stateBefore, const MatchInput *input, DWORD milliseconds)
+{
+	if (mFile == NULL)
+		return;
+
+	if (mChunkTicks == 0)
+		mKeyframe = *stateBefore;
+
+	mInputs[mChunkTicks] = *input;
+	mMilliseconds[mChunkTicks] = milliseconds;
+	mChunkTicks++;
+	mHeader.tickCount++;
+
+	if (mChunkTicks == REPLAY_KEYFRAME_INTERVAL)
+		writeChunk();
+}
+
+/*
+	Writes the chunk in progress, then the index, and completes the header.
+*/
+void ReplayC::endRecording()
+{
+	if (mFile == NULL)
+		return;
+
+	if (mChunkTicks > 0)
+		writeChunk();
+
+	mHeader.indexOffset = (unsigned int)ftell(mFile);
+	fwrite(mChunks, sizeof(ReplayChunk), mHeader.chunkCount, mFile);
+
+	mSize = (int)ftell(mFile);
+
+	fseek(mFile, 0, SEEK_SET);
+	fwrite(&mHeader, sizeof(mHeader), 1, mFile);
+	fclose(mFile);
+
+	printf("Recorded a replay of %u ticks in %d bytes\n", mHeader.tickCount, mSize);
+
+	mFile = NULL;
+	unload();
+}
+
+bool ReplayC::isRecording()
+{
+	return mFile != NULL;
+}
+
+/*
+	Reads a whole replay into memory and finds its chunks. Returns false if it cannot be read or was not written as a replay.
+*/
+bool ReplayC::load(const char *path)
+{
+	unload();
+
+	FILE *file = fopen(path, "rb");
+
+	if (file == NULL)
+		return false;
+
+	fseek(file, 0, SEEK_END);
+	mSize = ftell(file);
+	fseek(file, 0, SEEK_SET);
+
+	mData = (unsigned char *)malloc(mSize);
+
+	bool valid = mData != NULL && (int)fread(mData, 1, mSize, file) == mSize && mSize >= (int)sizeof(mHeader);
+
+	fclose(file);
+
+	if (valid)
+	{
+		memcpy(&mHeader, mData, sizeof(mHeader));
+		valid = mHeader.magic == REPLAY_MAGIC && mHeader.version == REPLAY_VERSION && buildIndex();
+	}
+
+	if (!valid)
+		unload();
+
+	return valid;
+}
+
+void ReplayC::unload()
+{
+	free(mData);
+	free(mChunks);
+
+	mData = NULL;
+	mSize = 0;
+	mChunks = NULL;
+	mChunkCapacity = 0;
+	mChunkTicks = 0;
+	mDecodedChunk = -1;
+
+	memset(&mHeader, 0, sizeof(mHeader));
+}
+
+bool ReplayC::isLoaded()
+{
+	return mData != NULL;
+}
+
+const ReplayHeader *ReplayC::getHeader()
+{
+	return &mHeader;
+}
+
+/*
+	Gets the keyframe at or before the given tick and the tick it was taken at. Returns false past the end of the replay.
+*/
+bool ReplayC::getKeyframe(int tick, MatchSnapshot *snapshot, int *keyframeTick)
+{
+	if (tick < 0 || tick >= (int)mHeader.tickCount || !decodeChunk(tick / REPLAY_KEYFRAME_INTERVAL))
+		return false;
+
+	*snapshot = mKeyframe;
+	*keyframeTick = mChunks[mDecodedChunk].firstTick;
+
+	return true;
+}
+
+/*
+	Gets the input and length of the given tick, decoding its chunk if it is not the one last decoded. Returns false past the end of the replay.
+*/
+bool ReplayC::getTick(int tick, MatchInput *input, DWORD *milliseconds)
+{
+	if (tick < 0 || tick >= (int)mHeader.tickCount || !decodeChunk(tick / REPLAY_KEYFRAME_INTERVAL))
+		return false;
+
+	int index = tick - mChunks[mDecodedChunk].firstTick;
+
+	*input = mInputs[index];
+	*milliseconds = mMilliseconds[index];
+
+	return true;
+}
+
+int ReplayC::getTickCount()
+{
+	return mHeader.tickCount;
+}
+
+int ReplayC::getFileBytes()
+{
+	return mSize;
+}
+
+/* Private functions */
+
+/*
+	Codes the keyframe and the input of the chunk in progress and writes them, adding the chunk to the index.
+	Each player's input is coded against the input the keyframe holds for them, so a chunk is read without the ones before it.
+*/
+void ReplayC::writeChunk()
+{
+	unsigned char *output = writeZeroRuns(chunkBuffer, (const unsigned char *)&mKeyframe, sizeof(mKeyframe));
+	unsigned char *inputStart = output;
+
+	for (int player = 0; player < MAX_NUMBER_OF_PLAYERS; player++)
+	{
+		MatchInput previous;
+
+		previous.connected = mKeyframe.players[player].connected ? 1 << player : 0;
+		previous.gamepads[player] = mKeyframe.players[player].gamepad;
+
+		for (int tick = 0; tick < mChunkTicks; )
+		{
+			const MatchInput *input = &mInputs[tick];
+			const XINPUT_GAMEPAD *gamepad = &input->gamepads[player];
+			const XINPUT_GAMEPAD *previousGamepad = &previous.gamepads[player];
+			int run = 1;
+			unsigned char changes = 0;
+
+			while (tick + run < mChunkTicks && isSameInput(&mInputs[tick + run], input, player))
+				run++;
+
+			if (gamepad->wButtons != previousGamepad->wButtons)
+				changes |= INPUT_BUTTONS;
+			if (gamepad->bLeftTrigger != previousGamepad->bLeftTrigger)
+				changes |= INPUT_LEFT_TRIGGER;
+			if (gamepad->bRightTrigger != previousGamepad->bRightTrigger)
+				changes |= INPUT_RIGHT_TRIGGER;
+			if (gamepad->sThumbLX != previousGamepad->sThumbLX)
+				changes |= INPUT_LEFT_THUMB_X;
+			if (gamepad->sThumbLY != previousGamepad->sThumbLY)
+				changes |= INPUT_LEFT_THUMB_Y;
+			if (gamepad->sThumbRX != previousGamepad->sThumbRX)
+				changes |= INPUT_RIGHT_THUMB_X;
+			if (gamepad->sThumbRY != previousGamepad->sThumbRY)
+				changes |= INPUT_RIGHT_THUMB_Y;
+			if ((input->connected ^ previous.connected) & (1 << player))
+				changes |= INPUT_CONNECTED;
+
+			output = writeNumber(output, run);
+			*output++ = changes;
+
+			if (changes & INPUT_BUTTONS)
+			{
+				*output++ = (unsigned char)gamepad->wButtons;
+				*output++ = (unsigned char)(gamepad->wButtons >> 8);
+			}
+
+			if (changes & INPUT_LEFT_TRIGGER)
+				*output++ = gamepad->bLeftTrigger;
+			if (changes & INPUT_RIGHT_TRIGGER)
+				*output++ = gamepad->bRightTrigger;
+			if (changes & INPUT_LEFT_THUMB_X)
+				output = writeThumbDifference(output, previousGamepad->sThumbLX, gamepad->sThumbLX);
+			if (changes & INPUT_LEFT_THUMB_Y)
+				output = writeThumbDifference(output, previousGamepad->sThumbLY, gamepad->sThumbLY);
+			if (changes & INPUT_RIGHT_THUMB_X)
+				output = writeThumbDifference(output, previousGamepad->sThumbRX, gamepad->sThumbRX);
+			if (changes & INPUT_RIGHT_THUMB_Y)
+				output = writeThumbDifference(output, previousGamepad->sThumbRY, gamepad->sThumbRY);
+
+			previous = *input;
+			tick += run;
+		}
+	}
+
+	for (int tick = 0; tick < mChunkTicks; )
+	{
+		int run = 1;
+
+		while (tick + run < mChunkTicks && mMilliseconds[tick + run] == mMilliseconds[tick])
+			run++;
+
+		output = writeNumber(output, run);
+		output = writeNumber(output, mMilliseconds[tick]);
+
+		tick += run;
+	}
+
+	if (mHeader.chunkCount == (unsigned int)mChunkCapacity)
+	{
+		mChunkCapacity = mChunkCapacity ? mChunkCapacity * 2 : 16;
+		mChunks = (ReplayChunk *)realloc(mChunks, mChunkCapacity * sizeof(ReplayChunk));
+	}
+
+	ReplayChunk *chunk = &mChunks[mHeader.chunkCount++];
+
+	chunk->hash = hashState(&mKeyframe, sizeof(mKeyframe));
+	chunk->firstTick = mHeader.tickCount - mChunkTicks;
+	chunk->tickCount = mChunkTicks;
+	chunk->keyframeBytes = (unsigned int)(inputStart - chunkBuffer);
+	chunk->inputBytes = (unsigned int)(output - inputStart);
+	chunk->offset = (unsigned int)ftell(mFile);
+
+	fwrite(chunk, sizeof(ReplayChunk), 1, mFile);
+	fwrite(chunkBuffer, 1, output - chunkBuffer, mFile);
+
+	mChunkTicks = 0;
+}
+
+/*
+	Copies the index at the end of the replay, or walks the chunks to build it when the replay was never completed.
+	Every chunk but the last must be full, as seeking finds a tick's chunk by dividing by the keyframe interval.
+*/
+bool ReplayC::buildIndex()
+{
+	if (mHeader.stateBytes != sizeof(MatchSnapshot))
+		return false;
+
+	if (mHeader.indexOffset != 0)
+	{
+		if (mHeader.indexOffset > (unsigned int)mSize || mHeader.chunkCount > (mSize - mHeader.indexOffset) / sizeof(ReplayChunk))
+			return false;
+
+		mChunkCapacity = mHeader.chunkCount;
+		mChunks = (ReplayChunk *)malloc(mChunkCapacity * sizeof(ReplayChunk) + 1);
+		memcpy(mChunks, mData + mHeader.indexOffset, mHeader.chunkCount * sizeof(ReplayChunk));
+	}
+	else
+	{
+		unsigned int offset = sizeof(mHeader);
+
+		mHeader.chunkCount = 0;
+		mHeader.tickCount = 0;
+
+		while (offset + sizeof(ReplayChunk) <= (unsigned int)mSize)
+		{
+			ReplayChunk chunk;
+
+			memcpy(&chunk, mData + offset, sizeof(chunk));
+
+			if (chunk.offset != offset || chunk.keyframeBytes + chunk.inputBytes > mSize - offset - sizeof(chunk))
+				break;
+
+			if (mHeader.chunkCount == (unsigned int)mChunkCapacity)
+			{
+				mChunkCapacity = mChunkCapacity ? mChunkCapacity * 2 : 16;
+				mChunks = (ReplayChunk *)realloc(mChunks, mChunkCapacity * sizeof(ReplayChunk));
+			}
+
+			mChunks[mHeader.chunkCount++] = chunk;
+			mHeader.tickCount += chunk.tickCount;
+
+			offset += sizeof(chunk) + chunk.keyframeBytes + chunk.inputBytes;
+		}
+	}
+
+	for (unsigned int i = 0; i < mHeader.chunkCount; i++)
+	{
+		const ReplayChunk *chunk = &mChunks[i];
+
+		if (chunk->firstTick != i * REPLAY_KEYFRAME_INTERVAL || chunk->tickCount > REPLAY_KEYFRAME_INTERVAL || (chunk->tickCount != REPLAY_KEYFRAME_INTERVAL && i + 1 != mHeader.chunkCount) ||
+			chunk->offset + sizeof(ReplayChunk) + chunk->keyframeBytes + chunk->inputBytes > (unsigned int)mSize)
+			return false;
+	}
+
+	return true;
+}
+
+/*
+	Decodes the keyframe and the input of a chunk, unless it was the last one decoded.
+*/
+bool ReplayC::decodeChunk(int chunk)
+{
+	if (chunk == mDecodedChunk)
+		return true;
+
+	if (chunk < 0 || chunk >= (int)mHeader.chunkCount)
+		return false;
+
+	const ReplayChunk *header = &mChunks[chunk];
+	const unsigned char *input = mData + header->offset + sizeof(ReplayChunk);
+	const unsigned char *end = input + header->keyframeBytes + header->inputBytes;
+	int ticks = header->tickCount;
+
+	mDecodedChunk = -1;
+
+	if (!readZeroRuns(input, input + header->keyframeBytes, (unsigned char *)&mKeyframe, sizeof(mKeyframe)))
+		return false;
+
+	input += header->keyframeBytes;
+
+	memset(mInputs, 0, ticks * sizeof(MatchInput));
+
+	for (int player = 0; player < MAX_NUMBER_OF_PLAYERS; player++)
+	{
+		unsigned int bit = 1 << player;
+		bool connected = mKeyframe.players[player].connected;
+		XINPUT_GAMEPAD gamepad = mKeyframe.players[player].gamepad;
+
+		for (int tick = 0; tick < ticks; )
+		{
+			unsigned int run;
+			unsigned char changes;
+
+			input = readNumber(input, end, &run);
+
+			if (input == NULL || input >= end || run == 0 || run > (unsigned int)(ticks - tick))
+				return false;
+
+			changes = *input++;
+
+			if (changes & INPUT_BUTTONS)
+			{
+				if (end - input < 2)
+					return false;
+
+				gamepad.wButtons = (WORD)(input[0] | (input[1] << 8));
+				input += 2;
+			}
+
+			if (end - input < ((changes & INPUT_LEFT_TRIGGER) ? 1 : 0) + ((changes & INPUT_RIGHT_TRIGGER) ? 1 : 0))
+				return false;
+
+			if (changes & INPUT_LEFT_TRIGGER)
+				gamepad.bLeftTrigger = *input++;
+			if (changes & INPUT_RIGHT_TRIGGER)
+				gamepad.bRightTrigger = *input++;
+			if ((changes & INPUT_LEFT_THUMB_X) && input != NULL)
+				input = readThumbDifference(input, end, &gamepad.sThumbLX);
+			if ((changes & INPUT_LEFT_THUMB_Y) && input != NULL)
+				input = readThumbDifference(input, end, &gamepad.sThumbLY);
+			if ((changes & INPUT_RIGHT_THUMB_X) && input != NULL)
+				input = readThumbDifference(input, end, &gamepad.sThumbRX);
+			if ((changes & INPUT_RIGHT_THUMB_Y) && input != NULL)
+				input = readThumbDifference(input, end, &gamepad.sThumbRY);
+
+			if (input == NULL)
+				return false;
+
+			if (changes & INPUT_CONNECTED)
+				connected = !connected;
+
+			for (unsigned int i = 0; i < run; i++, tick++)
+			{
+				mInputs[tick].gamepads[player] = gamepad;
+
+				if (connected)
+					mInputs[tick].connected |= bit;
+			}
+		}
+	}
+
+	for (int tick = 0; tick < ticks; )
+	{
+		unsigned int run;
+		unsigned int milliseconds;
+
+		input = readNumber(input, end, &run);
+		input = input != NULL ? readNumber(input, end, &milliseconds) : NULL;
+
+		if (input == NULL || run == 0 || run > (unsigned int)(ticks - tick))
+			return false;
+
+		for (unsigned int i = 0; i < run; i++)
+			mMilliseconds[tick++] = milliseconds;
+	}
+
+	mDecodedChunk = chunk;
+
+	return true;
+}
+
+/*
+	Reads -recordreplays <directory>, -replay <file> and -replayspeed <speed> from the command line.
+	The speed is rounded down to a power of two no faster than REPLAY_MAX_SPEED.
+*/
+void requestReplays(const char *commandLine)
+{
+	const char *option = findOption(commandLine, recordReplaysOption);
+	char speed[16] = "";
+
+	if (option != NULL)
+		sscanf(option, "%259s", replayDirectory);
+
+	option = findOption(commandLine, replayOption);
+
+	if (option != NULL)
+		sscanf(option, "%259s", requestedReplay);
+
+	option = findOption(commandLine, replaySpeedOption);
+
+	if (option != NULL && sscanf(option, "%15s", speed) == 1)
+	{
+		if (strcmp(speed, uncappedSpeed) == 0)
+		{
+			requestedReplaySpeed = REPLAY_UNCAPPED;
+		}
+		else
+		{
+			int value = atoi(speed);
+
+			requestedReplaySpeed = 1;
+
+			while (requestedReplaySpeed * 2 <= value && requestedReplaySpeed < REPLAY_MAX_SPEED)
+				requestedReplaySpeed *= 2;
+		}
+	}
+}
+
+/*
+	Returns the directory replays are recorded to, or NULL when they were not asked for.
+*/
+const char *getReplayDirectory()
+{
+	return replayDirectory[0] ? replayDirectory : NULL;
+}
+
+/*
+	Returns the replay to play instead of the first match, or NULL when none was asked for.
+*/
+const char *getRequestedReplay()
+{
+	return requestedReplay[0] ? requestedReplay : NULL;
+}
+
+/*
+	Returns the speed replays start playing at, a multiple of the speed they were recorded at or REPLAY_UNCAPPED.
+*/
+int getRequestedReplaySpeed()
+{
+	return requestedReplaySpeed;
+}
\ No newline at end of file
@@ -0,0 +1,111 @@
+#pragma once
+/*
+	Replay.h
+
+	A replay of a match that can be played from any tick, small enough to keep every match played.
+	The match is split into chunks of REPLAY_KEYFRAME_INTERVAL ticks. Each chunk starts with a keyframe, the full state of the match
+	at its first tick, followed by the input of its ticks, so seeking restores the keyframe before a tick and simulates at most a chunk.
+	Controller input hardly changes from one tick to the next, so each player's input is stored as runs of unchanged ticks,
+	each run holding only the fields that changed from the one before, with the thumbsticks as differences. The lengths of the ticks are run length coded too.
+	Keyframes are stored with their runs of zero bytes removed. An index of the chunks at the end of the file finds a chunk without reading the ones before it;
+	a replay whose index was never written, as the game stopped, is indexed by walking its chunks instead.
+	Starting the game with -recordreplays <directory> records a replay of every match into the directory, named by the match seed,
+	and -replay <file> plays one back; while it plays, the first controller's shoulder buttons seek back and forward by REPLAY_SEEK_TICKS.
+	Replays play at 1x to REPLAY_MAX_SPEED times the speed they were recorded at, starting at the speed given with -replayspeed <speed>
+	and doubled or halved with the first controller's D-pad. -replayspeed uncapped plays the whole replay at once without drawing it.
+	Like match logs, replays are only played by a build with the same match state.
+*/
+
+#include <stdio.h>
+#include "PlayerManager.h"
+
+#define REPLAY_MAGIC 0x504C524B
+#define REPLAY_VERSION 1
+#define REPLAY_KEYFRAME_INTERVAL 600
+#define REPLAY_SEEK_TICKS 300
+#define REPLAY_MAX_SPEED 64
+#define REPLAY_UNCAPPED 0
+#define REPLAY_MAX_CHUNK_BYTES (sizeof(MatchSnapshot) * 2 + REPLAY_KEYFRAME_INTERVAL * (MAX_NUMBER_OF_PLAYERS * 20 + 10))
+
+struct ReplayHeader
+{
+	unsigned int magic;
+	unsigned int version;
+	unsigned long long seed;
+	int characters[MAX_NUMBER_OF_PLAYERS];
+	unsigned int stateBytes;
+	unsigned int fixedPoint;
+	unsigned int tickCount;
+	unsigned int chunkCount;
+	unsigned int indexOffset;
+	MatchInput initialInput;
+};
+
+/*
+	The header of a chunk, followed by its keyframe and then its input. The index holds a copy of every chunk header along with its offset.
+*/
+struct ReplayChunk
+{
+	unsigned long long hash;
+	unsigned int firstTick;
+	unsigned int tickCount;
+	unsigned int keyframeBytes;
+	unsigned int inputBytes;
+	unsigned int offset;
+};
+
+class ReplayC
+{
+public:
+	/* Public functions */
+	ReplayC();
+	~ReplayC();
+
+	bool beginRecording(const char *directory, unsigned long long seed, const int *characters, const MatchInput *initialInput);
+	void record(const MatchSnapshot *stateBefore, const MatchInput *input, DWORD milliseconds);
+	void endRecording();
+
+	bool isRecording();
+
+	bool load(const char *path);
+	void unload();
+
+	bool isLoaded();
+
+	const ReplayHeader *getHeader();
+
+	bool getKeyframe(int tick, MatchSnapshot *snapshot, int *keyframeTick);
+	bool getTick(int tick, MatchInput *input, DWORD *milliseconds);
+
+	int getTickCount();
+	int getFileBytes();
+
+private:
+	/* Private functions */
+	void writeChunk();
+	bool buildIndex();
+	bool decodeChunk(int chunk);
+
+	/* Private data members */
+	FILE *mFile;
+
+	ReplayHeader mHeader;
+
+	ReplayChunk *mChunks;
+	int mChunkCapacity;
+
+	unsigned char *mData;
+	int mSize;
+
+	MatchSnapshot mKeyframe;
+	MatchInput mInputs[REPLAY_KEYFRAME_INTERVAL];
+	DWORD mMilliseconds[REPLAY_KEYFRAME_INTERVAL];
+
+	int mChunkTicks;
+	int mDecodedChunk;
+};
+
+void requestReplays(const char *commandLine);
+const char *getReplayDirectory();
+const char *getRequestedReplay();
+int getRequestedReplaySpeed();
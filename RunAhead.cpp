@@ -0,0 +1,77 @@
+/*
+	RunAhead.cpp
+
+	This file contains the implementation for functions prototyped in RunAhead.h.
+*/
+
+#define _CRT_SECURE_NO_WARNINGS
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "RunAhead.h"
+
+static const char *runAheadOption = "-runahead";
+static int runAheadTicks = 0;
+
+RunAheadCostC::RunAheadCostC()
+{
+	reset();
+}
+
+void RunAheadCostC::reset()
+{
+	mFrames = 0;
+	mSeconds = 0.0;
+	mMaxSeconds = 0.0;
+}
+
+/*
+	Adds the time run-ahead took in one frame.
+*/
+void RunAheadCostC::add(double seconds)
+{
+	mFrames++;
+	mSeconds += seconds;
+
+	if (seconds > mMaxSeconds)
+		mMaxSeconds = seconds;
+}
+
+/*
+	Prints the average and worst time run-ahead took per frame, if it ran.
+*/
+void RunAheadCostC::print(int ticks)
+{
+	if (mFrames == 0)
+		return;
+
+	printf("Running %d tick%s ahead cost %.3f ms per frame on average and %.3f ms at most over %d frames\n",
+		ticks, ticks == 1 ? "" : "s", mSeconds * 1000.0 / mFrames, mMaxSeconds * 1000.0, mFrames);
+}
+
+/*
+	Turns on run-ahead if the command line asks for it with -runahead <ticks>, limited to RUN_AHEAD_MAX_TICKS.
+*/
+void requestRunAhead(const char *commandLine)
+{
+	const char *option = commandLine != NULL ? strstr(commandLine, runAheadOption) : NULL;
+
+	if (option == NULL)
+		return;
+
+	runAheadTicks = atoi(option + strlen(runAheadOption));
+
+	if (runAheadTicks < 0)
+		runAheadTicks = 0;
+	else if (runAheadTicks > RUN_AHEAD_MAX_TICKS)
+		runAheadTicks = RUN_AHEAD_MAX_TICKS;
+}
+
+/*
+	Returns how many ticks ahead of the match the players are drawn, or 0 when run-ahead is off.
+*/
+int getRunAheadTicks()
+{
+	return runAheadTicks;
+}
\ No newline at end of file
@@ -0,0 +1,37 @@
+#pragma once
+/*
+	RunAhead.h
+
+	Run-ahead hides the ticks a move takes to show on screen. After the match ticks each frame, its state is saved,
+	one or two more ticks are simulated with the input of the frame, the players are drawn as they will be, and the state is restored,
+	so the next real tick starts from the match as it was. The game events of the extra ticks are not published, so sounds and rumble come from the real ticks.
+	Starting the game with -runahead <ticks> turns it on for matches played with the controllers, up to RUN_AHEAD_MAX_TICKS.
+	The CPU time it adds to each frame, saving, simulating and restoring but not drawing, is printed when each match ends.
+*/
+
+#define RUN_AHEAD_MAX_TICKS 2
+
+/*
+	The CPU time run-ahead took over the frames of a match.
+*/
+class RunAheadCostC
+{
+public:
+	/* Public functions */
+	RunAheadCostC();
+	~RunAheadCostC() {};
+
+	void reset();
+	void add(double seconds);
+	void print(int ticks);
+
+private:
+	/* Private data members */
+	int mFrames;
+
+	double mSeconds;
+	double mMaxSeconds;
+};
+
+void requestRunAhead(const char *commandLine);
+int getRunAheadTicks();
\ No newline at end of file
@@ -11,8 +11,12 @@
 #include "ScreenManager.h"
 #include "PlayerManager.h"
 #include "Sprite.h"
-#include "SOIL.h"
+#include "TextureManager.h"
 #include "SoundManager.h"
+#include "DesyncCheck.h"
+#include "Replay.h"
+#include "LatencyMonitor.h"
+#include "Benchmark.h"
 
 ScreenManagerC* ScreenManagerC::sInstance = NULL;
 
@@ -26,30 +30,55 @@ ScreenManagerC* ScreenManagerC::CreateInstance()
 }
 
 /*
-	Loads textures and sprites that are used in game screens and menus throughout the game.
+	Builds the texture scopes used in game screens and menus throughout the game and starts loading the menus.
+	The menu scope holds everything the start, control and loading screens draw, the match scope everything drawn during a match,
+	and the results scope everything the end screen draws.
+	A desync check goes straight to the loading screen with the characters of its logs, to run once the match is loaded,
+	and so does a replay asked for on the command line, to play as the first match.
 */
 void ScreenManagerC::init()
 {
 	mButtonProgression = 0;
 	mCurrentScreenState = ScreenState::StartScreen;
+	mScopeState = ScreenState::StartScreen;
 	mWasRendered = false;
+	mRenderedReady = false;
+	mRenderedProgression = 0;
 
-	mStartScreenTexture = loadTexture(startScreenPath);
-	mControlScreenTexture = loadTexture(controlScreenPath);
-	mGameScreenTexture = loadTexture(gameScreenPath);
+	if (isDesyncCheckRequested())
+	{
+		prepareDesyncCheck();
+		mCurrentScreenState = ScreenState::LoadingScreen;
+	}
+	else if (getRequestedReplay() != NULL && PlayerManagerC::GetInstance()->loadReplay(getRequestedReplay()))
+	{
+		mCurrentScreenState = ScreenState::LoadingScreen;
+	}
+
+	mWinningPlayerSprite = NULL;
+	mDigits = NULL;
+
+	mStartScreenTexture = mMenuScope.add(startScreenPath);
+	mStartScreenButtonTexture1 = mMenuScope.add(startScreenButton1Path);
+	mStartScreenButtonTexture2 = mMenuScope.add(startScreenButton2Path);
+	mStartScreenButtonTexture3 = mMenuScope.add(startScreenButton3Path);
+	mControlScreenTexture = mMenuScope.add(controlScreenPath);
+	mLoadingScreenTexture = mMenuScope.add(loadingScreenPath);
 
-	mStartScreenButtonTexture1= loadTexture(startScreenButton1Path);
-	mStartScreenButtonTexture2 = loadTexture(startScreenButton2Path);
-	mStartScreenButtonTexture3 = loadTexture(startScreenButton3Path);
-	mLoadingScreenTexture = loadTexture(loadingScreenPath);
-	mEndScreenTexture = loadTexture(endScreenPath);
+	mGameScreenTexture = mMatchScope.add(gameScreenPath);
+	PlayerManagerC::GetInstance()->addAssets(&mMatchScope);
 
-	mWinningPlayerSprite = new SpriteC(winningPlayerPath, 90.0f, 90.0f, 1, 4);
-	mDigits = new SpriteC(digitsPath, 40.0f, 40.0f, 1, 11);
+	mEndScreenTexture = mResultsScope.add(endScreenPath);
+	mResultsScope.add(winningPlayerPath);
+	mResultsScope.add(digitsPath);
+
+	mMenuScope.acquire(TexturePriority::FirstFrame);
 }
 
 void ScreenManagerC::update(DWORD milliseconds)
 {
+	LatencyMonitorC::GetInstance()->setScreenState(mCurrentScreenState);
+
 	getControllerState();
 
 	if (mControllerState.Gamepad.sThumbLY < deadValue && mControllerState.Gamepad.sThumbLY > -deadValue)
@@ -77,11 +106,22 @@ void ScreenManagerC::update(DWORD milliseconds)
 	}
 
 	mPreviousControllerState = mControllerState;
+
+	updateTextureScopes();
 }
 
+/*
+	Shuts down the players and releases every texture and sprite used by the screens.
+*/
 void ScreenManagerC::shutdown()
 {
 	PlayerManagerC::GetInstance()->shutdown();
+
+	deleteResultSprites();
+
+	mMenuScope.release();
+	mMatchScope.release();
+	mResultsScope.release();
 }
 
 void ScreenManagerC::renderScreen()
@@ -114,6 +154,27 @@ void ScreenManagerC::returnToMainMenu()
 	mCurrentScreenState = ScreenState::StartScreen;
 }
 
+/*
+	Returns true once the textures of the title screen are resident and it can be drawn in full.
+*/
+bool ScreenManagerC::isScreenReady()
+{
+	return mMenuScope.isResident(mStartScreenTexture) && mMenuScope.isResident(mStartScreenButtonTexture1) &&
+		mMenuScope.isResident(mStartScreenButtonTexture2) && mMenuScope.isResident(mStartScreenButtonTexture3);
+}
+
+/*
+	Returns whether the screen has to be drawn again. The title and control screens are drawn again only when the screen or the selected button changes,
+	or while their textures are still loading; every other screen changes from frame to frame.
+*/
+bool ScreenManagerC::isRedrawNeeded()
+{
+	if (mCurrentScreenState != ScreenState::StartScreen && mCurrentScreenState != ScreenState::ControlScreen)
+		return true;
+
+	return !mWasRendered || !mRenderedReady || mButtonProgression != mRenderedProgression;
+}
+
 /* Private functions */
 /*
 	Manages the possible button states on the start screen and changes the state of the game based on what the first player inputs.
@@ -125,6 +186,7 @@ void ScreenManagerC::startScreenUpdate()
 		mButtonProgression = (mButtonProgression - 1 + numButtons) % numButtons;
 		mInputReceived = true;
 
+		LatencyMonitorC::GetInstance()->markInput(mControllerSeconds);
 		SoundManagerC::GetInstance()->playMenuSound();
 	}
 
@@ -132,6 +194,7 @@ void ScreenManagerC::startScreenUpdate()
 	{
 		mButtonProgression = (mButtonProgression + 1) % numButtons;
 		mInputReceived = true;
+		LatencyMonitorC::GetInstance()->markInput(mControllerSeconds);
 		SoundManagerC::GetInstance()->playMenuSound();
 	}
 
@@ -141,6 +204,7 @@ void ScreenManagerC::startScreenUpdate()
 		mCurrentScreenState = ScreenState::LoadingScreen;
 		mWasRendered = false;
 
+		LatencyMonitorC::GetInstance()->markInput(mControllerSeconds);
 		SoundManagerC::GetInstance()->playSelectSound();
 	}
 	else if ((mControllerState.Gamepad.wButtons & XINPUT_GAMEPAD_A) && (mButtonProgression == 1))
@@ -149,6 +213,7 @@ void ScreenManagerC::startScreenUpdate()
 		mCurrentScreenState = ScreenState::ControlScreen;
 		mWasRendered = false;
 
+		LatencyMonitorC::GetInstance()->markInput(mControllerSeconds);
 		SoundManagerC::GetInstance()->playSelectSound();
 	}
 	else if ((mControllerState.Gamepad.wButtons & XINPUT_GAMEPAD_A) && (mButtonProgression == 2))
@@ -169,16 +234,28 @@ void ScreenManagerC::controlScreenUpdate()
 		mCurrentScreenState = ScreenState::StartScreen;
 		mWasRendered = false;
 
+		LatencyMonitorC::GetInstance()->markInput(mControllerSeconds);
 		SoundManagerC::GetInstance()->playSelectSound();
 	}
 }
 
 /*
-	Begins loading music and sets the game state to GameScreen.
-	On the first frame of the main game state, all player sprite sheets are loaded.
+	Waits for the match scope to finish loading, then begins loading music and sets the game state to GameScreen.
+	On the first frame of the main game state, all players are created from the already resident sprite sheets.
+	A desync check runs here instead, then closes the game.
 */
 void ScreenManagerC::loadingScreenUpdate()
 {
+	if (!mMatchScope.isLoaded())
+		return;
+
+	if (isDesyncCheckRequested())
+	{
+		runDesyncCheck();
+		TerminateApplication(g_window);
+		return;
+	}
+
 	mCurrentScreenState = ScreenState::GameScreen;
 	mWasRendered = false;
 
@@ -213,13 +290,19 @@ void ScreenManagerC::endScreenUpdate()
 		mCurrentScreenState = ScreenState::StartScreen;
 		mWasRendered = false;
 
+		LatencyMonitorC::GetInstance()->markInput(mControllerSeconds);
 		SoundManagerC::GetInstance()->playMenuSound();
 	}
 }
 
+/*
+	Reads the first controller, noting the time it was sampled at for measuring the latency of the menus.
+*/
 void ScreenManagerC::getControllerState()
 {
 	XInputGetState(0, &mControllerState);
+
+	mControllerSeconds = getBenchmarkSeconds();
 }
 
 /*
@@ -227,49 +310,55 @@ void ScreenManagerC::getControllerState()
 */
 void ScreenManagerC::renderStartScreen()
 {
-	renderComponent(mStartScreenTexture, -512.0f, 384.0f, 512.0f, -384.0f);
+	renderComponent(mMenuScope.getTexture(mStartScreenTexture), -512.0f, 384.0f, 512.0f, -384.0f);
 	
 	switch (mButtonProgression)
 	{
 	case 0:
-		renderComponent(mStartScreenButtonTexture1, -320.0f, -24.0f, 320.0f, -384.0f, 2);
+		renderComponent(mMenuScope.getTexture(mStartScreenButtonTexture1), -320.0f, -24.0f, 320.0f, -384.0f, 2);
 		break;
 	case 1:
-		renderComponent(mStartScreenButtonTexture2, -320.0f, -24.0f, 320.0f, -384.0f, 2);
+		renderComponent(mMenuScope.getTexture(mStartScreenButtonTexture2), -320.0f, -24.0f, 320.0f, -384.0f, 2);
 		break;
 	case 2:
-		renderComponent(mStartScreenButtonTexture3, -320.0f, -24.0f, 320.0f, -384.0f, 2);
+		renderComponent(mMenuScope.getTexture(mStartScreenButtonTexture3), -320.0f, -24.0f, 320.0f, -384.0f, 2);
 		break;
 	}
 
 	mWasRendered = true;
+	mRenderedReady = isScreenReady();
+	mRenderedProgression = mButtonProgression;
 }
 
 void ScreenManagerC::renderControlScreen()
 {
-	renderComponent(mControlScreenTexture, -512.0f, 384.0f, 512.0f, -384.0f);
+	renderComponent(mMenuScope.getTexture(mControlScreenTexture), -512.0f, 384.0f, 512.0f, -384.0f);
 	mWasRendered = true;
+	mRenderedReady = mMenuScope.isResident(mControlScreenTexture);
+	mRenderedProgression = mButtonProgression;
 }
 
 void ScreenManagerC::renderLoadingScreen()
 {
-	renderComponent(mLoadingScreenTexture, -512.0f, 384.0f, 512.0f, -384.0f);
+	renderComponent(mMenuScope.getTexture(mLoadingScreenTexture), -512.0f, 384.0f, 512.0f, -384.0f);
 	mWasRendered = true;
 }
 
 /*
 	Renders the main game background screen.
 	Entering the main game requires initialization of the PlayerManagerC singleton.
+	Each match is seeded from the clock; the seed is kept by PlayerManagerC so the match can be played again the same way.
 */
 void ScreenManagerC::renderGameScreen()
 {
 	if (!mWasRendered)
 	{
+		PlayerManagerC::GetInstance()->setMatchSeed(GetTickCount());
 		PlayerManagerC::GetInstance()->init();
 		SoundManagerC::GetInstance()->playSelectSound();
 	}
 	
-	renderComponent(mGameScreenTexture, -512.0f, 384.0f, 512.0f, -384.0f);
+	renderComponent(mMatchScope.getTexture(mGameScreenTexture), -512.0f, 384.0f, 512.0f, -384.0f);
 	mWasRendered = true;
 
 	PlayerManagerC::GetInstance()->render();
@@ -280,7 +369,7 @@ void ScreenManagerC::renderGameScreen()
 */
 void ScreenManagerC::renderEndScreen()
 {
-	renderComponent(mEndScreenTexture, -512.0f, 384.0f, 512.0f, -384.0f);
+	renderComponent(mResultsScope.getTexture(mEndScreenTexture), -512.0f, 384.0f, 512.0f, -384.0f);
 
 	int winnerId = PlayerManagerC::GetInstance()->mWinner;
 
@@ -300,9 +389,13 @@ void ScreenManagerC::renderEndScreen()
 /*
 	Renders a component of the screen using the given texture and coordinates.
 	Does not render a buffer around the sides of the texture based on a given buffer size.
+	Nothing is drawn while the texture is still loading.
 */
 void ScreenManagerC::renderComponent(GLuint texture, float startX, float startY, float endX, float endY, int bufferPixels)
 {
+	if (texture == 0)
+		return;
+
 	glEnable(GL_TEXTURE_2D);
 	glBindTexture(GL_TEXTURE_2D, texture);
 	glBegin(GL_QUADS);
@@ -329,10 +422,65 @@ void ScreenManagerC::renderComponent(GLuint texture, float startX, float startY,
 }
 
 /*
-	Loads the texture at the given path, returning an index that can be used by OpenGL to render.
+	Brings the texture scopes in line with the current screen state after a transition.
+	The menus are evicted during a match and the match, including the player sprite sheets, is evicted on returning to the main menu.
+	Each state prefetches the scope of the screen that follows it, so the next transition finds its textures already resident.
+	Runs at the end of the update, after the players are done updating, since returning to the menu deletes them.
+*/
+void ScreenManagerC::updateTextureScopes()
+{
+	if (mScopeState == mCurrentScreenState)
+		return;
+
+	switch (mCurrentScreenState)
+	{
+	case ScreenState::StartScreen:
+	case ScreenState::ControlScreen:
+		mMenuScope.acquire(TexturePriority::Screen);
+
+		PlayerManagerC::GetInstance()->shutdown();
+		deleteResultSprites();
+
+		mMatchScope.release();
+		mResultsScope.release();
+		break;
+	case ScreenState::LoadingScreen:
+		mMatchScope.acquire(TexturePriority::Screen);
+		break;
+	case ScreenState::GameScreen:
+		mMenuScope.release();
+		mResultsScope.acquire(TexturePriority::Prefetch);
+		break;
+	case ScreenState::EndScreen:
+		mResultsScope.acquire(TexturePriority::Screen);
+		createResultSprites();
+
+		mMenuScope.acquire(TexturePriority::Prefetch);
+		break;
+	default:
+		break;
+	}
+
+	mScopeState = mCurrentScreenState;
+}
+
+/*
+	Creates the sprites drawn on the end screen. Their sprite sheets are held by the results scope.
 */
-GLuint ScreenManagerC::loadTexture(char *path)
+void ScreenManagerC::createResultSprites()
+{
+	if (mWinningPlayerSprite == NULL)
+		mWinningPlayerSprite = new SpriteC(winningPlayerPath, 90.0f, 90.0f, 1, 4);
+
+	if (mDigits == NULL)
+		mDigits = new SpriteC(digitsPath, 40.0f, 40.0f, 1, 11);
+}
+
+void ScreenManagerC::deleteResultSprites()
 {
-	return SOIL_load_OGL_texture(path, SOIL_LOAD_AUTO, SOIL_CREATE_NEW_ID,
-		SOIL_FLAG_MIPMAPS | SOIL_FLAG_INVERT_Y | SOIL_FLAG_NTSC_SAFE_RGB | SOIL_FLAG_COMPRESS_TO_DXT);
+	delete mWinningPlayerSprite;
+	delete mDigits;
+
+	mWinningPlayerSprite = NULL;
+	mDigits = NULL;
 }
\ No newline at end of file
@@ -4,6 +4,9 @@
 
 	This is a singleton class that is responsible for managing the state of the game.
 	It renders the background screen every frame as well as initiating any processes between game states.
+	Textures are grouped into scopes for the menus, the match and the results screen. Only the scopes the current state needs are resident,
+	and the scope of the screen that follows is prefetched in the background.
+	The title and control screens only change when they are navigated, so they are only redrawn when something on them changes.
 */
 
 #include "glut.h"
@@ -32,6 +35,9 @@ public:
 
 	void returnToMainMenu();
 
+	bool isScreenReady();
+	bool isRedrawNeeded();
+
 private:
 	/* Private functions */
 	ScreenManagerC() {};
@@ -46,34 +52,44 @@ private:
 	void renderLoadingScreen();
 	void renderGameScreen();
 	void renderEndScreen();
-	void renderComponent(GLuint texture,float startX, float startY, float endX, float endY, int bufferPixels = 0);
-
-	GLuint loadTexture(char *path);
+	void renderComponent(GLuint texture, float startX, float startY, float endX, float endY, int bufferPixels = 0);
+	void updateTextureScopes();
+	void createResultSprites();
+	void deleteResultSprites();
 
 	/* Private data members */
 	static ScreenManagerC *sInstance;
 	bool mWasRendered;
 	bool mInputReceived;
+	bool mRenderedReady;
 
 	int mButtonProgression;
+	int mRenderedProgression;
 
-	GLuint mStartScreenTexture;
-	GLuint mControlScreenTexture;
-	GLuint mGameScreenTexture;
-	GLuint mEndScreenTexture;
-	GLuint mStartScreenButtonTexture1;
-	GLuint mStartScreenButtonTexture2;
-	GLuint mStartScreenButtonTexture3;
-	GLuint mLoadingScreenTexture;
+	int mStartScreenTexture;
+	int mControlScreenTexture;
+	int mGameScreenTexture;
+	int mEndScreenTexture;
+	int mStartScreenButtonTexture1;
+	int mStartScreenButtonTexture2;
+	int mStartScreenButtonTexture3;
+	int mLoadingScreenTexture;
 
 	SpriteC *mWinningPlayerSprite;
 	SpriteC *mDigits;
 
+	TextureScopeC mMenuScope;
+	TextureScopeC mMatchScope;
+	TextureScopeC mResultsScope;
+
 	ScreenState::ScreenState mCurrentScreenState;
+	ScreenState::ScreenState mScopeState;
 
 	XINPUT_STATE mControllerState;
 	XINPUT_STATE mPreviousControllerState;
 
+	double mControllerSeconds;
+
 	/* Private constant data */
 	const short numButtons = 3;
 	const short deadValue = 15000;
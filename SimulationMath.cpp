@@ -0,0 +1,131 @@
+/*
+	SimulationMath.cpp
+
+	This file contains the float rounding prototyped in SimulationMath.h and the benchmark comparing the float and fixed point simulation.
+*/
+
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+#include "SimulationMath.h"
+#include "Benchmark.h"
+
+#define BENCHMARK_BODIES 64
+#define BENCHMARK_TICKS 200000
+#define BENCHMARK_JUMP_TICKS 90
+
+int roundToInt(float value)
+{
+	return (int)floorf(value + 0.5f);
+}
+
+static unsigned int getBits(float value)
+{
+	unsigned int bits;
+
+	memcpy(&bits, &value, sizeof(bits));
+
+	return bits;
+}
+
+static unsigned int getBits(Fixed value)
+{
+	return (unsigned int)value.raw;
+}
+
+/*
+	Moves bodies the way PlayerC moves players: walking between the stage's walls, jumping, falling with gravity up to terminal velocity and landing,
+	over ticks of 16 and 17 milliseconds as a 60 Hz update alternates. Returns a hash of every position and velocity at the end.
+*/
+template <typename Scalar>
+static unsigned int simulateBodies()
+{
+	Scalar positionsX[BENCHMARK_BODIES];
+	Scalar positionsY[BENCHMARK_BODIES];
+	Scalar velocitiesX[BENCHMARK_BODIES];
+	Scalar velocitiesY[BENCHMARK_BODIES];
+	const Scalar speed = Scalar(0.3f);
+	const Scalar jumpSpeed = Scalar(1.15f);
+	const Scalar terminalVelocity = Scalar(2.0f);
+	const Scalar gravityAcceleration = Scalar(0.04f);
+	const Scalar ground = Scalar(-250.0f);
+	const Scalar leftWall = Scalar(-540.0f);
+	const Scalar rightWall = Scalar(397.0f);
+
+	for (int i = 0; i < BENCHMARK_BODIES; i++)
+	{
+		positionsX[i] = Scalar(i * 13 - 400);
+		positionsY[i] = Scalar(-50);
+		velocitiesX[i] = (i & 1) ? speed : -speed;
+		velocitiesY[i] = Scalar(0);
+	}
+
+	for (int tick = 0; tick < BENCHMARK_TICKS; tick++)
+	{
+		int milliseconds = 16 + (tick & 1);
+
+		for (int i = 0; i < BENCHMARK_BODIES; i++)
+		{
+			if ((tick + i) % BENCHMARK_JUMP_TICKS == 0 && positionsY[i] <= ground)
+				velocitiesY[i] = jumpSpeed;
+			else
+				velocitiesY[i] -= gravityAcceleration;
+
+			if (velocitiesY[i] < -terminalVelocity)
+				velocitiesY[i] = -terminalVelocity;
+
+			positionsX[i] = positionsX[i] + velocitiesX[i] * milliseconds;
+			positionsY[i] = positionsY[i] + velocitiesY[i] * milliseconds;
+
+			if (positionsY[i] <= ground)
+			{
+				positionsY[i] = ground;
+				velocitiesY[i] = Scalar(0);
+			}
+
+			if (positionsX[i] <= leftWall || positionsX[i] >= rightWall)
+			{
+				positionsX[i] = positionsX[i] <= leftWall ? leftWall : rightWall;
+				velocitiesX[i] = -velocitiesX[i];
+			}
+		}
+	}
+
+	unsigned int hash = 2166136261u;
+
+	for (int i = 0; i < BENCHMARK_BODIES; i++)
+	{
+		hash = (hash ^ getBits(positionsX[i])) * 16777619u;
+		hash = (hash ^ getBits(positionsY[i])) * 16777619u;
+		hash = (hash ^ getBits(velocitiesX[i])) * 16777619u;
+		hash = (hash ^ getBits(velocitiesY[i])) * 16777619u;
+	}
+
+	return hash;
+}
+
+/*
+	Times the same motion in floats and in fixed point and prints the hash of each final state.
+	The fixed point hash is the same for every build of the game, which makes it a quick check of determinism across compilers:
+	run the benchmark from two builds and compare. The float hash may differ between builds.
+*/
+void benchmarkFixedPoint()
+{
+	double start = getBenchmarkSeconds();
+	unsigned int floatHash = simulateBodies<float>();
+	double floatSeconds = getBenchmarkSeconds() - start;
+
+	start = getBenchmarkSeconds();
+
+	unsigned int fixedHash = simulateBodies<Fixed>();
+	double fixedSeconds = getBenchmarkSeconds() - start;
+	double bodyTicks = (double)BENCHMARK_BODIES * BENCHMARK_TICKS;
+
+	printf("  float:       %5.2f ns per body tick, state hash %08x (may differ between builds)\n", floatSeconds * 1e9 / bodyTicks, floatHash);
+	printf("  fixed point: %5.2f ns per body tick, state hash %08x (the same on every build)\n", fixedSeconds * 1e9 / bodyTicks, fixedHash);
+#ifdef FIXED_POINT_SIMULATION
+	printf("  this build simulates in fixed point\n");
+#else
+	printf("  this build simulates in floats\n");
+#endif
+}
\ No newline at end of file
@@ -0,0 +1,77 @@
+#pragma once
+/*
+	SimulationMath.h
+
+	The numbers the simulation moves players with. By default they are floats.
+	The Fixed configuration of the project defines FIXED_POINT_SIMULATION, which switches positions, velocities and boxes to 16.16 fixed point.
+	Its integer arithmetic gives bit-identical results on every compiler, optimization level and instruction set, which replays and netplay across builds need.
+	Timers are whole milliseconds and boxes are whole pixels in either mode, so only the motion of the players depends on it.
+	Rendering and sound read the simulation through floats converted from it and never feed anything back.
+	The determinism benchmark checks the result of a scripted match against the hash expected of each mode.
+*/
+
+#include "baseTypes.h"
+
+#define FIXED_POINT_FRACTION_BITS 16
+#define FIXED_POINT_ONE (1 << FIXED_POINT_FRACTION_BITS)
+
+/*
+	A 16.16 fixed point number.
+	Constants are converted from float literals by scaling with a power of two and truncating, which is exact on every compiler.
+	Products go through 64 bits and are rounded toward negative infinity; quotients by whole numbers are rounded toward zero.
+*/
+struct Fixed
+{
+	int raw;
+
+	Fixed() = default;
+	constexpr explicit Fixed(float value) : raw((int)(value * FIXED_POINT_ONE)) {}
+	constexpr explicit Fixed(int value) : raw(value * FIXED_POINT_ONE) {}
+
+	static Fixed fromRaw(int raw) { Fixed value; value.raw = raw; return value; }
+
+	Fixed operator-() const { return fromRaw(-raw); }
+	Fixed operator+(Fixed other) const { return fromRaw(raw + other.raw); }
+	Fixed operator-(Fixed other) const { return fromRaw(raw - other.raw); }
+	Fixed operator*(Fixed other) const { return fromRaw((int)(((long long)raw * other.raw) >> FIXED_POINT_FRACTION_BITS)); }
+	Fixed operator*(int other) const { return fromRaw(raw * other); }
+	Fixed operator/(int other) const { return fromRaw(raw / other); }
+
+	Fixed &operator+=(Fixed other) { raw += other.raw; return *this; }
+	Fixed &operator-=(Fixed other) { raw -= other.raw; return *this; }
+
+	bool operator<(Fixed other) const { return raw < other.raw; }
+	bool operator>(Fixed other) const { return raw > other.raw; }
+	bool operator<=(Fixed other) const { return raw <= other.raw; }
+	bool operator>=(Fixed other) const { return raw >= other.raw; }
+	bool operator==(Fixed other) const { return raw == other.raw; }
+	bool operator!=(Fixed other) const { return raw != other.raw; }
+};
+
+#ifdef FIXED_POINT_SIMULATION
+typedef Fixed SimScalar;
+#else
+typedef float SimScalar;
+#endif
+
+struct SimCoord2D
+{
+	SimScalar x;
+	SimScalar y;
+};
+
+inline float toFloat(float value) { return value; }
+inline float toFloat(Fixed value) { return value.raw * (1.0f / FIXED_POINT_ONE); }
+
+/*
+	Rounds to the nearest whole number, halves upward.
+*/
+int roundToInt(float value);
+inline int roundToInt(Fixed value) { return (value.raw + FIXED_POINT_ONE / 2) >> FIXED_POINT_FRACTION_BITS; }
+
+inline Coord2D toCoord2D(SimCoord2D coordinate)
+{
+	Coord2D converted = { toFloat(coordinate.x), toFloat(coordinate.y) };
+
+	return converted;
+}
\ No newline at end of file
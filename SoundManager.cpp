@@ -6,7 +6,11 @@
 
 #define _CRT_SECURE_NO_WARNINGS
 
+#include <stdlib.h>
+#include <string.h>
 #include "SoundManager.h"
+#include "AudioMixer.h"
+#include "AssetPackage.h"
 #include "Windows.h"
 
 SoundManagerC* SoundManagerC::sInstance = NULL;
@@ -20,66 +24,460 @@ SoundManagerC* SoundManagerC::CreateInstance()
 	return sInstance;
 }
 
+/*
+	Loads the compressed audio bank, in place from the asset package when there is one, opens the mixer's output device and starts the audio thread.
+	The GameEventManagerC singleton must be initialized first.
+	All voice and mixing buffers are members, so playing a sound never allocates.
+*/
 void SoundManagerC::init()
 {
+	InitializeCriticalSection(&mVoiceLock);
+
+	for (int i = 0; i < MAX_MIXER_VOICES; i++)
+		mVoices[i].active = false;
+
+	mVoiceSerial = 0;
+
+	mDevice = NULL;
+	mBufferDone = CreateEvent(NULL, FALSE, FALSE, NULL);
 
+	initAudioMixer();
+
+	AssetPackageC *package = AssetPackageC::GetInstance();
+	int bankSize = 0;
+	const unsigned char *bankData = package != NULL ? package->getAssetData(audioBankPath, &bankSize) : NULL;
+
+	if (bankData != NULL ? mBank.loadFromMemory(bankData, bankSize) : mBank.load(audioBankPath))
+		openDevice();
+
+	mRunning.store(true);
+
+	mAudioThread = CreateThread(NULL, 0, audioThreadProc, this, 0, NULL);
 }
 
 void SoundManagerC::shutdown()
 {
+	mRunning.store(false);
+	SetEvent(GameEventManagerC::GetInstance()->getAudioSignal());
+
+	WaitForSingleObject(mAudioThread, INFINITE);
+	CloseHandle(mAudioThread);
 
+	mMusicStream.stop();
+	PlaySound(NULL, NULL, SND_ASYNC);
+
+	closeDevice();
+	CloseHandle(mBufferDone);
+	mBank.unload();
+
+	DeleteCriticalSection(&mVoiceLock);
 }
 
 /*
-	Plays sounds at the given index into the Kirby animation sheet.
-	Ends any sound being played by this process before potentially playing a voice sound or sound effect.
+	Plays the sounds of a character's animation for a player, panned from -1 (left) to 1 (right).
+	Landing sounds play in the landing category, anything else as a voice sound and an attack sound effect.
+	Without the mixer, ends any sound effect being played by this process before potentially playing a voice sound or sound effect.
 */
-void SoundManagerC::playKirbySound(int animationIndex)
+void SoundManagerC::playCharacterSound(const CharacterDefinition *character, int animationIndex, int playerId, bool landing, float pan)
 {
-	PlaySound(NULL, NULL, SND_ASYNC);
+	const CharacterSounds *sounds = character->sounds;
+
+	if (mDevice == NULL)
+		PlaySound(NULL, NULL, SND_ASYNC);
 
-	if (strcmp(voiceSounds[animationIndex], ""))
+	if (strcmp(sounds->voiceSounds[animationIndex], ""))
 	{
 		char path[50];
 		strcpy(path, voiceSoundDirectory);
-		strcat(path, voiceSounds[animationIndex]);
+		strcat(path, sounds->voiceSounds[animationIndex]);
 		strcat(path, fileExtension);
 
-		PlaySound(path, NULL, SND_FILENAME | SND_ASYNC);
+		playFile(path, landing ? SoundCategory::Landing : SoundCategory::Voice, playerId, pan);
 	}
 	
-	if (strcmp(soundEffects[animationIndex], ""))
+	if (strcmp(sounds->soundEffects[animationIndex], ""))
 	{
 		char path[50];
 		strcpy(path, soundEffectDirectory);
-		strcat(path, soundEffects[animationIndex]);
+		strcat(path, sounds->soundEffects[animationIndex]);
 		strcat(path, fileExtension);
 
-		PlaySound(path, NULL, SND_FILENAME | SND_ASYNC);
+		playFile(path, landing ? SoundCategory::Landing : SoundCategory::Attack, playerId, pan);
 	}
 }
 
 void SoundManagerC::playMenuSound()
 {
-	PlaySound(menuSound, NULL, SND_FILENAME | SND_ASYNC);
+	GameEventManagerC::GetInstance()->post(GameEventType::MenuSound, MENU_PLAYER_ID, MenuSound::Open);
 }
 
 void SoundManagerC::playSelectSound()
 {
-	PlaySound(selectSound, NULL, SND_FILENAME | SND_ASYNC);
+	GameEventManagerC::GetInstance()->post(GameEventType::MenuSound, MENU_PLAYER_ID, MenuSound::Select);
 }
 
+/*
+	Starts the Final Destination music on the streaming music channel if it is not already playing.
+	The music plays on its own device, so sound effects no longer stop it.
+*/
 void SoundManagerC::playLoadingMusic()
 {
-	PlaySound(loadingMusic, NULL, SND_FILENAME | SND_LOOP | SND_ASYNC);
+	if (!mMusicStream.isPlaying())
+		mMusicStream.play(musicLeftChannels, musicRightChannels, musicSegmentCount);
 }
 
 void SoundManagerC::playCloseMenuSound()
 {
-	PlaySound(closeMenuSound, NULL, SND_FILENAME | SND_ASYNC);
+	GameEventManagerC::GetInstance()->post(GameEventType::MenuSound, MENU_PLAYER_ID, MenuSound::Close);
 }
 
 void SoundManagerC::playWinSound()
 {
-	PlaySound(winSound, NULL, SND_FILENAME | SND_ASYNC);
+	GameEventManagerC::GetInstance()->post(GameEventType::MenuSound, MENU_PLAYER_ID, MenuSound::Win);
+}
+
+/* Private functions */
+/*
+	Returns how loud a voice is playing: the louder of its panned gains, as voices keep the same gain until they end.
+*/
+static float getVoiceLevel(const MixerVoice *voice)
+{
+	return voice->leftGain > voice->rightGain ? voice->leftGain : voice->rightGain;
+}
+
+/*
+	Orders events by tick, then player, then type and animation.
+*/
+static int compareEvents(const GameEvent &a, const GameEvent &b)
+{
+	if (a.tick != b.tick)
+		return a.tick - b.tick > 0x80000000u ? -1 : 1;
+
+	if (a.playerId != b.playerId)
+		return a.playerId < b.playerId ? -1 : 1;
+
+	if (a.type != b.type)
+		return a.type < b.type ? -1 : 1;
+
+	return a.animationIndex - b.animationIndex;
+}
+
+DWORD WINAPI SoundManagerC::audioThreadProc(LPVOID parameter)
+{
+	((SoundManagerC *)parameter)->run();
+
+	return 0;
+}
+
+/*
+	Keeps every mixer buffer queued on the device and plays the sound of every event the simulation publishes.
+	Both the simulation signal and the device's buffer done signal wake the thread.
+*/
+void SoundManagerC::run()
+{
+	GameEventQueueC *queue = GameEventManagerC::GetInstance()->getAudioQueue();
+	HANDLE signals[2] = { GameEventManagerC::GetInstance()->getAudioSignal(), mBufferDone };
+
+	if (mDevice != NULL)
+	{
+		for (int i = 0; i < MIXER_BUFFER_COUNT; i++)
+		{
+			mixBuffer(&mHeaders[i]);
+			waveOutWrite(mDevice, &mHeaders[i], sizeof(WAVEHDR));
+		}
+	}
+
+	while (mRunning.load())
+	{
+		WaitForMultipleObjects(2, signals, FALSE, INFINITE);
+
+		handleEvents(queue);
+
+		if (mDevice == NULL)
+			continue;
+
+		for (int i = 0; i < MIXER_BUFFER_COUNT && mRunning.load(); i++)
+		{
+			if (mHeaders[i].dwFlags & WHDR_DONE)
+			{
+				mixBuffer(&mHeaders[i]);
+				waveOutWrite(mDevice, &mHeaders[i], sizeof(WAVEHDR));
+			}
+		}
+	}
+}
+
+/*
+	Plays the sounds of every published event, menu sounds included.
+	The events are sorted by tick, player and type first, so the voices that get stolen never depend on the order the players updated in.
+	Animations whose move timeline cues their sound play it on the cue alone, rather than with the event that started them.
+*/
+void SoundManagerC::handleEvents(GameEventQueueC *queue)
+{
+	GameEvent events[GAME_EVENT_QUEUE_SIZE];
+	int count = 0;
+
+	while (count < GAME_EVENT_QUEUE_SIZE && queue->pop(&events[count]))
+	{
+		GameEvent event = events[count];
+		int i = count++;
+
+		for (; i > 0 && compareEvents(event, events[i - 1]) < 0; i--)
+			events[i] = events[i - 1];
+
+		events[i] = event;
+	}
+
+	for (int i = 0; i < count; i++)
+	{
+		GameEvent *event = &events[i];
+
+		if (event->type == GameEventType::MenuSound)
+		{
+			if (event->animationIndex >= 0 && event->animationIndex < MenuSound::Count)
+				playFile(menuSounds[event->animationIndex], SoundCategory::Menu, MENU_PLAYER_ID);
+
+			continue;
+		}
+
+		if (event->character == NULL || event->animationIndex < 0 || event->type == GameEventType::Invulnerable || event->type == GameEventType::KO)
+			continue;
+
+		bool cued = hasMoveEvent(event->character->timelines, event->character->moves->sheetColumns[event->animationIndex], MoveEventType::Sound);
+
+		if (cued == (event->type == GameEventType::Cued))
+			playCharacterSound(event->character, event->animationIndex, event->playerId, event->type == GameEventType::Landed, event->pan);
+	}
+}
+
+/*
+	Plays the clip stored under the given path on behalf of a player.
+	A clip found in the bank is started as a mixer voice, anything else is handed to PlaySound as a loose file.
+*/
+void SoundManagerC::playFile(const char *path, SoundCategory::SoundCategory category, int playerId, float pan)
+{
+	const AudioClipEntry *clip = mBank.isLoaded() ? mBank.findClip(path) : NULL;
+
+	if (clip != NULL && mDevice != NULL)
+		startVoice(clip, category, playerId, pan);
+	else
+		PlaySound(path, NULL, SND_FILENAME | SND_ASYNC);
+}
+
+/*
+	Mixes every active voice into one output buffer, retiring the voices that reach the end of their clip.
+*/
+void SoundManagerC::mixBuffer(WAVEHDR *header)
+{
+	clearBus(mBus, MIXER_BUFFER_FRAMES);
+
+	EnterCriticalSection(&mVoiceLock);
+
+	for (int i = 0; i < MAX_MIXER_VOICES; i++)
+	{
+		MixerVoice *voice = &mVoices[i];
+
+		if (!voice->active)
+			continue;
+
+		int frames = fetchVoice(voice, mVoiceSamples, MIXER_BUFFER_FRAMES);
+
+		mixVoice(mBus, mVoiceSamples, frames, voice->clip->channels, voice->leftGain, voice->rightGain);
+
+		if (frames < MIXER_BUFFER_FRAMES)
+			voice->active = false;
+	}
+
+	LeaveCriticalSection(&mVoiceLock);
+
+	clipBus(mBus, (short *)header->lpData, MIXER_BUFFER_FRAMES);
+}
+
+/*
+	Starts a clip on the voice picked by findVoiceSlot. The sound is dropped if no voice can be taken for it.
+*/
+bool SoundManagerC::startVoice(const AudioClipEntry *clip, SoundCategory::SoundCategory category, int playerId, float pan)
+{
+	if (clip->channels > MAX_VOICE_CHANNELS || clip->sampleRate != MIXER_SAMPLE_RATE)
+		return false;
+
+	EnterCriticalSection(&mVoiceLock);
+
+	int slot = findVoiceSlot(category, playerId);
+
+	if (slot >= 0)
+	{
+		MixerVoice *voice = &mVoices[slot];
+
+		voice->clip = clip;
+		voice->category = category;
+		voice->playerId = playerId;
+		voice->serial = mVoiceSerial++;
+		voice->blockIndex = -1;
+		voice->blockFrames = 0;
+		voice->blockPosition = 0;
+		voice->gain = categoryGains[category];
+		voice->active = true;
+
+		getPanGains(pan, voice->gain, &voice->leftGain, &voice->rightGain);
+	}
+
+	LeaveCriticalSection(&mVoiceLock);
+
+	return slot >= 0;
+}
+
+/*
+	Picks the voice a new sound of the given category should play on, or -1 if the sound should be dropped.
+	A player already at the limit of the category replaces their own oldest voice of it.
+	Otherwise a free voice is used, and if there is none the lowest priority voice no more important than the new sound is stolen,
+	preferring the quietest and then the oldest so the same sequence of sounds always steals the same voices.
+*/
+int SoundManagerC::findVoiceSlot(SoundCategory::SoundCategory category, int playerId)
+{
+	int owned = 0;
+	int oldestOwned = -1;
+	int freeSlot = -1;
+	int victim = -1;
+
+	for (int i = 0; i < MAX_MIXER_VOICES; i++)
+	{
+		MixerVoice *voice = &mVoices[i];
+
+		if (!voice->active)
+		{
+			if (freeSlot < 0)
+				freeSlot = i;
+
+			continue;
+		}
+
+		if (voice->category == category && voice->playerId == playerId)
+		{
+			owned++;
+
+			if (oldestOwned < 0 || voice->serial - mVoices[oldestOwned].serial > 0x80000000u)
+				oldestOwned = i;
+		}
+
+		if (voice->category > category)
+			continue;
+
+		if (victim < 0)
+		{
+			victim = i;
+			continue;
+		}
+
+		MixerVoice *current = &mVoices[victim];
+
+		if (voice->category != current->category)
+		{
+			if (voice->category < current->category)
+				victim = i;
+		}
+		else if (getVoiceLevel(voice) != getVoiceLevel(current))
+		{
+			if (getVoiceLevel(voice) < getVoiceLevel(current))
+				victim = i;
+		}
+		else if (voice->serial - current->serial > 0x80000000u)
+		{
+			victim = i;
+		}
+	}
+
+	if (owned >= categoryPlayerLimits[category])
+		return oldestOwned;
+
+	return freeSlot >= 0 ? freeSlot : victim;
+}
+
+bool SoundManagerC::decodeNextBlock(MixerVoice *voice)
+{
+	voice->blockIndex++;
+	voice->blockFrames = mBank.decodeClipBlock(voice->clip, voice->blockIndex, voice->block);
+	voice->blockPosition = 0;
+
+	return voice->blockFrames > 0;
+}
+
+/*
+	Copies up to frames frames of a voice into output, decoding blocks as they are needed.
+	Returns the number of frames written, fewer than asked for once the clip ends.
+*/
+int SoundManagerC::fetchVoice(MixerVoice *voice, short *output, int frames)
+{
+	int channels = voice->clip->channels;
+	int fetched = 0;
+
+	while (fetched < frames)
+	{
+		if (voice->blockPosition >= voice->blockFrames)
+		{
+			if (!decodeNextBlock(voice))
+				break;
+		}
+
+		int run = voice->blockFrames - voice->blockPosition;
+
+		if (run > frames - fetched)
+			run = frames - fetched;
+
+		memcpy(output + fetched * channels, voice->block + voice->blockPosition * channels, run * channels * sizeof(short));
+
+		fetched += run;
+		voice->blockPosition += run;
+	}
+
+	return fetched;
+}
+
+/*
+	Opens the mixer's output device as 16-bit stereo at the mixer rate.
+	The device signals mBufferDone every time it finishes playing a buffer.
+*/
+bool SoundManagerC::openDevice()
+{
+	WAVEFORMATEX format;
+
+	ZeroMemory(&format, sizeof(WAVEFORMATEX));
+
+	format.wFormatTag = WAVE_FORMAT_PCM;
+	format.nChannels = 2;
+	format.nSamplesPerSec = MIXER_SAMPLE_RATE;
+	format.wBitsPerSample = 16;
+	format.nBlockAlign = format.nChannels * format.wBitsPerSample / 8;
+	format.nAvgBytesPerSec = format.nSamplesPerSec * format.nBlockAlign;
+
+	if (waveOutOpen(&mDevice, WAVE_MAPPER, &format, (DWORD_PTR)mBufferDone, 0, CALLBACK_EVENT) != MMSYSERR_NOERROR)
+	{
+		mDevice = NULL;
+		return false;
+	}
+
+	for (int i = 0; i < MIXER_BUFFER_COUNT; i++)
+	{
+		ZeroMemory(&mHeaders[i], sizeof(WAVEHDR));
+		mHeaders[i].lpData = (LPSTR)mBufferData[i];
+		mHeaders[i].dwBufferLength = sizeof(mBufferData[i]);
+
+		waveOutPrepareHeader(mDevice, &mHeaders[i], sizeof(WAVEHDR));
+	}
+
+	return true;
+}
+
+void SoundManagerC::closeDevice()
+{
+	if (mDevice == NULL)
+		return;
+
+	waveOutReset(mDevice);
+
+	for (int i = 0; i < MIXER_BUFFER_COUNT; i++)
+		waveOutUnprepareHeader(mDevice, &mHeaders[i], sizeof(WAVEHDR));
+
+	waveOutClose(mDevice);
+	mDevice = NULL;
 }
\ No newline at end of file
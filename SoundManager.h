@@ -3,9 +3,66 @@
 	SoundManager.h		written by Louis Hofer
 	
 	This is a singleton class built to manage the playing of sounds from anywhere in the game.
-	It exposes public methods for playing specific sounds as well as sounds associated with an index into the Kirby animation sheet.
+	It exposes public methods for playing specific sounds as well as the sounds a character associates with each of its animations.
+	Sounds raised by the simulation arrive as game events and are played from the audio thread.
+	Menu sounds are posted as game events too, so every voice is started on the audio thread, in the order the events arrive.
+	Sound effects are kept compressed in an AudioBankC and decoded only when played, falling back to the loose wave files if no bank was built.
+	Clips from the bank are played as voices mixed by the audio thread onto a single stereo output device,
+	so they can overlap and each one is panned to the position of the player that raised it.
+	Voices come from a fixed pool. Every sound category has a priority and a limit on how many voices one player may hold,
+	and when the pool is full the quietest, then oldest, voice of the lowest priority is stolen.
+	Voices have no envelope, so a voice's level is the louder of its two panned gains.
 */
 
+#include <windows.h>
+#include <atomic>
+#include "GameEventManager.h"
+#include "MusicStream.h"
+#include "AudioBank.h"
+#include "Adpcm.h"
+#include "Character.h"
+
+#define MIXER_SAMPLE_RATE AUDIO_BANK_SAMPLE_RATE
+#define MIXER_BUFFER_COUNT 4
+#define MIXER_BUFFER_FRAMES 480
+#define MAX_MIXER_VOICES 16
+#define MAX_VOICE_CHANNELS 2
+#define MENU_PLAYER_ID -1
+
+/*
+	Enumeration used to represent the kind of sound a voice is playing, in increasing order of priority.
+*/
+namespace SoundCategory
+{
+	enum SoundCategory { Landing, Attack, Voice, Menu, MaxCategory };
+}
+
+/*
+	A clip being played by the mixer. The clip is decoded one ADPCM block at a time into the voice's own block buffer.
+*/
+struct MixerVoice
+{
+	bool active;
+
+	const AudioClipEntry *clip;
+
+	SoundCategory::SoundCategory category;
+
+	int playerId;
+
+	unsigned int serial;
+
+	int blockIndex;
+	int blockFrames;
+	int blockPosition;
+
+	float gain;
+	float leftGain;
+	float rightGain;
+
+	short block[ADPCM_SAMPLES_PER_BLOCK * MAX_VOICE_CHANNELS];
+};
+
 class SoundManagerC
 {
 public:
@@ -16,7 +73,7 @@ public:
 
 	void init();
 	void shutdown();
-	void playKirbySound(int animationIndex);
+	void playCharacterSound(const CharacterDefinition *character, int animationIndex, int playerId, bool landing, float pan = 0.0f);
 	void playMenuSound();
 	void playSelectSound();
 	void playLoadingMusic();
@@ -27,36 +84,76 @@ private:
 	/* Private functions */
 	SoundManagerC() {};
 
+	static DWORD WINAPI audioThreadProc(LPVOID parameter);
+
+	void run();
+	void handleEvents(GameEventQueueC *queue);
+	void playFile(const char *path, SoundCategory::SoundCategory category, int playerId, float pan = 0.0f);
+	void mixBuffer(WAVEHDR *header);
+
+	bool startVoice(const AudioClipEntry *clip, SoundCategory::SoundCategory category, int playerId, float pan);
+	int findVoiceSlot(SoundCategory::SoundCategory category, int playerId);
+	bool decodeNextBlock(MixerVoice *voice);
+	int fetchVoice(MixerVoice *voice, short *output, int frames);
+
+	bool openDevice();
+	void closeDevice();
+
 	/* Private data members */
 	static SoundManagerC *sInstance;
 
+	std::atomic<bool> mRunning;
+
+	HANDLE mAudioThread;
+	HANDLE mBufferDone;
+
+	HWAVEOUT mDevice;
+
+	WAVEHDR mHeaders[MIXER_BUFFER_COUNT];
+
+	CRITICAL_SECTION mVoiceLock;
+
+	MixerVoice mVoices[MAX_MIXER_VOICES];
+
+	unsigned int mVoiceSerial;
+
+	float mBus[MIXER_BUFFER_FRAMES * 2];
+
+	short mVoiceSamples[MIXER_BUFFER_FRAMES * MAX_VOICE_CHANNELS];
+	short mBufferData[MIXER_BUFFER_COUNT][MIXER_BUFFER_FRAMES * 2];
+
+	AudioBankC mBank;
+
+	MusicStreamC mMusicStream;
+
 	/* Private constant data */
-	const char *loadingMusic = "Sounds/FinalDestination/last00L.dsp.wav";
-	const char *menuSound = "Sounds/MenuSounds/main61.dsp.wav";
-	const char *selectSound = "Sounds/SoundEffects/snd_se_Kirby_Appear01.wav";
-	const char *closeMenuSound = "Sounds/MenuSounds/main60.dsp.wav";
-	const char *winSound = "Sounds/MenuSounds/maind9L.dsp.wav";
+	const int musicSegmentCount = 3;
+	const char *audioBankPath = "Sounds/Sounds.bank";
+	const char *menuSounds[MenuSound::Count] =
+	{
+		"Sounds/MenuSounds/main61.dsp.wav",
+		"Sounds/SoundEffects/snd_se_Kirby_Appear01.wav",
+		"Sounds/MenuSounds/main60.dsp.wav",
+		"Sounds/MenuSounds/maind9L.dsp.wav"
+	};
 	const char *voiceSoundDirectory = "Sounds/VoiceSounds/";
 	const char *soundEffectDirectory = "Sounds/SoundEffects/";
 	const char *fileExtension = ".wav";
 
-	const char *voiceSounds[33] =
+	const float categoryGains[SoundCategory::MaxCategory] = { 0.6f, 0.8f, 1.0f, 1.0f };
+	const int categoryPlayerLimits[SoundCategory::MaxCategory] = { 1, 2, 1, 2 };
+
+	const char *musicLeftChannels[3] =
 	{
-		"snd_se_Kirby_Landing02","snd_se_Kirby_Landing02","","","","",
-		"","","","","","",
-		"","","","","","",
-		"","","","snd_vc_kirby_Damage02","snd_vc_kirby_Damage02","",
-		"","","","snd_vc_kirby_Appeal03","","",
-		"","",""
+		"Sounds/FinalDestination/last00L.dsp.wav",
+		"Sounds/FinalDestination/last01L.dsp.wav",
+		"Sounds/FinalDestination/last02L.dsp.wav"
 	};
 
-	const char *soundEffects[33] =
+	const char *musicRightChannels[3] =
 	{
-		"snd_se_Kirby_Landing02","snd_se_Kirby_Landing02","","","","snd_se_Kirby_jump01",
-		"snd_se_Kirby_jump01","snd_se_Kirby_dash_start","snd_se_Kirby_dash_start","snd_se_Kirby_smash_H01","snd_se_Kirby_smash_H01","snd_se_Kirby_smash_L01",
-		"snd_se_Kirby_smash_L01","snd_se_Kirby_AttackDash","snd_se_Kirby_AttackDash","snd_se_Kirby_Attack100","snd_se_Kirby_Attack100","snd_se_Kirby_smash_S01",
-		"snd_se_Kirby_smash_S01","snd_se_Kirby_AttackAir_L01","snd_se_Kirby_AttackAir_L01","","","snd_se_Kirby_Escape",
-		"snd_se_Kirby_Escape","","","","snd_se_Kirby_Special_S01","snd_se_Kirby_Special_C3_H01",
-		"snd_se_Kirby_Special_C3_H01","snd_se_Kirby_swing_l","snd_se_Kirby_swing_l"
+		"Sounds/FinalDestination/last00R.dsp.wav",
+		"Sounds/FinalDestination/last01R.dsp.wav",
+		"Sounds/FinalDestination/last02R.dsp.wav"
 	};
 };
\ No newline at end of file
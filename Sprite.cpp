@@ -4,18 +4,19 @@
 	This file contains the implementation of the functions prototyped in the SpriteC class.
 */
 
+#include <math.h>
 #include "Sprite.h"
-#include "SOIL.h"
 
 /* Public functions */
 /*
-	Upon creation of a sprite, the sprite sheet is loaded into memory.
-	This can be slow if the sprite sheet is of a significant size.
+	Upon creation of a sprite, a reference to the sprite sheet is acquired, queueing it for loading at the given priority.
+	If the sprite sheet was trimmed, its atlas texture is acquired instead. Sprites sharing a sprite sheet share its texture.
 */
-SpriteC::SpriteC(char *spriteMapFilePath, float height, float width, int rows, int columns)
+SpriteC::SpriteC(char *spriteMapFilePath, float height, float width, int rows, int columns, TexturePriority::TexturePriority priority)
 {
-	mSpriteMap = SOIL_load_OGL_texture(spriteMapFilePath, SOIL_LOAD_AUTO, SOIL_CREATE_NEW_ID,
-		SOIL_FLAG_MIPMAPS | SOIL_FLAG_INVERT_Y | SOIL_FLAG_NTSC_SAFE_RGB | SOIL_FLAG_COMPRESS_TO_DXT);
+	mAtlas.load(spriteMapFilePath);
+
+	mSpriteMap = TextureManagerC::GetInstance()->acquire(mAtlas.getTexturePath(), priority);
 	mHeight = height;
 	mWidth = width;
 	mStartX = 0;
@@ -24,24 +25,46 @@ SpriteC::SpriteC(char *spriteMapFilePath, float height, float width, int rows, i
 	mColumns = columns;
 }
 
-SpriteC::~SpriteC(){}
+/*
+	Releases the sprite's reference to its sprite sheet, freeing the texture if no other sprite uses it.
+*/
+SpriteC::~SpriteC()
+{
+	TextureManagerC::GetInstance()->release(mSpriteMap);
+}
 
 /*
 	Renders the sprite given a position to be drawn and the row and column into the sheet.
 	If the useBuffer flag is set, rendering will skip the drawing of a specified number of pixels all four sides of the texture.
+	If the mirrored flag is set, the cell is flipped horizontally by swapping its left and right texture coordinates.
+	Trimmed frames carry their own transparent border, so no buffer is skipped when drawing them.
 */
-void SpriteC::render(Coord2D position, float u, float v, bool useBuffer)
+void SpriteC::render(Coord2D position, float u, float v, bool useBuffer, bool mirrored)
 {
-	int bufferPixels = numberOfPixelsAsBuffer;
+	GLuint texture = getSpriteMap();
 
-	if (!useBuffer)
-		bufferPixels = 0;
+	if (texture == 0)
+		return;
 
 	mStartX = u;
 	mStartY = v;
 
+	if (mAtlas.isLoaded())
+	{
+		glEnable(GL_TEXTURE_2D);
+		glBindTexture(GL_TEXTURE_2D, texture);
+
+		renderTrimmed(position, mAtlas.getFrame((int)u, (int)v), mirrored);
+		return;
+	}
+
+	int bufferPixels = numberOfPixelsAsBuffer;
+
+	if (!useBuffer)
+		bufferPixels = 0;
+
 	glEnable(GL_TEXTURE_2D);
-	glBindTexture(GL_TEXTURE_2D, mSpriteMap);
+	glBindTexture(GL_TEXTURE_2D, texture);
 	glBegin(GL_QUADS);
 
 	GLfloat xPositionLeft = ((position.x + bufferPixels) * horizontalRatio);
@@ -56,25 +79,155 @@ void SpriteC::render(Coord2D position, float u, float v, bool useBuffer)
 	GLfloat xTextureCoord = (mStartX / mColumns);
 	GLfloat yTextureCoord = ((mRows - mStartY - 1) / mRows);
 
+	GLfloat leftTextureCoord = xTextureCoord + horizontalBuffer;
+	GLfloat rightTextureCoord = xTextureCoord + (1.0f / mColumns) - horizontalBuffer;
+
+	if (mirrored)
+	{
+		GLfloat swap = leftTextureCoord;
+		leftTextureCoord = rightTextureCoord;
+		rightTextureCoord = swap;
+	}
+
 	glColor4ub(0xFF, 0xFF, 0xFF, 0xFF);
-	glTexCoord2f(xTextureCoord + horizontalBuffer, yTextureCoord + verticalBuffer);
+	glTexCoord2f(leftTextureCoord, yTextureCoord + verticalBuffer);
 	glVertex2f(xPositionLeft, yPositionBottom);
-	glTexCoord2f(xTextureCoord + (1.0f / mColumns) - horizontalBuffer, yTextureCoord + verticalBuffer);
+	glTexCoord2f(rightTextureCoord, yTextureCoord + verticalBuffer);
 	glVertex2f(xPositionRight, yPositionBottom);
-	glTexCoord2f(xTextureCoord + (1.0f / mColumns) - horizontalBuffer, yTextureCoord + (1.0f / mRows) - verticalBuffer);
+	glTexCoord2f(rightTextureCoord, yTextureCoord + (1.0f / mRows) - verticalBuffer);
 	glVertex2f(xPositionRight, yPositionTop);
-	glTexCoord2f(xTextureCoord + horizontalBuffer, yTextureCoord + (1.0f / mRows) - verticalBuffer);
+	glTexCoord2f(leftTextureCoord, yTextureCoord + (1.0f / mRows) - verticalBuffer);
 	glVertex2f(xPositionLeft, yPositionTop);
 
 	glEnd();
 }
 
+/*
+	Mirrors the horizontal extent of the hitbox about the center of the cell, to match a cell drawn mirrored.
+	The offset shifts the mirrored hitbox by the same number of pixels the mirrored cell is drawn shifted by.
+*/
+void SpriteC::mirrorHitBox(float offset)
+{
+	float start = mHitBoxStart.x;
+
+	mHitBoxStart.x = mWidth - mHitBoxEnd.x + offset;
+	mHitBoxEnd.x = mWidth - start + offset;
+}
+
+/*
+	Fills in where the opaque pixels of a cell are when it is drawn with its top left corner at the given pixel, in the same way render() places it.
+	The pixel is given in world pixels with y downward, the position render() is given rounded to whole pixels.
+	Returns false if the sprite sheet has no collision mask yet, the cell is empty,
+	or the sprite is drawn at another size than its cells, since masks are only compared pixel for pixel.
+*/
+bool SpriteC::getCollisionFrame(int left, int top, int column, int row, bool mirrored, CollisionFrame *frame)
+{
+	const CollisionMaskC *mask = TextureManagerC::GetInstance()->getCollisionMask(mSpriteMap);
+
+	if (mask == NULL)
+		return false;
+
+	int cellWidth = mask->getWidth() / mColumns;
+	int cellHeight = mask->getHeight() / mRows;
+	int offsetX = 0;
+	int offsetY = 0;
+
+	frame->mask = mask;
+	frame->mirrored = mirrored;
+
+	if (mAtlas.isLoaded())
+	{
+		const SpriteAtlasHeader *header = mAtlas.getHeader();
+		const SpriteFrame *atlasFrame = mAtlas.getFrame(column, row);
+
+		if (atlasFrame == NULL || atlasFrame->width == 0)
+			return false;
+
+		cellWidth = header->cellWidth;
+		cellHeight = header->cellHeight;
+		offsetX = mirrored ? cellWidth - atlasFrame->offsetX - atlasFrame->width : atlasFrame->offsetX;
+		offsetY = atlasFrame->offsetY;
+
+		frame->x = atlasFrame->x;
+		frame->y = atlasFrame->y;
+		frame->width = atlasFrame->width;
+		frame->height = atlasFrame->height;
+	}
+	else
+	{
+		frame->x = column * cellWidth;
+		frame->y = row * cellHeight;
+		frame->width = cellWidth;
+		frame->height = cellHeight;
+	}
+
+	if ((int)mWidth != cellWidth || (int)mHeight != cellHeight)
+		return false;
+
+	frame->left = left + offsetX;
+	frame->top = top + offsetY;
+
+	return true;
+}
+
 int SpriteC::getRows()
 {
 	return mRows;
 }
 
+/*
+	Returns the texture of the sprite sheet, or 0 while it is still loading.
+*/
 GLuint SpriteC::getSpriteMap()
 {
-	return mSpriteMap;
+	return TextureManagerC::GetInstance()->getTexture(mSpriteMap);
+}
+
+/* Private functions */
+/*
+	Draws a trimmed frame where its pixels sat within the full cell, mirroring its offset along with its texture coordinates.
+	Frames of empty cells are not drawn at all.
+*/
+void SpriteC::renderTrimmed(Coord2D position, const SpriteFrame *frame, bool mirrored)
+{
+	if (frame == NULL || frame->width == 0)
+		return;
+
+	const SpriteAtlasHeader *header = mAtlas.getHeader();
+
+	float horizontalScale = mWidth / header->cellWidth;
+	float verticalScale = mHeight / header->cellHeight;
+	float offsetX = mirrored ? (float)(header->cellWidth - frame->offsetX - frame->width) : (float)frame->offsetX;
+
+	GLfloat xPositionLeft = ((position.x + offsetX * horizontalScale) * horizontalRatio);
+	GLfloat xPositionRight = ((position.x + (offsetX + frame->width) * horizontalScale) * horizontalRatio);
+
+	GLfloat yPositionTop = ((position.y - frame->offsetY * verticalScale) * verticalRatio);
+	GLfloat yPositionBottom = ((position.y - (frame->offsetY + frame->height) * verticalScale) * verticalRatio);
+
+	GLfloat leftTextureCoord = (float)frame->x / header->width;
+	GLfloat rightTextureCoord = (float)(frame->x + frame->width) / header->width;
+	GLfloat topTextureCoord = 1.0f - (float)frame->y / header->height;
+	GLfloat bottomTextureCoord = 1.0f - (float)(frame->y + frame->height) / header->height;
+
+	if (mirrored)
+	{
+		GLfloat swap = leftTextureCoord;
+		leftTextureCoord = rightTextureCoord;
+		rightTextureCoord = swap;
+	}
+
+	glBegin(GL_QUADS);
+
+	glColor4ub(0xFF, 0xFF, 0xFF, 0xFF);
+	glTexCoord2f(leftTextureCoord, bottomTextureCoord);
+	glVertex2f(xPositionLeft, yPositionBottom);
+	glTexCoord2f(rightTextureCoord, bottomTextureCoord);
+	glVertex2f(xPositionRight, yPositionBottom);
+	glTexCoord2f(rightTextureCoord, topTextureCoord);
+	glVertex2f(xPositionRight, yPositionTop);
+	glTexCoord2f(leftTextureCoord, topTextureCoord);
+	glVertex2f(xPositionLeft, yPositionTop);
+
+	glEnd();
 }
\ No newline at end of file
@@ -4,6 +4,10 @@
 
 	This class is used to draw the contents of a given sprite sheet.
 	It is also used to specify the hitbox of the sprite so animations within the sprite sheet can be more accurately reflected.
+	Cells can be drawn mirrored horizontally, so a sprite sheet only needs to store one facing of each animation.
+	When the sprite sheet was trimmed into a SpriteAtlasC, each cell is drawn as its cropped frame at the frame's offset within the cell.
+	The sprite sheet is loaded in the background by the TextureManagerC singleton; the sprite draws nothing until it is resident.
+	When the sprite sheet was loaded with a collision mask, the sprite can place the mask of the cell it draws, for pixel accurate hits.
 */
 
 #include <windows.h>
@@ -12,15 +16,20 @@
 #include "Object.h"
 #include "baseTypes.h"
 #include "glut.h"
+#include "TextureManager.h"
+#include "SpriteAtlas.h"
 
 class SpriteC
 {
 public:
 	/* Public functions */
-	SpriteC(char *spriteMapFilePath, float height, float width, int rows, int columns);
+	SpriteC(char *spriteMapFilePath, float height, float width, int rows, int columns, TexturePriority::TexturePriority priority = TexturePriority::Screen);
 	~SpriteC();
 
-	void render(Coord2D position, float u, float v, bool useBuffer = true);
+	void render(Coord2D position, float u, float v, bool useBuffer = true, bool mirrored = false);
+	void mirrorHitBox(float offset);
+
+	bool getCollisionFrame(int left, int top, int column, int row, bool mirrored, CollisionFrame *frame);
 
 	int getRows();
 
@@ -32,8 +41,13 @@ public:
 	Coord2D mHitBoxStart, mHitBoxEnd;
 
 private:
+	/* Private functions */
+	void renderTrimmed(Coord2D position, const SpriteFrame *frame, bool mirrored);
+
 	/* Private data members */
-	GLuint mSpriteMap;
+	int mSpriteMap;
+
+	SpriteAtlasC mAtlas;
 
 	int mRows, mColumns;
 
@@ -0,0 +1,171 @@
+/*
+	SpriteAtlas.cpp
+
+	This file contains the implementation of the functions prototyped in the SpriteAtlasC class.
+*/
+
+#define _CRT_SECURE_NO_WARNINGS
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "SpriteAtlas.h"
+
+/*
+	Replaces the extension of a sprite sheet path, e.g. "SpriteSheets/Name.png" becomes "SpriteSheets/Name.atlas".
+*/
+void getSpriteAtlasPath(const char *sheetPath, const char *extension, char *destination)
+{
+	const char *dot = strrchr(sheetPath, '.');
+	int length = dot != NULL ? (int)(dot - sheetPath) : (int)strlen(sheetPath);
+	int extensionLength = (int)strlen(extension);
+
+	if (length + extensionLength >= ASSET_NAME_LENGTH)
+		length = ASSET_NAME_LENGTH - 1 - extensionLength;
+
+	memcpy(destination, sheetPath, length);
+	memcpy(destination + length, extension, extensionLength + 1);
+}
+
+/* Public functions */
+SpriteAtlasC::SpriteAtlasC()
+{
+	mOwnsData = false;
+	mSize = 0;
+	mData = NULL;
+	mTexturePath[0] = 0;
+}
+
+SpriteAtlasC::~SpriteAtlasC()
+{
+	unload();
+}
+
+/*
+	Loads the frame table trimmed from the given sprite sheet, out of the asset package when it is packaged, otherwise from the loose file.
+	Returns false if the sheet was never trimmed, in which case getTexturePath() returns the untrimmed sheet.
+*/
+bool SpriteAtlasC::load(const char *sheetPath)
+{
+	char atlasPath[ASSET_NAME_LENGTH];
+	AssetPackageC *package = AssetPackageC::GetInstance();
+	const unsigned char *packagedData = NULL;
+
+	unload();
+
+	strncpy(mTexturePath, sheetPath, ASSET_NAME_LENGTH - 1);
+	mTexturePath[ASSET_NAME_LENGTH - 1] = 0;
+
+	getSpriteAtlasPath(sheetPath, ".atlas", atlasPath);
+
+	if (package != NULL)
+		packagedData = package->getAssetData(atlasPath, &mSize);
+
+	if (packagedData != NULL)
+	{
+		mData = (unsigned char *)packagedData;
+		mOwnsData = false;
+	}
+	else
+	{
+		FILE *file = fopen(atlasPath, "rb");
+
+		if (file == NULL)
+			return false;
+
+		fseek(file, 0, SEEK_END);
+		mSize = ftell(file);
+		fseek(file, 0, SEEK_SET);
+
+		mData = (unsigned char *)malloc(mSize);
+		mOwnsData = true;
+
+		bool valid = mData != NULL && (int)fread(mData, 1, mSize, file) == mSize;
+
+		fclose(file);
+
+		if (!valid)
+		{
+			unload();
+			return false;
+		}
+	}
+
+	if (!validate())
+	{
+		unload();
+		return false;
+	}
+
+	getSpriteAtlasPath(sheetPath, ".tga", mTexturePath);
+
+	return true;
+}
+
+void SpriteAtlasC::unload()
+{
+	if (mOwnsData)
+		free(mData);
+
+	mOwnsData = false;
+	mSize = 0;
+	mData = NULL;
+}
+
+bool SpriteAtlasC::isLoaded()
+{
+	return mData != NULL;
+}
+
+/*
+	Returns the path of the texture to draw with: the atlas texture when the sheet was trimmed, otherwise the sheet itself.
+*/
+const char* SpriteAtlasC::getTexturePath()
+{
+	return mTexturePath;
+}
+
+const SpriteAtlasHeader* SpriteAtlasC::getHeader()
+{
+	return (const SpriteAtlasHeader *)mData;
+}
+
+/*
+	Returns the frame trimmed from the cell at the given column and row, or NULL if it is outside the sheet.
+*/
+const SpriteFrame* SpriteAtlasC::getFrame(int column, int row)
+{
+	const SpriteAtlasHeader *header = getHeader();
+
+	if (header == NULL || column < 0 || row < 0 || column >= header->columns || row >= header->rows)
+		return NULL;
+
+	return (const SpriteFrame *)(mData + sizeof(SpriteAtlasHeader)) + row * header->columns + column;
+}
+
+/* Private functions */
+/*
+	Checks the header and that the frame table and every frame lie inside the file and the atlas.
+*/
+bool SpriteAtlasC::validate()
+{
+	if (mSize < (int)sizeof(SpriteAtlasHeader))
+		return false;
+
+	const SpriteAtlasHeader *header = getHeader();
+	int frameCount = header->columns * header->rows;
+
+	if (header->magic != SPRITE_ATLAS_MAGIC || header->version != SPRITE_ATLAS_VERSION ||
+		sizeof(SpriteAtlasHeader) + frameCount * sizeof(SpriteFrame) > (unsigned int)mSize)
+		return false;
+
+	const SpriteFrame *frames = (const SpriteFrame *)(mData + sizeof(SpriteAtlasHeader));
+
+	for (int i = 0; i < frameCount; i++)
+	{
+		if (frames[i].x + frames[i].width > header->width || frames[i].y + frames[i].height > header->height)
+			return false;
+	}
+
+	return true;
+}
\ No newline at end of file
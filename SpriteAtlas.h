@@ -0,0 +1,75 @@
+#pragma once
+/*
+	SpriteAtlas.h
+
+	A sprite atlas holds the cells of a sprite sheet cropped to their opaque bounds and packed tightly into one texture.
+	It is written by the trim command of the AssetBuilder tool next to the sheet it was built from:
+	"SpriteSheets/Name.png" is trimmed into the texture "SpriteSheets/Name.tga" and the frame table "SpriteSheets/Name.atlas".
+	Each frame records where its cropped pixels sit in the atlas texture and where they sat in the original cell,
+	so a trimmed frame is drawn at exactly the position the full cell would have been.
+*/
+
+#include "AssetPackage.h"
+
+#define SPRITE_ATLAS_MAGIC 0x534C5441
+#define SPRITE_ATLAS_VERSION 1
+
+struct SpriteAtlasHeader
+{
+	unsigned int magic;
+	unsigned int version;
+
+	unsigned short columns;
+	unsigned short rows;
+	unsigned short cellWidth;
+	unsigned short cellHeight;
+	unsigned short width;
+	unsigned short height;
+};
+
+/*
+	A frame of the atlas, stored row by row after the header. Positions are in pixels from the top left.
+	The offset is where the frame's top left corner sits within its cell and may be negative by the one pixel transparent border.
+	Frames of empty cells have no width or height.
+*/
+struct SpriteFrame
+{
+	unsigned short x;
+	unsigned short y;
+	unsigned short width;
+	unsigned short height;
+
+	short offsetX;
+	short offsetY;
+};
+
+void getSpriteAtlasPath(const char *sheetPath, const char *extension, char *destination);
+
+class SpriteAtlasC
+{
+public:
+	/* Public functions */
+	SpriteAtlasC();
+	~SpriteAtlasC();
+
+	bool load(const char *sheetPath);
+	void unload();
+	bool isLoaded();
+
+	const char *getTexturePath();
+	const SpriteAtlasHeader *getHeader();
+	const SpriteFrame *getFrame(int column, int row);
+
+private:
+	/* Private functions */
+	bool validate();
+
+	/* Private data members */
+	bool mOwnsData;
+
+	int mSize;
+
+	unsigned char *mData;
+
+	char mTexturePath[ASSET_NAME_LENGTH];
+};
\ No newline at end of file
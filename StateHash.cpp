@@ -0,0 +1,83 @@
+/*
+	StateHash.cpp
+
+	This file contains the implementation for the hash prototyped in StateHash.h and its benchmark.
+*/
+
+#include <stdio.h>
+#include <string.h>
+#include "StateHash.h"
+#include "Benchmark.h"
+
+#define BENCHMARK_STATE_BYTES 768
+#define BENCHMARK_STATE_HASHES 1000000
+
+static const unsigned long long prime1 = 0x9e3779b185ebca87ull;
+static const unsigned long long prime2 = 0xc2b2ae3d27d4eb4full;
+static const unsigned long long prime3 = 0x165667b19e3779f9ull;
+static const unsigned long long prime4 = 0x85ebca77c2b2ae63ull;
+static const unsigned long long prime5 = 0x27d4eb2f165667c5ull;
+
+static inline unsigned long long rotateLeft(unsigned long long value, int bits)
+{
+	return (value << bits) | (value >> (64 - bits));
+}
+
+/*
+	Hashes the bytes one 64-bit word at a time, then the bytes left over, and mixes the result so every input bit affects every output bit.
+*/
+unsigned long long hashState(const void *data, int bytes, unsigned long long seed)
+{
+	const unsigned char *input = (const unsigned char *)data;
+	unsigned long long hash = seed + prime5 + (unsigned long long)bytes;
+	int i = 0;
+
+	for (; i + 8 <= bytes; i += 8)
+	{
+		unsigned long long word;
+
+		memcpy(&word, input + i, sizeof(word));
+
+		hash ^= rotateLeft(word * prime2, 31) * prime1;
+		hash = rotateLeft(hash, 27) * prime1 + prime4;
+	}
+
+	for (; i < bytes; i++)
+	{
+		hash ^= input[i] * prime5;
+		hash = rotateLeft(hash, 11) * prime1;
+	}
+
+	hash ^= hash >> 33;
+	hash *= prime2;
+	hash ^= hash >> 29;
+	hash *= prime3;
+	hash ^= hash >> 32;
+
+	return hash;
+}
+
+/*
+	Times hashing a state the size of a four player match, the cost the simulation pays every tick.
+*/
+void benchmarkStateHash()
+{
+	static unsigned char state[BENCHMARK_STATE_BYTES];
+	unsigned long long hash = 0;
+
+	for (int i = 0; i < BENCHMARK_STATE_BYTES; i++)
+		state[i] = (unsigned char)(i * 37);
+
+	double start = getBenchmarkSeconds();
+
+	for (int i = 0; i < BENCHMARK_STATE_HASHES; i++)
+	{
+		state[i % BENCHMARK_STATE_BYTES]++;
+		hash ^= hashState(state, BENCHMARK_STATE_BYTES);
+	}
+
+	double seconds = getBenchmarkSeconds() - start;
+
+	printf("  %d byte state: %5.1f ns per hash, %.2f GB/s (checksum %016llx)\n", BENCHMARK_STATE_BYTES, seconds * 1e9 / BENCHMARK_STATE_HASHES,
+		(double)BENCHMARK_STATE_BYTES * BENCHMARK_STATE_HASHES / seconds / 1e9, hash);
+}
\ No newline at end of file
@@ -0,0 +1,565 @@
+/*
+	TextureManager.cpp
+
+	This file contains the implementation for functions prototyped in the TextureManager.h singleton class: TextureManagerC.
+*/
+
+#define _CRT_SECURE_NO_WARNINGS
+
+#include <stdio.h>
+#include <string.h>
+#include "TextureManager.h"
+
+TextureManagerC* TextureManagerC::sInstance = NULL;
+
+/* Public functions */
+TextureManagerC* TextureManagerC::CreateInstance()
+{
+	if (sInstance == NULL)
+		sInstance = new TextureManagerC();
+
+	return sInstance;
+}
+
+/*
+	Starts one decode worker per core, leaving a core for the main thread.
+*/
+void TextureManagerC::init()
+{
+	SYSTEM_INFO systemInfo;
+
+	GetSystemInfo(&systemInfo);
+
+	mWorkerCount = (int)systemInfo.dwNumberOfProcessors - 1;
+	mWorkerCount = mWorkerCount < 1 ? 1 : mWorkerCount;
+	mWorkerCount = mWorkerCount > MAX_TEXTURE_WORKERS ? MAX_TEXTURE_WORKERS : mWorkerCount;
+
+	for (int i = 0; i < MAX_TEXTURES; i++)
+	{
+		mSlots[i].state = TextureState::Unused;
+		mSlots[i].references = 0;
+		mSlots[i].wantsCollisionMask = false;
+		mSlots[i].bytes = 0;
+		mSlots[i].pixels = NULL;
+		mSlots[i].texture = 0;
+		mSlots[i].collisionMask = NULL;
+	}
+
+	mLoading = false;
+	mUploadCount = 0;
+	mResidentBytes = 0;
+	mStartTime = 0.0;
+
+	InitializeCriticalSection(&mLock);
+
+	mWorkAvailable = CreateSemaphore(NULL, 0, MAX_TEXTURES + MAX_TEXTURE_WORKERS, NULL);
+	mRunning.store(true);
+
+	for (int i = 0; i < mWorkerCount; i++)
+		mWorkers[i] = CreateThread(NULL, 0, workerThreadProc, this, 0, NULL);
+}
+
+/*
+	Uploads decoded textures to OpenGL, most urgent first, until the frame's upload budget is spent.
+	At least one texture is uploaded per call so a large one can never stall the queue.
+	Reports how long each batch of loads took once the queue drains.
+	Must be called from the thread that owns the GL context.
+*/
+void TextureManagerC::update()
+{
+	double start = getSeconds();
+
+	do
+	{
+		int handle = takeNext(TextureState::Decoded, TextureState::Decoded);
+
+		if (handle == INVALID_TEXTURE)
+			break;
+
+		if (mSlots[handle].references > 0)
+		{
+			upload(&mSlots[handle]);
+		}
+		else
+		{
+			EnterCriticalSection(&mLock);
+			freeSlot(&mSlots[handle]);
+			LeaveCriticalSection(&mLock);
+		}
+	} while (getSeconds() - start < uploadBudgetSeconds);
+
+	if (mLoading && isIdle())
+	{
+		if (mUploadCount > 0)
+			printf("Loaded %d textures in %.1f ms using %d decode threads, %d KB resident\n", mUploadCount, (getSeconds() - mStartTime) * 1000.0, mWorkerCount, mResidentBytes / 1024);
+
+		mLoading = false;
+	}
+}
+
+/*
+	Stops the workers and releases every texture. Must be called while the GL context still exists.
+*/
+void TextureManagerC::shutdown()
+{
+	mRunning.store(false);
+	ReleaseSemaphore(mWorkAvailable, mWorkerCount, NULL);
+
+	WaitForMultipleObjects(mWorkerCount, mWorkers, TRUE, INFINITE);
+
+	for (int i = 0; i < mWorkerCount; i++)
+		CloseHandle(mWorkers[i]);
+
+	for (int i = 0; i < MAX_TEXTURES; i++)
+	{
+		if (mSlots[i].state != TextureState::Unused)
+			freeSlot(&mSlots[i]);
+	}
+
+	CloseHandle(mWorkAvailable);
+	DeleteCriticalSection(&mLock);
+}
+
+/*
+	Adds a reference to the texture at the given path and returns its handle, queueing it for loading if it is not cached.
+	A path that is already loaded or loading returns the existing handle, raising its priority if it is needed sooner.
+	If the collisionMask flag is set and the texture has not been decoded yet, a collision mask is built when it is.
+	Returns INVALID_TEXTURE if every slot is in use.
+*/
+int TextureManagerC::acquire(const char *path, TexturePriority::TexturePriority priority, bool collisionMask)
+{
+	int handle = INVALID_TEXTURE;
+	int freeSlot = INVALID_TEXTURE;
+
+	EnterCriticalSection(&mLock);
+
+	for (int i = 0; i < MAX_TEXTURES && handle == INVALID_TEXTURE; i++)
+	{
+		TextureSlot *slot = &mSlots[i];
+
+		if (slot->state == TextureState::Unused)
+		{
+			if (freeSlot == INVALID_TEXTURE)
+				freeSlot = i;
+		}
+		else if (assetNamesMatch(slot->path, path))
+		{
+			if (priority > slot->priority)
+				slot->priority = priority;
+
+			if (collisionMask)
+				slot->wantsCollisionMask = true;
+
+			slot->references++;
+			handle = i;
+		}
+	}
+
+	if (handle == INVALID_TEXTURE && freeSlot != INVALID_TEXTURE)
+	{
+		TextureSlot *slot = &mSlots[freeSlot];
+
+		strncpy(slot->path, path, ASSET_NAME_LENGTH - 1);
+		slot->path[ASSET_NAME_LENGTH - 1] = 0;
+		slot->priority = priority;
+		slot->references = 1;
+		slot->wantsCollisionMask = collisionMask;
+		slot->bytes = 0;
+		slot->pixels = NULL;
+		slot->texture = 0;
+		slot->collisionMask = NULL;
+		slot->state = TextureState::Queued;
+
+		handle = freeSlot;
+
+		if (!mLoading)
+		{
+			mLoading = true;
+			mUploadCount = 0;
+			mStartTime = getSeconds();
+		}
+
+		ReleaseSemaphore(mWorkAvailable, 1, NULL);
+	}
+
+	LeaveCriticalSection(&mLock);
+
+	return handle;
+}
+
+/*
+	Drops a reference to a texture. Releasing the last reference deletes the GL texture,
+	or discards the load when it is still in flight. Must be called from the thread that owns the GL context.
+*/
+void TextureManagerC::release(int handle)
+{
+	if (handle < 0 || handle >= MAX_TEXTURES)
+		return;
+
+	TextureSlot *slot = &mSlots[handle];
+
+	EnterCriticalSection(&mLock);
+
+	if (slot->references > 0 && --slot->references == 0)
+	{
+		if (slot->state == TextureState::Queued || slot->state == TextureState::Resident || slot->state == TextureState::Failed)
+			freeSlot(slot);
+	}
+
+	LeaveCriticalSection(&mLock);
+}
+
+/*
+	Returns the GL texture of a handle, or 0 while it is still loading.
+*/
+GLuint TextureManagerC::getTexture(int handle)
+{
+	if (handle < 0 || handle >= MAX_TEXTURES)
+		return 0;
+
+	return mSlots[handle].texture;
+}
+
+/*
+	Returns the collision mask of a handle, or NULL if it was not asked for or the texture is not resident yet.
+*/
+const CollisionMaskC* TextureManagerC::getCollisionMask(int handle)
+{
+	if (handle < 0 || handle >= MAX_TEXTURES || mSlots[handle].texture == 0)
+		return NULL;
+
+	return mSlots[handle].collisionMask;
+}
+
+bool TextureManagerC::isResident(int handle)
+{
+	return getTexture(handle) != 0;
+}
+
+/*
+	Returns true while a texture is queued, decoding or waiting to be uploaded.
+*/
+bool TextureManagerC::isLoading(int handle)
+{
+	if (handle < 0 || handle >= MAX_TEXTURES)
+		return false;
+
+	EnterCriticalSection(&mLock);
+	TextureState::TextureState state = mSlots[handle].state;
+	LeaveCriticalSection(&mLock);
+
+	return state == TextureState::Queued || state == TextureState::Decoding || state == TextureState::Decoded;
+}
+
+/*
+	Returns the video memory used by every resident texture, including its mipmaps.
+*/
+int TextureManagerC::getResidentBytes()
+{
+	return mResidentBytes;
+}
+
+/*
+	Returns true once every requested texture has been uploaded or has failed to load.
+*/
+bool TextureManagerC::isIdle()
+{
+	bool idle = true;
+
+	EnterCriticalSection(&mLock);
+
+	for (int i = 0; i < MAX_TEXTURES && idle; i++)
+	{
+		TextureState::TextureState state = mSlots[i].state;
+
+		idle = state == TextureState::Unused || state == TextureState::Resident || state == TextureState::Failed;
+	}
+
+	LeaveCriticalSection(&mLock);
+
+	return idle;
+}
+
+/* Private functions */
+DWORD WINAPI TextureManagerC::workerThreadProc(LPVOID parameter)
+{
+	((TextureManagerC *)parameter)->runWorker();
+
+	return 0;
+}
+
+/*
+	Decodes queued textures, most urgent first, one per request released on the semaphore.
+*/
+void TextureManagerC::runWorker()
+{
+	while (true)
+	{
+		WaitForSingleObject(mWorkAvailable, INFINITE);
+
+		if (!mRunning.load())
+			break;
+
+		int handle = takeNext(TextureState::Queued, TextureState::Decoding);
+
+		if (handle == INVALID_TEXTURE)
+			continue;
+
+		TextureSlot *slot = &mSlots[handle];
+
+		decode(slot);
+
+		EnterCriticalSection(&mLock);
+
+		if (slot->references == 0)
+			freeSlot(slot);
+		else
+			slot->state = slot->pixels != NULL ? TextureState::Decoded : TextureState::Failed;
+
+		LeaveCriticalSection(&mLock);
+	}
+}
+
+/*
+	Decodes the image into pixels, straight out of the asset package mapping when it is packaged,
+	and builds its collision mask from them if one was asked for.
+*/
+void TextureManagerC::decode(TextureSlot *slot)
+{
+	AssetPackageC *package = AssetPackageC::GetInstance();
+	int size = 0;
+	const unsigned char *data = package != NULL ? package->getAssetData(slot->path, &size) : NULL;
+
+	if (data != NULL)
+		slot->pixels = SOIL_load_image_from_memory(data, size, &slot->width, &slot->height, &slot->channels, SOIL_LOAD_AUTO);
+	else
+		slot->pixels = SOIL_load_image(slot->path, &slot->width, &slot->height, &slot->channels, SOIL_LOAD_AUTO);
+
+	EnterCriticalSection(&mLock);
+	bool wantsCollisionMask = slot->wantsCollisionMask;
+	LeaveCriticalSection(&mLock);
+
+	if (slot->pixels != NULL && wantsCollisionMask)
+	{
+		slot->collisionMask = new CollisionMaskC();
+
+		if (!slot->collisionMask->build(slot->pixels, slot->width, slot->height, slot->channels))
+		{
+			delete slot->collisionMask;
+			slot->collisionMask = NULL;
+		}
+	}
+}
+
+/*
+	Creates the GL texture from the decoded pixels and frees them.
+*/
+void TextureManagerC::upload(TextureSlot *slot)
+{
+	slot->texture = SOIL_create_OGL_texture(slot->pixels, slot->width, slot->height, slot->channels, SOIL_CREATE_NEW_ID, textureFlags);
+
+	SOIL_free_image_data(slot->pixels);
+	slot->pixels = NULL;
+
+	if (slot->texture != 0)
+		slot->bytes = getTextureBytes(slot);
+
+	EnterCriticalSection(&mLock);
+	slot->state = slot->texture != 0 ? TextureState::Resident : TextureState::Failed;
+	mResidentBytes += slot->bytes;
+	LeaveCriticalSection(&mLock);
+
+	mUploadCount++;
+}
+
+/*
+	Frees the pixels and texture of a slot and returns it to the pool. Must be called with the lock held.
+	Only the main thread ever frees a slot that has a GL texture.
+*/
+void TextureManagerC::freeSlot(TextureSlot *slot)
+{
+	if (slot->pixels != NULL)
+		SOIL_free_image_data(slot->pixels);
+
+	if (slot->texture != 0)
+		glDeleteTextures(1, &slot->texture);
+
+	delete slot->collisionMask;
+
+	mResidentBytes -= slot->bytes;
+
+	slot->state = TextureState::Unused;
+	slot->references = 0;
+	slot->wantsCollisionMask = false;
+	slot->bytes = 0;
+	slot->pixels = NULL;
+	slot->texture = 0;
+	slot->collisionMask = NULL;
+}
+
+/*
+	Measures the video memory of a texture by summing its mipmap levels, using the driver's size for DXT compressed levels.
+*/
+int TextureManagerC::getTextureBytes(TextureSlot *slot)
+{
+	int bytes = 0;
+
+	glBindTexture(GL_TEXTURE_2D, slot->texture);
+
+	for (int level = 0; ; level++)
+	{
+		GLint width = 0;
+		GLint height = 0;
+		GLint compressed = 0;
+		GLint compressedSize = 0;
+
+		glGetTexLevelParameteriv(GL_TEXTURE_2D, level, GL_TEXTURE_WIDTH, &width);
+		glGetTexLevelParameteriv(GL_TEXTURE_2D, level, GL_TEXTURE_HEIGHT, &height);
+
+		if (width == 0 || height == 0)
+			break;
+
+		glGetTexLevelParameteriv(GL_TEXTURE_2D, level, GL_TEXTURE_COMPRESSED, &compressed);
+
+		if (compressed)
+			glGetTexLevelParameteriv(GL_TEXTURE_2D, level, GL_TEXTURE_COMPRESSED_IMAGE_SIZE, &compressedSize);
+
+		bytes += compressed ? compressedSize : width * height * slot->channels;
+
+		if (width == 1 && height == 1)
+			break;
+	}
+
+	return bytes;
+}
+
+/*
+	Finds the most urgent slot in the given state and moves it to the next state, returning its handle.
+	Ties go to the earliest request.
+*/
+int TextureManagerC::takeNext(TextureState::TextureState state, TextureState::TextureState nextState)
+{
+	int handle = INVALID_TEXTURE;
+
+	EnterCriticalSection(&mLock);
+
+	for (int i = 0; i < MAX_TEXTURES; i++)
+	{
+		if (mSlots[i].state == state && (handle == INVALID_TEXTURE || mSlots[i].priority > mSlots[handle].priority))
+			handle = i;
+	}
+
+	if (handle != INVALID_TEXTURE)
+		mSlots[handle].state = nextState;
+
+	LeaveCriticalSection(&mLock);
+
+	return handle;
+}
+
+double TextureManagerC::getSeconds()
+{
+	LARGE_INTEGER frequency;
+	LARGE_INTEGER counter;
+
+	QueryPerformanceFrequency(&frequency);
+	QueryPerformanceCounter(&counter);
+
+	return (double)counter.QuadPart / (double)frequency.QuadPart;
+}
+
+TextureScopeC::TextureScopeC()
+{
+	mAcquired = false;
+	mCount = 0;
+}
+
+TextureScopeC::~TextureScopeC()
+{
+	release();
+}
+
+/*
+	Adds the texture at the given path to the scope and returns its index within the scope.
+	Textures added while the scope is acquired are acquired immediately.
+	The collisionMask flag asks for a collision mask to be built when the texture is decoded.
+*/
+int TextureScopeC::add(const char *path, bool collisionMask)
+{
+	if (mCount >= MAX_SCOPE_TEXTURES)
+		return INVALID_TEXTURE;
+
+	strncpy(mPaths[mCount], path, ASSET_NAME_LENGTH - 1);
+	mPaths[mCount][ASSET_NAME_LENGTH - 1] = 0;
+	mCollisionMasks[mCount] = collisionMask;
+	mHandles[mCount] = mAcquired ? TextureManagerC::GetInstance()->acquire(path, TexturePriority::Screen, collisionMask) : INVALID_TEXTURE;
+
+	return mCount++;
+}
+
+/*
+	Acquires every texture in the scope. When the scope is already acquired, each texture is acquired again
+	at the new priority before its previous reference is released, so nothing is evicted in between.
+*/
+void TextureScopeC::acquire(TexturePriority::TexturePriority priority)
+{
+	TextureManagerC *textureManager = TextureManagerC::GetInstance();
+
+	for (int i = 0; i < mCount; i++)
+	{
+		int previousHandle = mHandles[i];
+
+		mHandles[i] = textureManager->acquire(mPaths[i], priority, mCollisionMasks[i]);
+
+		if (mAcquired)
+			textureManager->release(previousHandle);
+	}
+
+	mAcquired = true;
+}
+
+/*
+	Releases every texture in the scope, evicting those no other scope or sprite still references.
+*/
+void TextureScopeC::release()
+{
+	if (!mAcquired)
+		return;
+
+	for (int i = 0; i < mCount; i++)
+	{
+		TextureManagerC::GetInstance()->release(mHandles[i]);
+		mHandles[i] = INVALID_TEXTURE;
+	}
+
+	mAcquired = false;
+}
+
+GLuint TextureScopeC::getTexture(int index)
+{
+	return mAcquired && index >= 0 && index < mCount ? TextureManagerC::GetInstance()->getTexture(mHandles[index]) : 0;
+}
+
+bool TextureScopeC::isAcquired()
+{
+	return mAcquired;
+}
+
+bool TextureScopeC::isResident(int index)
+{
+	return getTexture(index) != 0;
+}
+
+/*
+	Returns true once every texture in the scope has finished loading, whether or not it loaded successfully.
+*/
+bool TextureScopeC::isLoaded()
+{
+	for (int i = 0; i < mCount; i++)
+	{
+		if (!mAcquired || TextureManagerC::GetInstance()->isLoading(mHandles[i]))
+			return false;
+	}
+
+	return true;
+}
\ No newline at end of file
@@ -0,0 +1,174 @@
+#pragma once
+/*
+	TextureManager.h
+
+	This is a singleton class that loads every texture of the game in the background.
+	Each load is a small graph of two tasks: decoding the image, which runs on a pool of worker threads,
+	and uploading it to OpenGL, which depends on the decode and runs on the main thread in update().
+	Loads are picked highest priority first, so the textures of the first screen are shown while the rest are still decoding.
+	Textures are cached by asset path: acquiring a path that is already loaded or loading returns the same handle and adds a reference.
+	Callers hold the handle, resolve it to a GL texture each time they draw, skipping the draw until it is resident,
+	and release it when they are done. The GL texture is deleted when the last reference is released.
+	TextureScopeC groups the textures that are used together, so a screen can acquire and release them as one.
+	A texture can also ask for a CollisionMaskC of its alpha, built by the worker that decodes it and kept until the texture is freed.
+	The pixels are gone once the texture is uploaded, so the mask must be asked for by an acquire made before then.
+*/
+
+#include <windows.h>
+#include <atomic>
+#include "glut.h"
+#include "SOIL.h"
+#include "AssetPackage.h"
+#include "CollisionMask.h"
+
+#define MAX_TEXTURES 64
+#define MAX_TEXTURE_WORKERS 4
+#define MAX_SCOPE_TEXTURES 16
+#define INVALID_TEXTURE -1
+
+#ifndef GL_TEXTURE_COMPRESSED_IMAGE_SIZE
+#define GL_TEXTURE_COMPRESSED_IMAGE_SIZE 0x86A0
+#define GL_TEXTURE_COMPRESSED 0x86A1
+#endif
+
+/*
+	Enumeration used to represent how far along its load a texture is.
+*/
+namespace TextureState
+{
+	enum TextureState { Unused, Queued, Decoding, Decoded, Resident, Failed };
+}
+
+/*
+	Enumeration used to represent how urgently a texture is needed, in increasing order.
+*/
+namespace TexturePriority
+{
+	enum TexturePriority { Prefetch, Screen, FirstFrame };
+}
+
+struct TextureSlot
+{
+	TextureState::TextureState state;
+	TexturePriority::TexturePriority priority;
+
+	char path[ASSET_NAME_LENGTH];
+
+	int references;
+
+	bool wantsCollisionMask;
+
+	unsigned char *pixels;
+
+	int width;
+	int height;
+	int channels;
+	int bytes;
+
+	GLuint texture;
+
+	CollisionMaskC *collisionMask;
+};
+
+class TextureManagerC
+{
+public:
+	/* Public functions */
+	static TextureManagerC *CreateInstance();
+	static TextureManagerC *GetInstance() { return sInstance; };
+	~TextureManagerC() {};
+
+	void init();
+	void update();
+	void shutdown();
+
+	int acquire(const char *path, TexturePriority::TexturePriority priority, bool collisionMask = false);
+	void release(int handle);
+
+	GLuint getTexture(int handle);
+
+	const CollisionMaskC *getCollisionMask(int handle);
+
+	int getResidentBytes();
+
+	bool isResident(int handle);
+	bool isLoading(int handle);
+	bool isIdle();
+
+private:
+	/* Private functions */
+	TextureManagerC() {};
+
+	static DWORD WINAPI workerThreadProc(LPVOID parameter);
+
+	void runWorker();
+	void decode(TextureSlot *slot);
+	void upload(TextureSlot *slot);
+	void freeSlot(TextureSlot *slot);
+
+	int getTextureBytes(TextureSlot *slot);
+
+	int takeNext(TextureState::TextureState state, TextureState::TextureState nextState);
+
+	double getSeconds();
+
+	/* Private data members */
+	static TextureManagerC *sInstance;
+
+	std::atomic<bool> mRunning;
+
+	bool mLoading;
+
+	int mWorkerCount;
+	int mUploadCount;
+	int mResidentBytes;
+
+	double mStartTime;
+
+	TextureSlot mSlots[MAX_TEXTURES];
+
+	CRITICAL_SECTION mLock;
+
+	HANDLE mWorkAvailable;
+	HANDLE mWorkers[MAX_TEXTURE_WORKERS];
+
+	/* Private constant data */
+	const double uploadBudgetSeconds = 0.008;
+	const unsigned int textureFlags = SOIL_FLAG_MIPMAPS | SOIL_FLAG_INVERT_Y | SOIL_FLAG_NTSC_SAFE_RGB | SOIL_FLAG_COMPRESS_TO_DXT;
+};
+
+/*
+	A named set of textures that are resident together, such as everything the menus or a match draw.
+	Textures are added once by path, then the whole scope is acquired when it is about to be needed and released when it no longer is.
+	Acquiring at Prefetch priority loads the scope in the background ahead of time;
+	acquiring again at a higher priority raises the priority of the loads still in flight.
+*/
+class TextureScopeC
+{
+public:
+	/* Public functions */
+	TextureScopeC();
+	~TextureScopeC();
+
+	int add(const char *path, bool collisionMask = false);
+
+	void acquire(TexturePriority::TexturePriority priority);
+	void release();
+
+	GLuint getTexture(int index);
+
+	bool isAcquired();
+	bool isResident(int index);
+	bool isLoaded();
+
+private:
+	/* Private data members */
+	bool mAcquired;
+
+	int mCount;
+	int mHandles[MAX_SCOPE_TEXTURES];
+
+	bool mCollisionMasks[MAX_SCOPE_TEXTURES];
+
+	char mPaths[MAX_SCOPE_TEXTURES][ASSET_NAME_LENGTH];
+};
\ No newline at end of file
@@ -0,0 +1,118 @@
+/*
+	AssetBuilder.cpp
+
+	Entry point of the asset builder. Dispatches to the command named by the first argument.
+*/
+
+#define _CRT_SECURE_NO_WARNINGS
+
+#include <windows.h>
+#include <stdio.h>
+#include <string.h>
+#include "AssetBuilder.h"
+
+struct AssetCommand
+{
+	const char *name;
+	const char *usage;
+	int (*run)(int argc, char **argv);
+};
+
+static const AssetCommand commands[] =
+{
+	{ "bank", "bank <game directory> <output bank>", buildAudioBank },
+	{ "trim", "trim <sprite sheet> <columns> <rows>", trimSpriteSheet },
+	{ "pack", "pack <game directory> <output package>", buildAssetPackage },
+	{ "resampletest", "resampletest [<input rate> <output rate>]", testResampler }
+};
+
+static const int commandCount = sizeof(commands) / sizeof(commands[0]);
+
+int main(int argc, char **argv)
+{
+	if (argc >= 2)
+	{
+		for (int i = 0; i < commandCount; i++)
+		{
+			if (!strcmp(argv[1], commands[i].name))
+				return commands[i].run(argc - 2, argv + 2);
+		}
+	}
+
+	printf("usage:\n");
+
+	for (int i = 0; i < commandCount; i++)
+		printf("  AssetBuilder %s\n", commands[i].usage);
+
+	return 1;
+}
+
+/*
+	Recursively collects the files under directory with the given extension.
+	Paths are returned relative to directory with forward slashes.
+*/
+static void findFilesIn(const std::string &root, const std::string &relative, const std::string &extension, std::vector<std::string> &relativePaths)
+{
+	WIN32_FIND_DATA findData;
+	std::string pattern = root + "/" + relative + "*";
+	HANDLE find = FindFirstFile(pattern.c_str(), &findData);
+
+	if (find == INVALID_HANDLE_VALUE)
+		return;
+
+	do
+	{
+		std::string name = findData.cFileName;
+
+		if (name == "." || name == "..")
+			continue;
+
+		if (findData.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY)
+		{
+			findFilesIn(root, relative + name + "/", extension, relativePaths);
+		}
+		else if (name.size() > extension.size() && !_stricmp(name.c_str() + name.size() - extension.size(), extension.c_str()))
+		{
+			relativePaths.push_back(relative + name);
+		}
+	} while (FindNextFile(find, &findData));
+
+	FindClose(find);
+}
+
+void findFiles(const std::string &directory, const std::string &extension, std::vector<std::string> &relativePaths)
+{
+	findFilesIn(directory, "", extension, relativePaths);
+}
+
+bool readFile(const std::string &path, std::vector<unsigned char> &data)
+{
+	FILE *file = fopen(path.c_str(), "rb");
+
+	if (file == NULL)
+		return false;
+
+	fseek(file, 0, SEEK_END);
+	data.resize(ftell(file));
+	fseek(file, 0, SEEK_SET);
+
+	bool read = data.empty() || fread(&data[0], 1, data.size(), file) == data.size();
+
+	fclose(file);
+
+	return read;
+}
+
+bool writeFile(const std::string &path, const std::vector<unsigned char> &data)
+{
+	FILE *file = fopen(path.c_str(), "wb");
+
+	if (file == NULL)
+		return false;
+
+	bool written = data.empty() || fwrite(&data[0], 1, data.size(), file) == data.size();
+
+	fclose(file);
+
+	return written;
+}
\ No newline at end of file
@@ -0,0 +1,19 @@
+#pragma once
+/*
+	AssetBuilder.h
+
+	Offline tool that converts the loose game assets into the formats loaded at runtime.
+	Each command is implemented in its own file and registered in AssetBuilder.cpp.
+*/
+
+#include <string>
+#include <vector>
+
+void findFiles(const std::string &directory, const std::string &extension, std::vector<std::string> &relativePaths);
+bool readFile(const std::string &path, std::vector<unsigned char> &data);
+bool writeFile(const std::string &path, const std::vector<unsigned char> &data);
+
+int buildAudioBank(int argc, char **argv);
+int trimSpriteSheet(int argc, char **argv);
+int buildAssetPackage(int argc, char **argv);
+int testResampler(int argc, char **argv);
\ No newline at end of file
@@ -0,0 +1,131 @@
+/*
+	AudioBankBuilder.cpp
+
+	The bank command of the asset builder.
+	Converts every wave file under the game's Sounds directory to the bank's sample rate, encodes it to IMA ADPCM
+	and writes them all to a single AudioBankC file.
+	The Final Destination music is left out because MusicStreamC streams it from the asset package or the loose files.
+*/
+
+#define _CRT_SECURE_NO_WARNINGS
+
+#include <stdio.h>
+#include <string.h>
+#include <algorithm>
+#include "AssetBuilder.h"
+#include "WaveFile.h"
+#include "Adpcm.h"
+#include "AudioBank.h"
+#include "Resampler.h"
+
+static const char *soundsDirectory = "Sounds";
+static const char *streamedDirectory = "FinalDestination/";
+
+static bool compareEntries(const AudioClipEntry &a, const AudioClipEntry &b)
+{
+	return a.nameHash < b.nameHash;
+}
+
+/*
+	Reads a whole wave file, resamples it to AUDIO_BANK_SAMPLE_RATE if needed
+	and appends its ADPCM blocks to data, filling in the entry that describes them.
+*/
+static bool encodeClip(const std::string &path, const std::string &name, std::vector<unsigned char> &data, AudioClipEntry *entry, unsigned int *rawBytes)
+{
+	WaveFileC wave;
+
+	if (!wave.open(path.c_str()) || name.size() >= AUDIO_CLIP_NAME_LENGTH)
+		return false;
+
+	int frames = wave.getFrameCount();
+	int channels = wave.getChannels();
+	std::vector<short> samples((size_t)frames * channels + 1);
+
+	frames = wave.read(&samples[0], frames);
+
+	*rawBytes += frames * channels * sizeof(short);
+
+	if (wave.getSampleRate() != AUDIO_BANK_SAMPLE_RATE)
+	{
+		std::vector<short> resampled;
+		ResamplerC resampler(wave.getSampleRate(), AUDIO_BANK_SAMPLE_RATE);
+
+		frames = resampler.resample(&samples[0], frames, channels, resampled);
+		resampled.push_back(0);
+		samples.swap(resampled);
+	}
+
+	memset(entry, 0, sizeof(AudioClipEntry));
+	strcpy(entry->name, name.c_str());
+	entry->nameHash = hashAssetName(entry->name);
+	entry->sampleRate = AUDIO_BANK_SAMPLE_RATE;
+	entry->channels = (unsigned short)channels;
+	entry->blockBytes = ADPCM_BLOCK_BYTES;
+	entry->frameCount = frames;
+	entry->dataOffset = (unsigned int)data.size();
+	entry->dataBytes = getAdpcmEncodedBytes(frames, channels);
+
+	data.resize(data.size() + entry->dataBytes);
+	encodeAdpcm(&samples[0], frames, channels, &data[entry->dataOffset]);
+
+	return true;
+}
+
+int buildAudioBank(int argc, char **argv)
+{
+	if (argc < 2)
+	{
+		printf("usage: AssetBuilder bank <game directory> <output bank>\n");
+		return 1;
+	}
+
+	std::string gameDirectory = argv[0];
+	std::string soundsPath = gameDirectory + "/" + soundsDirectory;
+	std::vector<std::string> files;
+	std::vector<AudioClipEntry> entries;
+	std::vector<unsigned char> data(sizeof(AudioBankHeader));
+	unsigned int rawBytes = 0;
+
+	findFiles(soundsPath, ".wav", files);
+
+	for (size_t i = 0; i < files.size(); i++)
+	{
+		if (!files[i].compare(0, strlen(streamedDirectory), streamedDirectory))
+			continue;
+
+		AudioClipEntry entry;
+		std::string name = std::string(soundsDirectory) + "/" + files[i];
+
+		if (encodeClip(soundsPath + "/" + files[i], name, data, &entry, &rawBytes))
+			entries.push_back(entry);
+		else
+			printf("skipped %s (not 16-bit PCM or name too long)\n", name.c_str());
+	}
+
+	std::sort(entries.begin(), entries.end(), compareEntries);
+
+	AudioBankHeader header;
+	header.magic = AUDIO_BANK_MAGIC;
+	header.version = AUDIO_BANK_VERSION;
+	header.clipCount = (unsigned int)entries.size();
+	header.directoryOffset = (unsigned int)data.size();
+
+	memcpy(&data[0], &header, sizeof(AudioBankHeader));
+
+	if (!entries.empty())
+	{
+		const unsigned char *directory = (const unsigned char *)&entries[0];
+		data.insert(data.end(), directory, directory + entries.size() * sizeof(AudioClipEntry));
+	}
+
+	if (!writeFile(argv[1], data))
+	{
+		printf("could not write %s\n", argv[1]);
+		return 1;
+	}
+
+	printf("%d clips, %u bytes of samples packed into %u bytes (%.1f%%)\n", (int)entries.size(), rawBytes, (unsigned int)data.size(),
+		rawBytes ? 100.0 * data.size() / rawBytes : 0.0);
+
+	return 0;
+}
\ No newline at end of file
@@ -0,0 +1,128 @@
+/*
+	PackageBuilder.cpp
+
+	The pack command of the asset builder.
+	Gathers the screens, sprite sheets and their trimmed atlases, audio bank and streamed music of the game into one AssetPackageC file.
+	The directory follows the header and every payload starts on a page boundary, so the game can map the package and use assets in place.
+*/
+
+#define _CRT_SECURE_NO_WARNINGS
+
+#include <stdio.h>
+#include <string.h>
+#include <algorithm>
+#include "AssetBuilder.h"
+#include "AssetPackage.h"
+
+struct PackageSource
+{
+	const char *directory;
+	const char *extension;
+	AssetType::AssetType type;
+};
+
+static const PackageSource sources[] =
+{
+	{ "Screens", ".png", AssetType::Texture },
+	{ "SpriteSheets", ".png", AssetType::Texture },
+	{ "SpriteSheets", ".tga", AssetType::Texture },
+	{ "SpriteSheets", ".atlas", AssetType::SpriteAtlas },
+	{ "Sounds", ".bank", AssetType::AudioBank },
+	{ "Sounds/FinalDestination", ".wav", AssetType::Wave }
+};
+
+static const int sourceCount = sizeof(sources) / sizeof(sources[0]);
+
+static bool compareEntries(const AssetEntry &a, const AssetEntry &b)
+{
+	return a.nameHash < b.nameHash;
+}
+
+static unsigned int alignOffset(unsigned int offset)
+{
+	return (offset + ASSET_PACKAGE_ALIGNMENT - 1) & ~(ASSET_PACKAGE_ALIGNMENT - 1);
+}
+
+int buildAssetPackage(int argc, char **argv)
+{
+	if (argc < 2)
+	{
+		printf("usage: AssetBuilder pack <game directory> <output package>\n");
+		return 1;
+	}
+
+	std::string gameDirectory = argv[0];
+	std::vector<AssetEntry> entries;
+	std::vector<std::string> paths;
+
+	for (int i = 0; i < sourceCount; i++)
+	{
+		std::vector<std::string> files;
+
+		findFiles(gameDirectory + "/" + sources[i].directory, sources[i].extension, files);
+
+		for (size_t j = 0; j < files.size(); j++)
+		{
+			std::string name = std::string(sources[i].directory) + "/" + files[j];
+
+			if (name.size() >= ASSET_NAME_LENGTH)
+			{
+				printf("skipped %s (name too long)\n", name.c_str());
+				continue;
+			}
+
+			AssetEntry entry;
+			memset(&entry, 0, sizeof(AssetEntry));
+			strcpy(entry.name, name.c_str());
+			entry.nameHash = getAssetId(entry.name);
+			entry.type = sources[i].type;
+
+			entries.push_back(entry);
+		}
+	}
+
+	std::sort(entries.begin(), entries.end(), compareEntries);
+
+	unsigned int directoryOffset = sizeof(AssetPackageHeader);
+	std::vector<unsigned char> data(alignOffset(directoryOffset + (unsigned int)(entries.size() * sizeof(AssetEntry))));
+	unsigned int payloadBytes = 0;
+
+	for (size_t i = 0; i < entries.size(); i++)
+	{
+		std::vector<unsigned char> payload;
+
+		if (!readFile(gameDirectory + "/" + entries[i].name, payload))
+		{
+			printf("could not read %s\n", entries[i].name);
+			return 1;
+		}
+
+		entries[i].offset = (unsigned int)data.size();
+		entries[i].size = (unsigned int)payload.size();
+		payloadBytes += entries[i].size;
+
+		data.insert(data.end(), payload.begin(), payload.end());
+		data.resize(alignOffset((unsigned int)data.size()));
+	}
+
+	AssetPackageHeader header;
+	header.magic = ASSET_PACKAGE_MAGIC;
+	header.version = ASSET_PACKAGE_VERSION;
+	header.assetCount = (unsigned int)entries.size();
+	header.directoryOffset = directoryOffset;
+
+	memcpy(&data[0], &header, sizeof(AssetPackageHeader));
+
+	if (!entries.empty())
+		memcpy(&data[directoryOffset], &entries[0], entries.size() * sizeof(AssetEntry));
+
+	if (!writeFile(argv[1], data))
+	{
+		printf("could not write %s\n", argv[1]);
+		return 1;
+	}
+
+	printf("%d assets, %u bytes of payload packed into %u bytes\n", (int)entries.size(), payloadBytes, (unsigned int)data.size());
+
+	return 0;
+}
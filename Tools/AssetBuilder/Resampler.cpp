@@ -0,0 +1,127 @@
+/*
+	Resampler.cpp
+
+	This file contains the implementation for functions prototyped in the ResamplerC class.
+*/
+
+#include <math.h>
+#include "Resampler.h"
+
+static const double pi = 3.14159265358979323846;
+static const double kaiserBeta = 8.6;
+static const double passband = 0.97;
+
+/*
+	Zeroth order modified Bessel function of the first kind, used by the Kaiser window.
+*/
+static double besselI0(double x)
+{
+	double sum = 1.0;
+	double term = 1.0;
+
+	for (int k = 1; k < 50 && term > sum * 1e-12; k++)
+	{
+		term *= (x / (2.0 * k)) * (x / (2.0 * k));
+		sum += term;
+	}
+
+	return sum;
+}
+
+/* Public functions */
+/*
+	Builds the filter table. The cutoff sits just below the lower of the two Nyquist frequencies,
+	so downsampling removes what the output rate cannot hold and upsampling removes the images of the input.
+	Every phase is normalized to unity gain so constant input stays constant.
+*/
+ResamplerC::ResamplerC(int inputRate, int outputRate)
+{
+	mInputRate = inputRate;
+	mOutputRate = outputRate;
+
+	double cutoff = 0.5 * passband * (outputRate < inputRate ? (double)outputRate / inputRate : 1.0);
+	double halfWidth = RESAMPLER_ZERO_CROSSINGS / (2.0 * cutoff);
+
+	mTaps = 2 * (int)ceil(halfWidth);
+	mTable.resize((RESAMPLER_PHASES + 1) * mTaps);
+
+	for (int phase = 0; phase <= RESAMPLER_PHASES; phase++)
+	{
+		float *taps = &mTable[phase * mTaps];
+		double fraction = (double)phase / RESAMPLER_PHASES;
+		double sum = 0.0;
+
+		for (int k = 0; k < mTaps; k++)
+		{
+			double time = k - (mTaps / 2 - 1) - fraction;
+			double x = time / halfWidth;
+			double window = fabs(x) < 1.0 ? besselI0(kaiserBeta * sqrt(1.0 - x * x)) / besselI0(kaiserBeta) : 0.0;
+			double tap = sinc(time * 2.0 * cutoff) * 2.0 * cutoff * window;
+
+			taps[k] = (float)tap;
+			sum += tap;
+		}
+
+		for (int k = 0; k < mTaps; k++)
+			taps[k] = (float)(taps[k] / sum);
+	}
+}
+
+int ResamplerC::getOutputFrames(int inputFrames)
+{
+	return (int)(((long long)inputFrames * mOutputRate + mInputRate - 1) / mInputRate);
+}
+
+/*
+	Converts interleaved 16-bit frames to the output rate, replacing the contents of output.
+	Samples outside the clip are treated as silence. Returns the number of output frames.
+*/
+int ResamplerC::resample(const short *input, int frames, int channels, std::vector<short> &output)
+{
+	int outputFrames = getOutputFrames(frames);
+	int firstTap = -(mTaps / 2 - 1);
+
+	output.assign((size_t)outputFrames * channels, 0);
+
+	for (int n = 0; n < outputFrames; n++)
+	{
+		long long numerator = (long long)n * mInputRate;
+		int position = (int)(numerator / mOutputRate);
+		double phase = (double)(numerator % mOutputRate) / mOutputRate * RESAMPLER_PHASES;
+		int phaseIndex = (int)phase;
+		float blend = (float)(phase - phaseIndex);
+
+		const float *taps0 = &mTable[phaseIndex * mTaps];
+		const float *taps1 = taps0 + mTaps;
+
+		for (int channel = 0; channel < channels; channel++)
+		{
+			float sum = 0.0f;
+
+			for (int k = 0; k < mTaps; k++)
+			{
+				int source = position + firstTap + k;
+
+				if (source < 0 || source >= frames)
+					continue;
+
+				float tap = taps0[k] + (taps1[k] - taps0[k]) * blend;
+
+				sum += input[source * channels + channel] * tap;
+			}
+
+			sum = sum > 32767.0f ? 32767.0f : sum;
+			sum = sum < -32768.0f ? -32768.0f : sum;
+
+			output[n * channels + channel] = (short)floorf(sum + 0.5f);
+		}
+	}
+
+	return outputFrames;
+}
+
+/* Private functions */
+double ResamplerC::sinc(double x)
+{
+	return fabs(x) < 1e-9 ? 1.0 : sin(pi * x) / (pi * x);
+}
\ No newline at end of file
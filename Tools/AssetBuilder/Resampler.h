@@ -0,0 +1,34 @@
+#pragma once
+/*
+	Resampler.h
+
+	Polyphase windowed-sinc sample rate converter used to bring every clip to the bank's rate when it is built.
+	The Kaiser windowed sinc is tabulated for a fixed number of fractional positions between two input samples,
+	and each output sample interpolates between the two nearest phases of the table.
+*/
+
+#include <vector>
+
+#define RESAMPLER_ZERO_CROSSINGS 16
+#define RESAMPLER_PHASES 512
+
+class ResamplerC
+{
+public:
+	/* Public functions */
+	ResamplerC(int inputRate, int outputRate);
+
+	int getOutputFrames(int inputFrames);
+	int resample(const short *input, int frames, int channels, std::vector<short> &output);
+
+private:
+	/* Private functions */
+	double sinc(double x);
+
+	/* Private data members */
+	int mInputRate;
+	int mOutputRate;
+	int mTaps;
+
+	std::vector<float> mTable;
+};
\ No newline at end of file
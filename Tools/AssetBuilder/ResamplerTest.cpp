@@ -0,0 +1,225 @@
+/*
+	ResamplerTest.cpp
+
+	The resampletest command of the asset builder.
+	Converts test tones with ResamplerC from each rate the game's clips are recorded at to the bank's rate and measures two things:
+	the signal to noise ratio against a double precision direct sinc sum of the filter, computed independently of ResamplerC's code,
+	which catches errors in its kernel, table, interpolation and arithmetic, and the THD+N of the output against a pure tone, which catches aliasing, imaging and ringing.
+	Exits non-zero if any conversion falls below the thresholds below.
+*/
+
+#define _CRT_SECURE_NO_WARNINGS
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include "AssetBuilder.h"
+#include "AudioBank.h"
+#include "Resampler.h"
+
+#define RESAMPLER_TEST_FRAMES 16384
+#define RESAMPLER_TEST_AMPLITUDE 16384.0
+#define RESAMPLER_TEST_MIN_SNR 85.0
+#define RESAMPLER_TEST_MAX_THDN -85.0
+#define RESAMPLER_TEST_BESSEL_STEPS 32
+
+static const double pi = 3.14159265358979323846;
+static const double kaiserBeta = 8.6;
+static const double passband = 0.97;
+
+static const int testRates[] = { 11025, 22050, 32000, 44100, 96000 };
+static const double testTones[] = { 0.1, 0.4, 0.7 };
+
+static const int testRateCount = sizeof(testRates) / sizeof(testRates[0]);
+static const int testToneCount = sizeof(testTones) / sizeof(testTones[0]);
+
+/*
+	Zeroth order modified Bessel function of the first kind from its integral, I0(x) = 1/pi * the integral of exp(x cos t) over [0, pi],
+	taken by the midpoint rule, which converges very quickly for this periodic integrand.
+	ResamplerC sums the power series instead, so a mistake in either shows up as a difference rather than cancelling out.
+*/
+static double integrateBesselI0(double x)
+{
+	double sum = 0.0;
+
+	for (int i = 0; i < RESAMPLER_TEST_BESSEL_STEPS; i++)
+		sum += exp(x * cos(pi * (i + 0.5) / RESAMPLER_TEST_BESSEL_STEPS));
+
+	return sum / RESAMPLER_TEST_BESSEL_STEPS;
+}
+
+/*
+	The filter the resampler is meant to apply, written out on its own rather than taken from ResamplerC: an ideal low-pass at the cutoff,
+	shaped by a Kaiser window that reaches RESAMPLER_ZERO_CROSSINGS zero crossings of it either side.
+	Each output sample sums every input sample within the window's reach times the kernel at its distance from the output's exact time,
+	in double precision, and divides by the sum of the kernel over the same samples so constant input stays constant.
+	There is no table, no tap indexing and no rounding, so an error in any of them in ResamplerC shows up as noise.
+*/
+static void resampleReference(const double *input, int frames, int inputRate, int outputRate, double *output, int outputFrames)
+{
+	double cutoff = 0.5 * passband * (outputRate < inputRate ? (double)outputRate / inputRate : 1.0);
+	double reach = RESAMPLER_ZERO_CROSSINGS / (2.0 * cutoff);
+	double windowScale = 1.0 / integrateBesselI0(kaiserBeta);
+
+	for (int n = 0; n < outputFrames; n++)
+	{
+		double time = (double)n * inputRate / outputRate;
+		int first = (int)ceil(time - reach);
+		int last = (int)floor(time + reach);
+		double sum = 0.0;
+		double weight = 0.0;
+
+		for (int m = first; m <= last; m++)
+		{
+			double distance = time - m;
+			double ratio = distance / reach;
+
+			if (fabs(ratio) >= 1.0)
+				continue;
+
+			double lowPass = distance == 0.0 ? 2.0 * cutoff : sin(2.0 * pi * cutoff * distance) / (pi * distance);
+			double kernel = lowPass * integrateBesselI0(kaiserBeta * sqrt(1.0 - ratio * ratio)) * windowScale;
+
+			weight += kernel;
+
+			if (m >= 0 && m < frames)
+				sum += input[m] * kernel;
+		}
+
+		output[n] = sum / weight;
+	}
+}
+
+/*
+	The power left in signal from first to last once the best fitting sinusoid of the given frequency, in cycles per sample, is removed,
+	relative to the power of the signal, in dB.
+*/
+static double measureThdPlusNoise(const double *signal, int first, int last, double frequency)
+{
+	double cc = 0.0, ss = 0.0, cs = 0.0, xc = 0.0, xs = 0.0;
+
+	for (int n = first; n < last; n++)
+	{
+		double c = cos(2.0 * pi * frequency * n);
+		double s = sin(2.0 * pi * frequency * n);
+
+		cc += c * c;
+		ss += s * s;
+		cs += c * s;
+		xc += signal[n] * c;
+		xs += signal[n] * s;
+	}
+
+	double determinant = cc * ss - cs * cs;
+	double a = (xc * ss - xs * cs) / determinant;
+	double b = (xs * cc - xc * cs) / determinant;
+	double residual = 0.0;
+	double total = 0.0;
+
+	for (int n = first; n < last; n++)
+	{
+		double error = signal[n] - a * cos(2.0 * pi * frequency * n) - b * sin(2.0 * pi * frequency * n);
+
+		residual += error * error;
+		total += signal[n] * signal[n];
+	}
+
+	return 10.0 * log10(residual / total);
+}
+
+/*
+	Converts a tone at the given fraction of the lower Nyquist frequency and prints its SNR and THD+N.
+	The first and last filter lengths of the output are left out, as the clip's edges are not part of a steady tone.
+	Returns whether both are within the thresholds.
+*/
+static bool testTone(int inputRate, int outputRate, double tone)
+{
+	ResamplerC resampler(inputRate, outputRate);
+	double frequency = tone * 0.5 * (inputRate < outputRate ? inputRate : outputRate);
+	int outputFrames = resampler.getOutputFrames(RESAMPLER_TEST_FRAMES);
+	std::vector<short> input(RESAMPLER_TEST_FRAMES);
+	std::vector<double> exact(RESAMPLER_TEST_FRAMES);
+	std::vector<double> reference(outputFrames);
+	std::vector<double> converted(outputFrames);
+	std::vector<short> output;
+
+	for (int m = 0; m < RESAMPLER_TEST_FRAMES; m++)
+	{
+		input[m] = (short)floor(RESAMPLER_TEST_AMPLITUDE * sin(2.0 * pi * frequency * m / inputRate) + 0.5);
+		exact[m] = input[m];
+	}
+
+	resampler.resample(&input[0], RESAMPLER_TEST_FRAMES, 1, output);
+	resampleReference(&exact[0], RESAMPLER_TEST_FRAMES, inputRate, outputRate, &reference[0], outputFrames);
+
+	int edge = (int)ceil(2.0 * RESAMPLER_ZERO_CROSSINGS * (outputRate > inputRate ? (double)outputRate / inputRate : 1.0) / passband) + 1;
+	double signal = 0.0;
+	double noise = 0.0;
+
+	for (int n = 0; n < outputFrames; n++)
+	{
+		converted[n] = output[n];
+
+		if (n >= edge && n < outputFrames - edge)
+		{
+			signal += reference[n] * reference[n];
+			noise += (converted[n] - reference[n]) * (converted[n] - reference[n]);
+		}
+	}
+
+	double snr = 10.0 * log10(signal / noise);
+	double thdPlusNoise = measureThdPlusNoise(&converted[0], edge, outputFrames - edge, frequency / outputRate);
+	bool passed = snr >= RESAMPLER_TEST_MIN_SNR && thdPlusNoise <= RESAMPLER_TEST_MAX_THDN;
+
+	printf("  %6d -> %6d Hz, %8.1f Hz tone: SNR %6.1f dB, THD+N %6.1f dB%s\n", inputRate, outputRate, frequency, snr, thdPlusNoise, passed ? "" : "  FAILED");
+
+	return passed;
+}
+
+/*
+	Tests every rate the game's clips are recorded at against the bank's rate, or only the rates given.
+*/
+int testResampler(int argc, char **argv)
+{
+	if (argc == 1 || argc > 2)
+	{
+		printf("usage: AssetBuilder resampletest [<input rate> <output rate>]\n");
+		return 1;
+	}
+
+	int failures = 0;
+	int tests = 0;
+
+	printf("resampler test, %.0f dBFS tones: SNR against a direct sinc reference at least %.0f dB, THD+N at most %.0f dB\n",
+		20.0 * log10(RESAMPLER_TEST_AMPLITUDE / 32768.0), RESAMPLER_TEST_MIN_SNR, RESAMPLER_TEST_MAX_THDN);
+
+	for (int i = 0; i < (argc == 2 ? 1 : testRateCount); i++)
+	{
+		int inputRate = argc == 2 ? atoi(argv[0]) : testRates[i];
+		int outputRate = argc == 2 ? atoi(argv[1]) : AUDIO_BANK_SAMPLE_RATE;
+
+		if (inputRate <= 0 || outputRate <= 0)
+		{
+			printf("invalid sample rate\n");
+			return 1;
+		}
+
+		for (int j = 0; j < testToneCount; j++)
+		{
+			if (!testTone(inputRate, outputRate, testTones[j]))
+				failures++;
+
+			tests++;
+		}
+	}
+
+	if (failures > 0)
+	{
+		printf("RESAMPLER TEST FAILED: %d of %d conversions below threshold\n", failures, tests);
+		return 1;
+	}
+
+	printf("all %d conversions passed\n", tests);
+
+	return 0;
+}
\ No newline at end of file
@@ -0,0 +1,341 @@
+/*
+	TrimBuilder.cpp
+
+	The trim command of the asset builder.
+	Crops every cell of a sprite sheet to its opaque bounds, drops cells that repeat an earlier one,
+	and packs the remaining frames tightly into a power of two atlas written as a run-length encoded TGA, along with the SpriteAtlasC frame table.
+	Most of every cell is transparent, so the atlas is a fraction of the sheet's size and far less area is blended when it is drawn.
+*/
+
+#define _CRT_SECURE_NO_WARNINGS
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <algorithm>
+#include "AssetBuilder.h"
+#include "SpriteAtlas.h"
+#include "SOIL.h"
+
+#define TRIM_BORDER 1
+#define TRIM_PADDING 2
+#define TRIM_MIN_ATLAS_SIZE 64
+#define TRIM_MAX_ATLAS_SIZE 4096
+
+struct TrimmedFrame
+{
+	int cell;
+	int left;
+	int top;
+	int width;
+	int height;
+	int duplicateOf;
+	int x;
+	int y;
+};
+
+static int nextPowerOfTwo(int value)
+{
+	int power = 1;
+
+	while (power < value)
+		power *= 2;
+
+	return power;
+}
+
+static bool compareFrameHeights(const TrimmedFrame *a, const TrimmedFrame *b)
+{
+	return a->height != b->height ? a->height > b->height : a->cell < b->cell;
+}
+
+/*
+	Finds the smallest rectangle of the cell that holds every pixel with any alpha. Returns false if the cell is empty.
+*/
+static bool findOpaqueBounds(const unsigned char *pixels, int sheetWidth, int cellX, int cellY, int cellWidth, int cellHeight, TrimmedFrame *frame)
+{
+	int left = cellWidth;
+	int right = -1;
+	int top = cellHeight;
+	int bottom = -1;
+
+	for (int y = 0; y < cellHeight; y++)
+	{
+		const unsigned char *row = pixels + ((size_t)(cellY + y) * sheetWidth + cellX) * 4;
+
+		for (int x = 0; x < cellWidth; x++)
+		{
+			if (row[x * 4 + 3] != 0)
+			{
+				left = std::min(left, x);
+				right = std::max(right, x);
+				top = std::min(top, y);
+				bottom = std::max(bottom, y);
+			}
+		}
+	}
+
+	if (right < 0)
+		return false;
+
+	frame->left = left;
+	frame->top = top;
+	frame->width = right - left + 1;
+	frame->height = bottom - top + 1;
+
+	return true;
+}
+
+static bool framesMatch(const unsigned char *pixels, int sheetWidth, int cellWidth, int cellHeight, int columns, const TrimmedFrame &a, const TrimmedFrame &b)
+{
+	if (a.left != b.left || a.top != b.top || a.width != b.width || a.height != b.height)
+		return false;
+
+	int ax = (a.cell % columns) * cellWidth + a.left;
+	int ay = (a.cell / columns) * cellHeight + a.top;
+	int bx = (b.cell % columns) * cellWidth + b.left;
+	int by = (b.cell / columns) * cellHeight + b.top;
+
+	for (int y = 0; y < a.height; y++)
+	{
+		if (memcmp(pixels + ((size_t)(ay + y) * sheetWidth + ax) * 4, pixels + ((size_t)(by + y) * sheetWidth + bx) * 4, a.width * 4))
+			return false;
+	}
+
+	return true;
+}
+
+/*
+	Places the frames on shelves from tallest to shortest, each frame padded by its transparent border and a gap.
+	Returns false if they do not fit in an atlas of the given width and height.
+*/
+static bool packFrames(std::vector<TrimmedFrame *> &frames, int width, int height)
+{
+	int x = 0;
+	int y = 0;
+	int shelfHeight = 0;
+
+	for (size_t i = 0; i < frames.size(); i++)
+	{
+		int frameWidth = frames[i]->width + 2 * TRIM_BORDER + TRIM_PADDING;
+		int frameHeight = frames[i]->height + 2 * TRIM_BORDER + TRIM_PADDING;
+
+		if (x + frameWidth > width)
+		{
+			x = 0;
+			y += shelfHeight;
+			shelfHeight = 0;
+		}
+
+		if (frameWidth > width || y + frameHeight > height)
+			return false;
+
+		frames[i]->x = x;
+		frames[i]->y = y;
+
+		x += frameWidth;
+		shelfHeight = std::max(shelfHeight, frameHeight);
+	}
+
+	return true;
+}
+
+/*
+	Writes 32 bit BGRA pixels as a run-length encoded, top-left origin TGA, which SOIL decodes.
+	Runs of identical pixels, such as the transparent space between frames, become a single packet.
+*/
+static void encodeTga(const std::vector<unsigned char> &pixels, int width, int height, std::vector<unsigned char> &output)
+{
+	unsigned char header[18] = { 0 };
+
+	header[2] = 10;
+	header[12] = (unsigned char)(width & 0xFF);
+	header[13] = (unsigned char)(width >> 8);
+	header[14] = (unsigned char)(height & 0xFF);
+	header[15] = (unsigned char)(height >> 8);
+	header[16] = 32;
+	header[17] = 0x28;
+
+	output.assign(header, header + sizeof(header));
+
+	for (int y = 0; y < height; y++)
+	{
+		const unsigned char *row = &pixels[(size_t)y * width * 4];
+		int x = 0;
+
+		while (x < width)
+		{
+			int run = 1;
+
+			while (x + run < width && run < 128 && !memcmp(row + (x + run) * 4, row + x * 4, 4))
+				run++;
+
+			if (run > 1)
+			{
+				output.push_back((unsigned char)(0x80 | (run - 1)));
+				output.insert(output.end(), row + x * 4, row + x * 4 + 4);
+			}
+			else
+			{
+				int literal = 1;
+
+				while (x + literal < width && literal < 128 && (x + literal + 1 >= width || memcmp(row + (x + literal) * 4, row + (x + literal + 1) * 4, 4)))
+					literal++;
+
+				output.push_back((unsigned char)(literal - 1));
+				output.insert(output.end(), row + x * 4, row + (x + literal) * 4);
+				run = literal;
+			}
+
+			x += run;
+		}
+	}
+}
+
+int trimSpriteSheet(int argc, char **argv)
+{
+	if (argc < 3)
+	{
+		printf("usage: AssetBuilder trim <sprite sheet> <columns> <rows>\n");
+		return 1;
+	}
+
+	const char *sheetPath = argv[0];
+	int columns = atoi(argv[1]);
+	int rows = atoi(argv[2]);
+	int sheetWidth = 0;
+	int sheetHeight = 0;
+	int channels = 0;
+	unsigned char *pixels = SOIL_load_image(sheetPath, &sheetWidth, &sheetHeight, &channels, SOIL_LOAD_RGBA);
+
+	if (pixels == NULL || columns <= 0 || rows <= 0)
+	{
+		printf("could not read %s\n", sheetPath);
+		return 1;
+	}
+
+	int cellWidth = sheetWidth / columns;
+	int cellHeight = sheetHeight / rows;
+	std::vector<TrimmedFrame> frames(columns * rows);
+	std::vector<TrimmedFrame *> uniqueFrames;
+
+	for (int cell = 0; cell < columns * rows; cell++)
+	{
+		TrimmedFrame &frame = frames[cell];
+
+		memset(&frame, 0, sizeof(TrimmedFrame));
+		frame.cell = cell;
+		frame.duplicateOf = -1;
+
+		if (!findOpaqueBounds(pixels, sheetWidth, (cell % columns) * cellWidth, (cell / columns) * cellHeight, cellWidth, cellHeight, &frame))
+			continue;
+
+		for (size_t i = 0; i < uniqueFrames.size() && frame.duplicateOf < 0; i++)
+		{
+			if (framesMatch(pixels, sheetWidth, cellWidth, cellHeight, columns, frame, *uniqueFrames[i]))
+				frame.duplicateOf = uniqueFrames[i]->cell;
+		}
+
+		if (frame.duplicateOf < 0)
+			uniqueFrames.push_back(&frame);
+	}
+
+	std::sort(uniqueFrames.begin(), uniqueFrames.end(), compareFrameHeights);
+
+	int atlasWidth = 0;
+	int atlasHeight = 0;
+
+	for (int height = TRIM_MIN_ATLAS_SIZE; height <= TRIM_MAX_ATLAS_SIZE; height *= 2)
+	{
+		for (int width = TRIM_MIN_ATLAS_SIZE; width <= TRIM_MAX_ATLAS_SIZE; width *= 2)
+		{
+			if ((atlasWidth == 0 || width * height < atlasWidth * atlasHeight) && packFrames(uniqueFrames, width, height))
+			{
+				atlasWidth = width;
+				atlasHeight = height;
+			}
+		}
+	}
+
+	if (atlasWidth == 0)
+	{
+		printf("the frames of %s do not fit in a %dx%d atlas\n", sheetPath, TRIM_MAX_ATLAS_SIZE, TRIM_MAX_ATLAS_SIZE);
+		SOIL_free_image_data(pixels);
+		return 1;
+	}
+
+	packFrames(uniqueFrames, atlasWidth, atlasHeight);
+
+	std::vector<unsigned char> atlasPixels((size_t)atlasWidth * atlasHeight * 4, 0);
+	std::vector<unsigned char> table(sizeof(SpriteAtlasHeader) + frames.size() * sizeof(SpriteFrame));
+	SpriteAtlasHeader *header = (SpriteAtlasHeader *)&table[0];
+	SpriteFrame *atlasFrames = (SpriteFrame *)&table[sizeof(SpriteAtlasHeader)];
+
+	for (size_t i = 0; i < uniqueFrames.size(); i++)
+	{
+		const TrimmedFrame &frame = *uniqueFrames[i];
+		int sourceX = (frame.cell % columns) * cellWidth + frame.left;
+		int sourceY = (frame.cell / columns) * cellHeight + frame.top;
+
+		for (int y = 0; y < frame.height; y++)
+		{
+			const unsigned char *source = pixels + ((size_t)(sourceY + y) * sheetWidth + sourceX) * 4;
+			unsigned char *destination = &atlasPixels[((size_t)(frame.y + TRIM_BORDER + y) * atlasWidth + frame.x + TRIM_BORDER) * 4];
+
+			for (int x = 0; x < frame.width; x++)
+			{
+				destination[x * 4 + 0] = source[x * 4 + 2];
+				destination[x * 4 + 1] = source[x * 4 + 1];
+				destination[x * 4 + 2] = source[x * 4 + 0];
+				destination[x * 4 + 3] = source[x * 4 + 3];
+			}
+		}
+	}
+
+	header->magic = SPRITE_ATLAS_MAGIC;
+	header->version = SPRITE_ATLAS_VERSION;
+	header->columns = (unsigned short)columns;
+	header->rows = (unsigned short)rows;
+	header->cellWidth = (unsigned short)cellWidth;
+	header->cellHeight = (unsigned short)cellHeight;
+	header->width = (unsigned short)atlasWidth;
+	header->height = (unsigned short)atlasHeight;
+
+	for (size_t i = 0; i < frames.size(); i++)
+	{
+		const TrimmedFrame &frame = frames[i].duplicateOf >= 0 ? frames[frames[i].duplicateOf] : frames[i];
+		SpriteFrame &atlasFrame = atlasFrames[i];
+
+		memset(&atlasFrame, 0, sizeof(SpriteFrame));
+
+		if (frame.width == 0)
+			continue;
+
+		atlasFrame.x = (unsigned short)frame.x;
+		atlasFrame.y = (unsigned short)frame.y;
+		atlasFrame.width = (unsigned short)(frame.width + 2 * TRIM_BORDER);
+		atlasFrame.height = (unsigned short)(frame.height + 2 * TRIM_BORDER);
+		atlasFrame.offsetX = (short)(frame.left - TRIM_BORDER);
+		atlasFrame.offsetY = (short)(frame.top - TRIM_BORDER);
+	}
+
+	SOIL_free_image_data(pixels);
+
+	std::string basePath = sheetPath;
+	std::string texturePath = basePath.substr(0, basePath.rfind('.')) + ".tga";
+	std::string tablePath = basePath.substr(0, basePath.rfind('.')) + ".atlas";
+	std::vector<unsigned char> tga;
+
+	encodeTga(atlasPixels, atlasWidth, atlasHeight, tga);
+
+	if (!writeFile(texturePath, tga) || !writeFile(tablePath, table))
+	{
+		printf("could not write the atlas of %s\n", sheetPath);
+		return 1;
+	}
+
+	printf("%s: %d cells, %d unique frames packed into %dx%d, %.0f%% of the %dx%d texture the sheet is uploaded as\n", sheetPath, columns * rows, (int)uniqueFrames.size(),
+		atlasWidth, atlasHeight, 100.0 * atlasWidth * atlasHeight / ((double)nextPowerOfTwo(sheetWidth) * nextPowerOfTwo(sheetHeight)), nextPowerOfTwo(sheetWidth), nextPowerOfTwo(sheetHeight));
+
+	return 0;
+}
\ No newline at end of file
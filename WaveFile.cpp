@@ -0,0 +1,241 @@
+/*
+	WaveFile.cpp
+
+	This file contains the implementation for functions prototyped in the WaveFileC class.
+*/
+
+#define _CRT_SECURE_NO_WARNINGS
+
+#include <string.h>
+#include "WaveFile.h"
+
+/* Public functions */
+WaveFileC::WaveFileC()
+{
+	mFile = NULL;
+	mMemory = NULL;
+	mMemorySize = 0;
+	mMemoryPosition = 0;
+	mDataStart = 0;
+	mChannels = 0;
+	mSampleRate = 0;
+	mFrameCount = 0;
+	mFramesRead = 0;
+}
+
+WaveFileC::~WaveFileC()
+{
+	close();
+}
+
+/*
+	Opens the file at the given path and positions it at the first sample.
+	Returns false if the file is missing or is not 16-bit PCM.
+*/
+bool WaveFileC::open(const char *path)
+{
+	close();
+
+	mFile = fopen(path, "rb");
+
+	if (mFile == NULL)
+		return false;
+
+	if (!readHeader())
+	{
+		close();
+		return false;
+	}
+
+	return true;
+}
+
+/*
+	Reads a wave image held in memory. The memory must stay valid until the file is closed.
+*/
+bool WaveFileC::openMemory(const unsigned char *data, int size)
+{
+	close();
+
+	mMemory = data;
+	mMemorySize = size;
+	mMemoryPosition = 0;
+
+	if (!readHeader())
+	{
+		close();
+		return false;
+	}
+
+	return true;
+}
+
+void WaveFileC::close()
+{
+	if (mFile != NULL)
+	{
+		fclose(mFile);
+		mFile = NULL;
+	}
+
+	mMemory = NULL;
+	mMemorySize = 0;
+	mMemoryPosition = 0;
+}
+
+bool WaveFileC::rewind()
+{
+	if (!isOpen() || !seek(mDataStart))
+		return false;
+
+	mFramesRead = 0;
+
+	return true;
+}
+
+bool WaveFileC::isOpen()
+{
+	return mFile != NULL || mMemory != NULL;
+}
+
+/*
+	Reads up to the given number of interleaved frames into samples.
+	Returns the number of frames read, which is less than requested once the end of the data is reached.
+*/
+int WaveFileC::read(short *samples, int frames)
+{
+	if (!isOpen())
+		return 0;
+
+	if (frames > mFrameCount - mFramesRead)
+		frames = mFrameCount - mFramesRead;
+
+	if (frames <= 0)
+		return 0;
+
+	int frameBytes = sizeof(short) * mChannels;
+	int framesRead = (int)(readBytes(samples, frames * frameBytes) / frameBytes);
+	mFramesRead += framesRead;
+
+	return framesRead;
+}
+
+int WaveFileC::getChannels()
+{
+	return mChannels;
+}
+
+int WaveFileC::getSampleRate()
+{
+	return mSampleRate;
+}
+
+int WaveFileC::getFrameCount()
+{
+	return mFrameCount;
+}
+
+/* Private functions */
+/*
+	Walks the RIFF chunks looking for the format and data chunks, skipping any others.
+*/
+bool WaveFileC::readHeader()
+{
+	char id[4];
+	unsigned int size;
+	char waveId[4];
+	bool formatFound = false;
+
+	if (readBytes(id, 4) != 4 || readBytes(&size, 4) != 4 || readBytes(waveId, 4) != 4)
+		return false;
+
+	if (strncmp(id, "RIFF", 4) || strncmp(waveId, "WAVE", 4))
+		return false;
+
+	while (readBytes(id, 4) == 4 && readBytes(&size, 4) == 4)
+	{
+		if (!strncmp(id, "fmt ", 4))
+		{
+			unsigned short format, channels, blockAlign, bitsPerSample;
+			unsigned int sampleRate, bytesPerSecond;
+
+			if (size < 16)
+				return false;
+
+			readBytes(&format, 2);
+			readBytes(&channels, 2);
+			readBytes(&sampleRate, 4);
+			readBytes(&bytesPerSecond, 4);
+			readBytes(&blockAlign, 2);
+			readBytes(&bitsPerSample, 2);
+
+			if (format != 1 || bitsPerSample != 16 || channels == 0)
+				return false;
+
+			mChannels = channels;
+			mSampleRate = sampleRate;
+			formatFound = true;
+
+			skip((size - 16) + (size & 1));
+		}
+		else if (!strncmp(id, "data", 4))
+		{
+			if (!formatFound)
+				return false;
+
+			mDataStart = tell();
+			mFrameCount = size / (sizeof(short) * mChannels);
+			mFramesRead = 0;
+
+			return true;
+		}
+		else
+		{
+			skip(size + (size & 1));
+		}
+	}
+
+	return false;
+}
+
+bool WaveFileC::seek(long position)
+{
+	if (mFile != NULL)
+		return fseek(mFile, position, SEEK_SET) == 0;
+
+	if (position < 0 || position > mMemorySize)
+		return false;
+
+	mMemoryPosition = position;
+
+	return true;
+}
+
+bool WaveFileC::skip(long bytes)
+{
+	return seek(tell() + bytes);
+}
+
+/*
+	Reads bytes from the file or the wave image, returning how many were available.
+*/
+size_t WaveFileC::readBytes(void *destination, size_t bytes)
+{
+	if (mFile != NULL)
+		return fread(destination, 1, bytes, mFile);
+
+	size_t available = (size_t)(mMemorySize - mMemoryPosition);
+
+	if (bytes > available)
+		bytes = available;
+
+	memcpy(destination, mMemory + mMemoryPosition, bytes);
+	mMemoryPosition += (long)bytes;
+
+	return bytes;
+}
+
+long WaveFileC::tell()
+{
+	return mFile != NULL ? ftell(mFile) : mMemoryPosition;
+}
\ No newline at end of file
@@ -0,0 +1,52 @@
+#pragma once
+/*
+	WaveFile.h
+
+	This class reads 16-bit PCM samples out of a RIFF wave file.
+	Samples are read in caller-sized chunks so a file never has to be held in memory as a whole.
+	A wave image already in memory, such as one mapped from the asset package, can be read the same way.
+*/
+
+#include <stdio.h>
+
+class WaveFileC
+{
+public:
+	/* Public functions */
+	WaveFileC();
+	~WaveFileC();
+
+	bool open(const char *path);
+	bool openMemory(const unsigned char *data, int size);
+	void close();
+	bool rewind();
+	bool isOpen();
+
+	int read(short *samples, int frames);
+	int getChannels();
+	int getSampleRate();
+	int getFrameCount();
+
+private:
+	/* Private functions */
+	bool readHeader();
+	bool seek(long position);
+	bool skip(long bytes);
+
+	size_t readBytes(void *destination, size_t bytes);
+	long tell();
+
+	/* Private data members */
+	FILE *mFile;
+
+	const unsigned char *mMemory;
+
+	long mMemorySize;
+	long mMemoryPosition;
+	long mDataStart;
+
+	int mChannels;
+	int mSampleRate;
+	int mFrameCount;
+	int mFramesRead;
+};
\ No newline at end of file
@@ -19,6 +19,12 @@
 #include "PlayerManager.h"
 #include "ScreenManager.h"
 #include "SoundManager.h"
+#include "GameEventManager.h"
+#include "HapticsManager.h"
+#include "AssetPackage.h"
+#include "TextureManager.h"
+#include "Benchmark.h"
+#include "LatencyMonitor.h"
 
 // Declarations
 const char8_t CGame::mGameTitle[]="Kirby Kickout";
@@ -33,23 +39,51 @@ BOOL Initialize (GL_Window* window, Keys* keys)					// Any OpenGL Initialization
 
 void CGame::init()
 {
+	mStartTime = getBenchmarkSeconds();
+	mFirstFrameDrawn = false;
+
+	AssetPackageC::CreateInstance();
+	TextureManagerC::CreateInstance();
+	GameEventManagerC::CreateInstance();
 	ScreenManagerC::CreateInstance();
 	PlayerManagerC::CreateInstance();
 	SoundManagerC::CreateInstance();
+	HapticsManagerC::CreateInstance();
+	LatencyMonitorC::CreateInstance();
 
+	AssetPackageC::GetInstance()->init();
+	TextureManagerC::GetInstance()->init();
+	GameEventManagerC::GetInstance()->init();
 	ScreenManagerC::GetInstance()->init();
 	SoundManagerC::GetInstance()->init();
+	HapticsManagerC::GetInstance()->init();
+	LatencyMonitorC::GetInstance()->init();
 }
 void CGame::UpdateFrame(DWORD milliseconds)			
 {
 	keyProcess();
+	TextureManagerC::GetInstance()->update();
 	ScreenManagerC::GetInstance()->update(milliseconds);
 }
 
+/*
+	Returns whether the scene has changed since it was last drawn. Static menu screens are only drawn again when they change.
+*/
+bool CGame::IsRedrawNeeded()
+{
+	return ScreenManagerC::GetInstance()->isRedrawNeeded();
+}
+
 void CGame::DrawScene(void)											
 {
 	startOpenGLDrawing();
 	ScreenManagerC::GetInstance()->renderScreen();
+
+	if (!mFirstFrameDrawn && ScreenManagerC::GetInstance()->isScreenReady())
+	{
+		printf("Time to first frame: %.1f ms\n", (getBenchmarkSeconds() - mStartTime) * 1000.0);
+		mFirstFrameDrawn = true;
+	}
 }
 
 CGame *CGame::CreateInstance()
@@ -61,10 +95,20 @@ void CGame::shutdown()
 {
 	ScreenManagerC::GetInstance()->shutdown();
 	SoundManagerC::GetInstance()->shutdown();
+	HapticsManagerC::GetInstance()->shutdown();
+	GameEventManagerC::GetInstance()->shutdown();
+	TextureManagerC::GetInstance()->shutdown();
+	AssetPackageC::GetInstance()->shutdown();
+	LatencyMonitorC::GetInstance()->report();
 }
 void CGame::DestroyGame(void)
 {
 	delete ScreenManagerC::GetInstance();
 	delete PlayerManagerC::GetInstance();
 	delete SoundManagerC::GetInstance();
+	delete HapticsManagerC::GetInstance();
+	delete GameEventManagerC::GetInstance();
+	delete TextureManagerC::GetInstance();
+	delete AssetPackageC::GetInstance();
+	delete LatencyMonitorC::GetInstance();
 }
\ No newline at end of file
@@ -7,6 +7,7 @@ public:
 	~CGame();
 	void DrawScene();
 	void UpdateFrame(DWORD milliseconds);
+	bool IsRedrawNeeded();
 	void DestroyGame();
 	void init();
 	void shutdown();
@@ -17,4 +18,7 @@ private:
 	static const char8_t mGameTitle[20];
 	static CGame *sInstance;
 	CGame(){};
+
+	bool mFirstFrameDrawn;
+	double mStartTime;
 };
\ No newline at end of file
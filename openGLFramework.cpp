@@ -10,6 +10,13 @@
 #include "baseTypes.h"
 #include "openglframework.h"														// Header File For The NeHeGL Basecode
 #include "game.h"
+#include "Benchmark.h"
+#include "MatchLog.h"
+#include "DesyncCheck.h"
+#include "Replay.h"
+#include "RunAhead.h"
+#include "LatencyMonitor.h"
+#include "FramePacer.h"
 
 #define WM_TOGGLEFULLSCREEN (WM_USER+1)									// Application Define Message For Toggling
 	
@@ -20,6 +27,7 @@
 // Between Fullscreen / Windowed Mode
 static BOOL g_isProgramLooping;											// Window Creation Loop, For FullScreen/Windowed Toggle																		// Between Fullscreen / Windowed Mode
 static BOOL g_createFullScreen;											// If TRUE, Then Create Fullscreen
+static BOOL g_isRedrawRequested;										// If TRUE, Windows Asked For The Window To Be Drawn Again
 
 int	mouse_x, mouse_y;							                        // The Current Position Of The Mouse
 bool8_t mouse_r_button_down,mouse_l_button_down;
@@ -255,6 +263,10 @@ LRESULT CALLBACK WindowProc (HWND hWnd, UINT uMsg, WPARAM wParam, LPARAM lParam)
 		}
 		return 0;														// Return
 
+		case WM_PAINT:													// Window Needs Drawing
+			g_isRedrawRequested = TRUE;									// Draw It With The Next Frame
+		break;															// Let DefWindowProc Validate It
+
 		case WM_CLOSE:													// Closing The Window
 			TerminateApplication(window);								// Terminate The Application
 		return 0;														// Return
@@ -359,6 +371,19 @@ int WINAPI WinMain (HINSTANCE hInstance, HINSTANCE hPrevInstance, LPSTR lpCmdLin
     setvbuf(hf_in, NULL, _IONBF, 128);
     *stdin = *hf_in;
 
+	int benchmarkExitCode;
+
+	if (runBenchmarks(lpCmdLine, &benchmarkExitCode))
+		return benchmarkExitCode;
+
+	if (!loadDesyncCheck(lpCmdLine))
+		return 0;
+
+	requestMatchLogs(lpCmdLine);
+	requestReplays(lpCmdLine);
+	requestRunAhead(lpCmdLine);
+	requestLatencyReport(lpCmdLine);
+	requestFramePacing(lpCmdLine);
 
 
 	Application			application;									// Application Structure
@@ -366,7 +391,8 @@ int WINAPI WinMain (HINSTANCE hInstance, HINSTANCE hPrevInstance, LPSTR lpCmdLin
 	Keys				keys;											// Key Structure
 	BOOL				isMessagePumpActive;							// Message Pump Active?
 	MSG					msg;											// Window Message Structure
-	DWORD				tickCount;										// Used For The Tick Counter
+	bool				isFrameDrawn;									// Was The Frame Drawn?
+	FramePacerC			framePacer;										// Paces Frames To The Target Rate
 	char8_t				title[20];
 	strncpy(title,CGame::GetInstance()->GetGameTitle(),19);
 
@@ -400,6 +426,8 @@ int WINAPI WinMain (HINSTANCE hInstance, HINSTANCE hPrevInstance, LPSTR lpCmdLin
 		return -1;														// Terminate Application
 	}
 
+	framePacer.init(getFrameRate());									// Start Pacing Frames
+
 	g_isProgramLooping = TRUE;											// Program Looping Is Set To TRUE
 	g_createFullScreen = window.init.isFullScreen;						// g_createFullScreen Is Set To User Default
 	while (g_isProgramLooping)											// Loop Until WM_QUIT Is Received
@@ -417,6 +445,8 @@ int WINAPI WinMain (HINSTANCE hInstance, HINSTANCE hPrevInstance, LPSTR lpCmdLin
 			else														// Otherwise (Start The Message Pump)
 			{	// Initialize was a success
 				isMessagePumpActive = TRUE;								// Set isMessagePumpActive To TRUE
+				g_isRedrawRequested = TRUE;								// Draw The First Frame
+				framePacer.restart();									// Time Frames From Now
 				while (isMessagePumpActive == TRUE)						// While The Message Pump Is Active
 				{
 					// Success Creating Window.  Check For Window Messages
@@ -438,14 +468,23 @@ int WINAPI WinMain (HINSTANCE hInstance, HINSTANCE hPrevInstance, LPSTR lpCmdLin
 						{
 							WaitMessage ();								// Application Is Minimized Wait For A Message
 						}
-						else											// If Window Is Visible
+						else if (!framePacer.isFrameDue())				// If The Next Frame Is Not Due Yet
+						{
+							framePacer.waitForFrame();					// Sleep Until It Is Or A Message Arrives
+						}
+						else											// If Window Is Visible And A Frame Is Due
 						{
 							// Process Application Loop
-							tickCount = GetTickCount ();				// Get The Tick Count
-							CGame::GetInstance()->UpdateFrame(tickCount - window.lastTickCount);	// Update The Counter
-							window.lastTickCount = tickCount;			// Set Last Count To Current Count
-							CGame::GetInstance()->DrawScene();			// Draw Our Scene
-							SwapBuffers (window.hDC);					// Swap Buffers (Double Buffering)
+							CGame::GetInstance()->UpdateFrame(framePacer.beginFrame());	// Update With The Time Since The Last Frame
+							isFrameDrawn = g_isRedrawRequested == TRUE || CGame::GetInstance()->IsRedrawNeeded();
+							if (isFrameDrawn)							// Static Menus Are Only Drawn When They Change
+							{
+								CGame::GetInstance()->DrawScene();		// Draw Our Scene
+								SwapBuffers (window.hDC);				// Swap Buffers (Double Buffering)
+								LatencyMonitorC::GetInstance()->framePresented();	// Close The Latency Of Input Shown By This Frame
+								g_isRedrawRequested = FALSE;
+							}
+							framePacer.endFrame(isFrameDrawn);			// Report The Frame Statistics When Due
 						}
 					}
 				}														// Loop While isMessagePumpActive == TRUE
@@ -464,6 +503,7 @@ int WINAPI WinMain (HINSTANCE hInstance, HINSTANCE hPrevInstance, LPSTR lpCmdLin
 		}
 	}																	// While (isProgramLooping)
 
+	framePacer.shutdown();												// Release The Frame Timer
 	UnregisterClass (application.className, application.hInstance);		// UnRegister Window Class
 	return 0;
 }																		// End Of WinMain()
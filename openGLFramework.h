@@ -18,7 +18,7 @@
 *	void Update (DWORD milliseconds);                                            *
 *		Perform Motion Updates                                                   *
 *		'milliseconds' Is The Number Of Milliseconds Passed Since The Last Call  *
-*		With Whatever Accuracy GetTickCount() Provides                           *
+*		Timed By The Performance Counter, Paced By FramePacerC                   *
 *                                                                                *
 *	void DrawScene(void);                                                            *
 *		Perform All Your Scene Drawing                                           *
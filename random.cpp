@@ -1,29 +1,354 @@
-#include <stdlib.h>
+/*
+	random.cpp
+
+	This file contains the implementation for functions prototyped in the RandomC class and the benchmark comparing it with rand().
+*/
 
+#include <stdio.h>
+#include <stdlib.h>
+#include <emmintrin.h>
 #include "random.h"
-float getRangedRandom(float min, float max)
+#include "Benchmark.h"
+
+#define RANDOM_LANES 4
+#define BENCHMARK_RANDOM_VALUES 4096
+#define BENCHMARK_RANDOM_PASSES 4000
+
+static const unsigned int jumpPolynomial[4] = { 0x8764000b, 0xf542d2d3, 0x6fa035c3, 0x77f2db5b };
+static const unsigned int longJumpPolynomial[4] = { 0xb523952e, 0x0b6f099f, 0xccf5a0ef, 0x1c580662 };
+
+static inline unsigned int rotateLeft(unsigned int value, int bits)
+{
+	return (value << bits) | (value >> (32 - bits));
+}
+
+static inline __m128i rotateLeft(__m128i value, int bits)
+{
+	return _mm_or_si128(_mm_slli_epi32(value, bits), _mm_srli_epi32(value, 32 - bits));
+}
+
+/*
+	Steps a generator's state, returning the next number. Shared by the generator and the scalar lanes of bulk generation.
+*/
+static inline unsigned int step(unsigned int *state)
+{
+	unsigned int result = rotateLeft(state[1] * 5, 7) * 9;
+	unsigned int shifted = state[1] << 9;
+
+	state[2] ^= state[0];
+	state[3] ^= state[1];
+	state[1] ^= state[2];
+	state[0] ^= state[3];
+	state[2] ^= shifted;
+	state[3] = rotateLeft(state[3], 11);
+
+	return result;
+}
+
+/*
+	The splitmix64 generator, which spreads the bits of a seed across the state so similar seeds give unrelated sequences.
+*/
+static unsigned long long mixSeed(unsigned long long *seed)
+{
+	unsigned long long mixed = (*seed += 0x9e3779b97f4a7c15ull);
+
+	mixed = (mixed ^ (mixed >> 30)) * 0xbf58476d1ce4e5b9ull;
+	mixed = (mixed ^ (mixed >> 27)) * 0x94d049bb133111ebull;
+
+	return mixed ^ (mixed >> 31);
+}
+
+/* Public functions */
+RandomC::RandomC()
+{
+	seed(0);
+}
+
+RandomC::RandomC(unsigned long long seed)
+{
+	this->seed(seed);
+}
+
+/*
+	Sets the state from the seed. Every seed, including zero, gives a usable state.
+*/
+void RandomC::seed(unsigned long long seed)
+{
+	unsigned long long low = mixSeed(&seed);
+	unsigned long long high = mixSeed(&seed);
+
+	mState[0] = (unsigned int)low;
+	mState[1] = (unsigned int)(low >> 32);
+	mState[2] = (unsigned int)high;
+	mState[3] = (unsigned int)(high >> 32);
+
+	if ((mState[0] | mState[1] | mState[2] | mState[3]) == 0)
+		mState[0] = 1;
+}
+
+unsigned int RandomC::next()
+{
+	return step(mState);
+}
+
+/*
+	Returns a number in [0, 1) from the top 24 bits of the next number, which a float holds exactly.
+*/
+float RandomC::nextFloat()
+{
+	return (next() >> 8) * (1.0f / 16777216.0f);
+}
+
+/*
+	Returns a number in [min, max).
+*/
+float RandomC::getRangedRandom(float min, float max)
+{
+	return min + nextFloat() * (max - min);
+}
+
+/*
+	Returns a whole number in [min, max), scaling the next number by multiplying rather than with a modulo.
+*/
+int RandomC::getRangedRandom(int min, int max)
+{
+	unsigned int range = (unsigned int)(max - min);
+
+	return min + (int)(((unsigned long long)next() * range) >> 32);
+}
+
+/*
+	Advances the generator by 2^64 numbers, as if next() had been called that many times.
+*/
+void RandomC::jump()
+{
+	applyJump(jumpPolynomial);
+}
+
+/*
+	Advances the generator by 2^96 numbers, for splitting streams that are each split again with jump().
+*/
+void RandomC::longJump()
+{
+	applyJump(longJumpPolynomial);
+}
+
+/*
+	Returns a generator that continues this one's sequence and jumps this one ahead, so the two never draw the same numbers.
+	Each simulation run in parallel takes its own split of one seeded generator.
+*/
+RandomC RandomC::split()
+{
+	RandomC stream = *this;
+
+	jump();
+
+	return stream;
+}
+
+/*
+	Fills the array with numbers from four lanes run side by side, each seeded from this generator, interleaved lane by lane.
+	The numbers are the same as fillScalar() gives, and the generator only advances by the eight numbers that seed the lanes.
+*/
+void RandomC::fill(unsigned int *values, int count)
+{
+	unsigned int lanes[4][RANDOM_LANES];
+
+	for (int lane = 0; lane < RANDOM_LANES; lane++)
+	{
+		RandomC laneGenerator;
+		unsigned long long high = next();
+
+		laneGenerator.seed((high << 32) | next());
+
+		for (int word = 0; word < 4; word++)
+			lanes[word][lane] = laneGenerator.mState[word];
+	}
+
+	__m128i state0 = _mm_loadu_si128((const __m128i *)lanes[0]);
+	__m128i state1 = _mm_loadu_si128((const __m128i *)lanes[1]);
+	__m128i state2 = _mm_loadu_si128((const __m128i *)lanes[2]);
+	__m128i state3 = _mm_loadu_si128((const __m128i *)lanes[3]);
+	int i = 0;
+
+	for (; i + RANDOM_LANES <= count; i += RANDOM_LANES)
+	{
+		__m128i timesFive = _mm_add_epi32(_mm_slli_epi32(state1, 2), state1);
+		__m128i rotated = rotateLeft(timesFive, 7);
+		__m128i result = _mm_add_epi32(_mm_slli_epi32(rotated, 3), rotated);
+		__m128i shifted = _mm_slli_epi32(state1, 9);
+
+		state2 = _mm_xor_si128(state2, state0);
+		state3 = _mm_xor_si128(state3, state1);
+		state1 = _mm_xor_si128(state1, state2);
+		state0 = _mm_xor_si128(state0, state3);
+		state2 = _mm_xor_si128(state2, shifted);
+		state3 = rotateLeft(state3, 11);
+
+		_mm_storeu_si128((__m128i *)(values + i), result);
+	}
+
+	_mm_storeu_si128((__m128i *)lanes[0], state0);
+	_mm_storeu_si128((__m128i *)lanes[1], state1);
+	_mm_storeu_si128((__m128i *)lanes[2], state2);
+	_mm_storeu_si128((__m128i *)lanes[3], state3);
+
+	for (int lane = 0; i < count; i++, lane++)
+	{
+		unsigned int laneState[4] = { lanes[0][lane], lanes[1][lane], lanes[2][lane], lanes[3][lane] };
+
+		values[i] = step(laneState);
+	}
+}
+
+/*
+	Fills the array the way fill() does, one lane at a time. The reference fill() is checked against.
+*/
+void RandomC::fillScalar(unsigned int *values, int count)
+{
+	for (int lane = 0; lane < RANDOM_LANES; lane++)
+	{
+		RandomC laneGenerator;
+		unsigned long long high = next();
+
+		laneGenerator.seed((high << 32) | next());
+
+		for (int i = lane; i < count; i += RANDOM_LANES)
+			values[i] = laneGenerator.next();
+	}
+}
+
+/*
+	Fills the array with numbers in [0, 1), converted from the numbers fill() gives the same way nextFloat() converts them.
+*/
+void RandomC::fillFloats(float *values, int count)
 {
-    int r = rand();
+	unsigned int *bits = (unsigned int *)values;
+	const __m128 scale = _mm_set1_ps(1.0f / 16777216.0f);
+	int i = 0;
 
-    float r1 = (float)r/(float)RAND_MAX;
+	fill(bits, count);
 
-    r1 *= (max-min);
+	for (; i + RANDOM_LANES <= count; i += RANDOM_LANES)
+	{
+		__m128i top = _mm_srli_epi32(_mm_loadu_si128((const __m128i *)(bits + i)), 8);
 
-    r1 += min;
+		_mm_storeu_ps(values + i, _mm_mul_ps(_mm_cvtepi32_ps(top), scale));
+	}
 
-    return r1;
+	for (; i < count; i++)
+		values[i] = (bits[i] >> 8) * (1.0f / 16777216.0f);
 }
-int getRangedRandom(int min, int max)
+
+/*
+	Returns the state, to save with the match. Restoring it with setState() continues the same sequence.
+*/
+RandomState RandomC::getState()
 {
-    int r = rand();
+	RandomState state;
+
+	for (int word = 0; word < 4; word++)
+		state.words[word] = mState[word];
+
+	return state;
+}
+
+void RandomC::setState(RandomState state)
+{
+	for (int word = 0; word < 4; word++)
+		mState[word] = state.words[word];
+}
+
+/* Private functions */
+
+/*
+	Advances the state along the given jump polynomial, accumulating the states at the polynomial's set bits.
+*/
+void RandomC::applyJump(const unsigned int *polynomial)
+{
+	unsigned int jumped[4] = { 0, 0, 0, 0 };
+
+	for (int word = 0; word < 4; word++)
+	{
+		for (int bit = 0; bit < 32; bit++)
+		{
+			if (polynomial[word] & (1u << bit))
+			{
+				jumped[0] ^= mState[0];
+				jumped[1] ^= mState[1];
+				jumped[2] ^= mState[2];
+				jumped[3] ^= mState[3];
+			}
+
+			next();
+		}
+	}
+
+	for (int word = 0; word < 4; word++)
+		mState[word] = jumped[word];
+}
+
+/*
+	Times drawing numbers with rand(), one at a time from the generator and in bulk, and checks the bulk numbers against the scalar lanes.
+	Also checks that a generator restored from a saved state and a split stream continue the way they should.
+*/
+void benchmarkRandom()
+{
+	static unsigned int values[BENCHMARK_RANDOM_VALUES];
+	static unsigned int reference[BENCHMARK_RANDOM_VALUES];
+	RandomC generator(2016);
+	unsigned int sum = 0;
+
+	double start = getBenchmarkSeconds();
+
+	for (int pass = 0; pass < BENCHMARK_RANDOM_PASSES; pass++)
+	{
+		for (int i = 0; i < BENCHMARK_RANDOM_VALUES; i++)
+			sum += rand();
+	}
+
+	double randSeconds = getBenchmarkSeconds() - start;
+
+	start = getBenchmarkSeconds();
+
+	for (int pass = 0; pass < BENCHMARK_RANDOM_PASSES; pass++)
+	{
+		for (int i = 0; i < BENCHMARK_RANDOM_VALUES; i++)
+			sum += generator.next();
+	}
+
+	double nextSeconds = getBenchmarkSeconds() - start;
+
+	start = getBenchmarkSeconds();
+
+	for (int pass = 0; pass < BENCHMARK_RANDOM_PASSES; pass++)
+	{
+		generator.fill(values, BENCHMARK_RANDOM_VALUES);
+		sum += values[pass % BENCHMARK_RANDOM_VALUES];
+	}
+
+	double fillSeconds = getBenchmarkSeconds() - start;
+	double count = (double)BENCHMARK_RANDOM_VALUES * BENCHMARK_RANDOM_PASSES;
+	RandomState saved = generator.getState();
+	RandomC copy = generator;
+	int mismatches = 0;
 
-    float r2 = (float)r/(float)RAND_MAX;
+	generator.fill(values, BENCHMARK_RANDOM_VALUES - 3);
+	copy.fillScalar(reference, BENCHMARK_RANDOM_VALUES - 3);
 
-    r2 *= ((float)max-(float)min);
-	int r1 = (int) r2;
+	for (int i = 0; i < BENCHMARK_RANDOM_VALUES - 3; i++)
+	{
+		if (values[i] != reference[i])
+			mismatches++;
+	}
 
-    r1 += min;
+	generator.setState(saved);
+	RandomC stream = generator.split();
 
-    return r1;
+	if (stream.getState().words[0] != saved.words[0] || generator.getState().words[0] == saved.words[0])
+		mismatches++;
 
+	printf("  rand():      %5.2f ns per number\n", randSeconds * 1e9 / count);
+	printf("  next():      %5.2f ns per number\n", nextSeconds * 1e9 / count);
+	printf("  fill():      %5.2f ns per number, %d mismatches against the scalar lanes (checksum %08x)\n", fillSeconds * 1e9 / count, mismatches, sum);
 }
\ No newline at end of file
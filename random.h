@@ -1,2 +1,51 @@
-float getRangedRandom(float min, float max);
-int getRangedRandom(int min, int max);
+#pragma once
+/*
+	random.h
+
+	A small, fast random number generator owned by whoever needs one, such as the match, rather than the process-wide rand().
+	It is xoshiro128**: sixteen bytes of state, seeded explicitly, so a match seeded the same way draws the same numbers
+	and its generator can be saved and restored along with the rest of the match.
+	Jumping advances a generator by 2^64 draws in one step, which splits it into streams that never overlap for parallel simulations.
+	Bulk generation fills whole arrays four numbers at a time with SSE2, for particles and AI that need many at once.
+*/
+
+/*
+	The whole state of a generator, for saving and restoring.
+*/
+struct RandomState
+{
+	unsigned int words[4];
+};
+
+class RandomC
+{
+public:
+	/* Public functions */
+	RandomC();
+	RandomC(unsigned long long seed);
+
+	void seed(unsigned long long seed);
+	unsigned int next();
+	float nextFloat();
+
+	float getRangedRandom(float min, float max);
+	int getRangedRandom(int min, int max);
+
+	void jump();
+	void longJump();
+	RandomC split();
+
+	void fill(unsigned int *values, int count);
+	void fillScalar(unsigned int *values, int count);
+	void fillFloats(float *values, int count);
+
+	RandomState getState();
+	void setState(RandomState state);
+
+private:
+	/* Private functions */
+	void applyJump(const unsigned int *polynomial);
+
+	/* Private data members */
+	unsigned int mState[4];
+};
\ No newline at end of file